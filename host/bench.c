@@ -0,0 +1,1072 @@
+/*
+ * Translator Microbenchmarks
+ *
+ * Times translator_convert, translator_convert_xboxone and
+ * translator_convert_switch over report streams:
+ *
+ *   session   - generated play session: smooth stick sweeps, button
+ *               bursts, trigger ramps, long runs of repeated reports
+ *   idle      - a pad nobody touches: the same report over and over
+ *               (only the Xbox One sequence counter moves)
+ *   random    - uniformly random payloads behind a valid header
+ *   recorded  - report script files or XCAP captures given with -i
+ *               (see report_script.h)
+ *
+ * plus the session stream through tables compiled with swaps and user
+ * remaps, the session and idle streams through the poll thread's
+ * unchanged-report check (+skip), the output clearing the translators
+ * used to do on every report (memset of OrbisPadData, then the float
+ * motion fields) and pad_state_emit, which replaced it, next to the
+ * portable emitter and the batch one (SSE2 when built with it).
+ *
+ * The sharing cases time the poll thread publishing to four controllers
+ * while game threads read them, with the per-controller fields packed
+ * (hook-written words beside words the poll thread rewrites) and split
+ * by writer onto separate cache lines as usb_xbox.c lays them out. They
+ * need a second CPU and are skipped without one.
+ *
+ * Each case is timed over several trials and the fastest is kept.
+ * With -b the results are compared to a baseline file and the run
+ * fails if any case got slower than the threshold allows.
+ *
+ * Usage: bench [-i script]... [-m ms_per_trial] [-n trials]
+ *              [-b baseline] [-w baseline] [-t threshold_pct] [-f filter]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "translator.h"
+#include "report_script.h"
+#include "pad_slot.h"
+#include "pad_history.h"
+#include "poll_sched.h"
+
+#define STREAM_REPORTS      4096
+#define MAX_CASES           40
+#define MAX_RECORDED        8
+#define NAME_LENGTH         48
+#define CASE_NAME_LENGTH    64
+
+// ============================================
+// Report streams
+// ============================================
+
+typedef struct {
+    char            name[NAME_LENGTH];
+    ControllerType  type;
+    int             count;
+    uint8_t         (*reports)[REPORT_SCRIPT_MAX_REPORT];
+} ReportStream;
+
+static uint32_t g_rng = 0x2545F491u;
+
+static uint32_t rng_next(void) {
+    // xorshift32 - streams are identical on every run
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static int stream_alloc(ReportStream* stream, const char* name, ControllerType type, int count) {
+    snprintf(stream->name, sizeof(stream->name), "%s", name);
+    stream->type = type;
+    stream->count = 0;
+    stream->reports = calloc((size_t)count, REPORT_SCRIPT_MAX_REPORT);
+    return stream->reports ? 0 : -1;
+}
+
+static int16_t clamp_axis(int32_t value) {
+    if (value > 32767) return 32767;
+    if (value < -32768) return -32768;
+    return (int16_t)value;
+}
+
+/*
+ * Session input state in the widest units (16-bit sticks, 10-bit triggers)
+ */
+typedef struct {
+    int16_t  lx, ly, rx, ry;
+    uint16_t lt, rt;
+    uint16_t buttons;       // Xbox 360 button word layout
+} SessionState;
+
+static void session_step(SessionState* s, int i) {
+    // Sticks sweep slowly with a little sensor noise; every report repeats
+    // the previous one three times in four, like a pad held still
+    if ((i & 3) == 0) {
+        int32_t phase = (i * 37) & 0xFFFF;
+        int32_t sweep = (phase < 0x8000) ? phase * 2 - 0x8000 : (0xFFFF - phase) * 2 - 0x8000;
+        s->lx = clamp_axis(sweep + (int32_t)(rng_next() % 512) - 256);
+        s->ly = clamp_axis(-sweep / 2 + (int32_t)(rng_next() % 512) - 256);
+        s->rx = clamp_axis((int32_t)(rng_next() % 2048) - 1024);
+        s->ry = clamp_axis(sweep / 3);
+    }
+
+    // Trigger ramps
+    s->lt = (uint16_t)((i % 512) < 256 ? (i % 256) * 4 : 0);
+    s->rt = (uint16_t)((i % 300) < 40 ? 1023 : 0);
+
+    // Button bursts
+    if ((rng_next() & 31) == 0) {
+        s->buttons ^= (uint16_t)(1u << (rng_next() % 16));
+        s->buttons &= (uint16_t)~(XBOX360_UNUSED << 8);
+    }
+}
+
+static int encode_report(ControllerType type, const SessionState* s, uint8_t* out) {
+    memset(out, 0, REPORT_SCRIPT_MAX_REPORT);
+
+    switch (type) {
+        case CONTROLLER_XBOXONE: {
+            XboxOneReport* r = (XboxOneReport*)out;
+            r->report_type = XBOXONE_REPORT_INPUT;
+            r->length = (uint8_t)(sizeof(XboxOneReport) - 4);
+            r->buttons_low = (uint8_t)(s->buttons >> 8);
+            r->buttons_high = (uint8_t)(s->buttons & 0xFF);
+            r->left_trigger = s->lt;
+            r->right_trigger = s->rt;
+            r->left_stick_x = s->lx;
+            r->left_stick_y = s->ly;
+            r->right_stick_x = s->rx;
+            r->right_stick_y = s->ry;
+            return (int)sizeof(XboxOneReport);
+        }
+
+        case CONTROLLER_SWITCH: {
+            SwitchInputOnlyReport* r = (SwitchInputOnlyReport*)out;
+            r->buttons0 = (uint8_t)(s->buttons >> 8);
+            r->buttons1 = (uint8_t)(s->buttons & 0x3F);
+            r->hat = (uint8_t)((s->buttons >> 4) % 9);
+            r->left_stick_x = (uint8_t)((s->lx + 32768) >> 8);
+            r->left_stick_y = (uint8_t)((s->ly + 32768) >> 8);
+            r->right_stick_x = (uint8_t)((s->rx + 32768) >> 8);
+            r->right_stick_y = (uint8_t)((s->ry + 32768) >> 8);
+            return SWITCH_INPUT_ONLY_REPORT_SIZE;
+        }
+
+        default: {
+            Xbox360Report* r = (Xbox360Report*)out;
+            r->msg_type = 0x00;
+            r->msg_length = XBOX360_REPORT_SIZE;
+            r->buttons_low = (uint8_t)(s->buttons & 0xFF);
+            r->buttons_high = (uint8_t)(s->buttons >> 8);
+            r->left_trigger = (uint8_t)(s->lt >> 2);
+            r->right_trigger = (uint8_t)(s->rt >> 2);
+            r->left_stick_x = s->lx;
+            r->left_stick_y = s->ly;
+            r->right_stick_x = s->rx;
+            r->right_stick_y = s->ry;
+            return XBOX360_REPORT_SIZE;
+        }
+    }
+}
+
+static int build_session(ReportStream* stream, ControllerType type, const char* name) {
+    if (stream_alloc(stream, name, type, STREAM_REPORTS) != 0) {
+        return -1;
+    }
+
+    SessionState state;
+    memset(&state, 0, sizeof(state));
+    g_rng = 0x2545F491u;
+
+    for (int i = 0; i < STREAM_REPORTS; i++) {
+        session_step(&state, i);
+        encode_report(type, &state, stream->reports[i]);
+    }
+    stream->count = STREAM_REPORTS;
+    return 0;
+}
+
+static int build_idle(ReportStream* stream, ControllerType type, const char* name) {
+    if (stream_alloc(stream, name, type, STREAM_REPORTS) != 0) {
+        return -1;
+    }
+
+    SessionState state;
+    memset(&state, 0, sizeof(state));
+    for (int i = 0; i < STREAM_REPORTS; i++) {
+        encode_report(type, &state, stream->reports[i]);
+        if (type == CONTROLLER_XBOXONE) {
+            ((XboxOneReport*)stream->reports[i])->counter = (uint8_t)i;
+        }
+    }
+    stream->count = STREAM_REPORTS;
+    return 0;
+}
+
+static int build_random(ReportStream* stream, ControllerType type, const char* name) {
+    if (stream_alloc(stream, name, type, STREAM_REPORTS) != 0) {
+        return -1;
+    }
+
+    g_rng = 0x9E3779B9u;
+    for (int i = 0; i < STREAM_REPORTS; i++) {
+        uint8_t* report = stream->reports[i];
+        for (int b = 0; b < REPORT_SCRIPT_MAX_REPORT; b++) {
+            report[b] = (uint8_t)rng_next();
+        }
+        if (type == CONTROLLER_XBOXONE) {
+            report[0] = XBOXONE_REPORT_INPUT;
+        } else if (type == CONTROLLER_XBOX360) {
+            report[0] = 0x00;
+            report[1] = XBOX360_REPORT_SIZE;
+        }
+    }
+    stream->count = STREAM_REPORTS;
+    return 0;
+}
+
+static int add_recorded_report(void* context, uint32_t delay_us, const uint8_t* data, int length) {
+    (void)delay_us;
+    ReportStream* stream = (ReportStream*)context;
+
+    if (stream->count == 0) {
+        // The first report decides the controller type
+        if (length == SWITCH_INPUT_ONLY_REPORT_SIZE) {
+            stream->type = CONTROLLER_SWITCH;
+        } else if (data[0] == XBOXONE_REPORT_INPUT) {
+            stream->type = CONTROLLER_XBOXONE;
+        } else {
+            stream->type = CONTROLLER_XBOX360;
+        }
+    }
+
+    memset(stream->reports[stream->count], 0, REPORT_SCRIPT_MAX_REPORT);
+    memcpy(stream->reports[stream->count], data, (size_t)length);
+    stream->count++;
+    return stream->count >= STREAM_REPORTS;
+}
+
+static int load_recorded(ReportStream* stream, const char* path) {
+    const char* base = strrchr(path, '/');
+    char name[NAME_LENGTH];
+    snprintf(name, sizeof(name), "recorded:%s", base ? base + 1 : path);
+
+    if (stream_alloc(stream, name, CONTROLLER_NONE, STREAM_REPORTS) != 0) {
+        return -1;
+    }
+    if (report_script_load(path, add_recorded_report, stream) <= 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// ============================================
+// Kernels
+// ============================================
+
+static volatile uint32_t g_sink;
+
+static void run_xbox360(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    OrbisPadData out;
+    uint32_t sink = 0;
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < stream->count; i++) {
+            translator_convert((const Xbox360Report*)stream->reports[i], &out, tables);
+            sink += out.buttons ^ out.leftStick.x;
+        }
+    }
+    g_sink += sink;
+}
+
+static void run_xboxone(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    OrbisPadData out;
+    uint32_t sink = 0;
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < stream->count; i++) {
+            translator_convert_xboxone((const XboxOneReport*)stream->reports[i], &out, tables);
+            sink += out.buttons ^ out.leftStick.x;
+        }
+    }
+    g_sink += sink;
+}
+
+static void run_switch(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    OrbisPadData out;
+    uint32_t sink = 0;
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < stream->count; i++) {
+            translator_convert_switch((const SwitchInputOnlyReport*)stream->reports[i], &out, tables);
+            sink += out.buttons ^ out.leftStick.x;
+        }
+    }
+    g_sink += sink;
+}
+
+// What the translators do to the output before and after the mapping
+static __attribute__((noinline)) void clear_pad(OrbisPadData* ds4) {
+    memset(ds4, 0, sizeof(OrbisPadData));
+}
+
+static __attribute__((noinline)) void clear_pad_motion(OrbisPadData* ds4) {
+    memset(ds4, 0, sizeof(OrbisPadData));
+    ds4->quat.x = 0.0f;
+    ds4->quat.y = 0.0f;
+    ds4->quat.z = 0.0f;
+    ds4->quat.w = 1.0f;
+    ds4->vel.x = 0.0f;
+    ds4->vel.y = 0.0f;
+    ds4->vel.z = 0.0f;
+    ds4->acell.x = 0.0f;
+    ds4->acell.y = 0.0f;
+    ds4->acell.z = 1.0f;
+    ds4->touch.fingers = 0;
+}
+
+static void run_memset(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    (void)tables;
+    OrbisPadData out;
+    uint32_t sink = 0;
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < stream->count; i++) {
+            clear_pad(&out);
+            sink += out.buttons;
+        }
+    }
+    g_sink += sink;
+}
+
+static void run_memset_motion(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    (void)tables;
+    OrbisPadData out;
+    uint32_t sink = 0;
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < stream->count; i++) {
+            clear_pad_motion(&out);
+            sink += out.buttons;
+        }
+    }
+    g_sink += sink;
+}
+
+static void run_emit(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    (void)tables;
+    PadState pad;
+    OrbisPadData out;
+    uint32_t sink = 0;
+
+    memset(&pad, 0, sizeof(pad));
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < stream->count; i++) {
+            pad.buttons = (uint32_t)i;
+            pad_state_emit(&pad, &out);
+            sink += out.buttons;
+        }
+    }
+    g_sink += sink;
+}
+
+static void run_emit_scalar(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    (void)tables;
+    PadState pad;
+    OrbisPadData out;
+    uint32_t sink = 0;
+
+    memset(&pad, 0, sizeof(pad));
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < stream->count; i++) {
+            pad.buttons = (uint32_t)i;
+            pad_state_emit_scalar(&pad, &out);
+            sink += out.buttons;
+        }
+    }
+    g_sink += sink;
+}
+
+#define EMIT_BATCH  16
+
+static void run_emit_batch(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    (void)tables;
+    PadState pads[EMIT_BATCH];
+    OrbisPadData out[EMIT_BATCH];
+    uint32_t sink = 0;
+
+    memset(pads, 0, sizeof(pads));
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < stream->count; i += EMIT_BATCH) {
+            pads[0].buttons = (uint32_t)i;
+            pad_state_emit_batch(pads, out, EMIT_BATCH);
+            sink += out[0].buttons;
+        }
+    }
+    g_sink += sink;
+}
+
+/*
+ * Translate only reports that differ from the previous one, as the poll
+ * thread does; the Xbox One header (sequence counter) is not compared
+ */
+static void run_skip_unchanged(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    OrbisPadData out;
+    uint32_t sink = 0;
+    int length = XBOX360_REPORT_SIZE;
+    int offset = 0;
+
+    if (stream->type == CONTROLLER_XBOXONE) {
+        length = (int)sizeof(XboxOneReport);
+        offset = 4;
+    } else if (stream->type == CONTROLLER_SWITCH) {
+        length = SWITCH_INPUT_ONLY_REPORT_SIZE;
+    }
+
+    for (int p = 0; p < passes; p++) {
+        const uint8_t* last = NULL;
+        for (int i = 0; i < stream->count; i++) {
+            const uint8_t* report = stream->reports[i];
+            if (last == NULL || memcmp(report + offset, last + offset, (size_t)(length - offset)) != 0) {
+                switch (stream->type) {
+                    case CONTROLLER_XBOXONE:
+                        translator_convert_xboxone((const XboxOneReport*)report, &out, tables);
+                        break;
+                    case CONTROLLER_SWITCH:
+                        translator_convert_switch((const SwitchInputOnlyReport*)report, &out, tables);
+                        break;
+                    default:
+                        translator_convert((const Xbox360Report*)report, &out, tables);
+                        break;
+                }
+                last = report;
+            }
+            sink += out.buttons ^ out.leftStick.x;
+        }
+    }
+    g_sink += sink;
+}
+
+// ============================================
+// Cache line sharing
+// ============================================
+
+#define SHARING_CONTROLLERS 4
+#define SHARING_READERS     2
+
+/*
+ * The fields of one controller both sides touch, wherever they live
+ */
+typedef struct {
+    PadSlot*           published;       // Poll thread writes, hooks read
+    volatile uint64_t* head;            // Poll thread writes, hooks read
+    volatile uint64_t* cursor;          // Hooks write
+    volatile uint64_t* last_read_us;    // Hooks write
+    volatile uint32_t* read_count;      // Hooks write
+    volatile uint32_t* rumble_request;  // Hooks write
+    uint32_t*          rumble_sent;     // Poll thread only
+} SharedFields;
+
+// Layout before grouping: everything adjacent, controllers back to back
+typedef struct {
+    PadSlot           published;
+    volatile uint64_t head;
+    volatile uint64_t cursor;
+    volatile uint64_t last_read_us;
+    volatile uint32_t read_count;
+    volatile uint32_t rumble_request;
+    uint32_t          rumble_sent;
+} PackedController;
+
+// InternalController's grouping, with the real line-split types
+typedef struct {
+    volatile uint32_t rumble_request __attribute__((aligned(64)));
+    PollSchedule      schedule;
+    PadSlot           published __attribute__((aligned(64)));
+    PadHistory        history;
+    uint32_t          rumble_sent __attribute__((aligned(64)));
+} SplitController;
+
+static PackedController g_packed[SHARING_CONTROLLERS];
+static SplitController  g_split[SHARING_CONTROLLERS];
+static int              g_sharing_readers = SHARING_READERS;
+static volatile int     g_sharing_running;
+
+/*
+ * A game thread: read every pad, rumble it, as scePadRead and
+ * scePadSetVibration do
+ */
+static void* sharing_reader(void* arg) {
+    const SharedFields* fields = (const SharedFields*)arg;
+    OrbisPadData state;
+    LatencyStamps stamps;
+    uint32_t n = 0;
+
+    while (__atomic_load_n(&g_sharing_running, __ATOMIC_RELAXED)) {
+        for (int c = 0; c < SHARING_CONTROLLERS; c++, n++) {
+            const SharedFields* f = &fields[c];
+            __atomic_store_n(f->last_read_us, n, __ATOMIC_RELAXED);
+            __atomic_fetch_add(f->read_count, 1, __ATOMIC_RELEASE);
+            pad_slot_read_state(f->published, &state, &stamps);
+
+            uint64_t head = __atomic_load_n(f->head, __ATOMIC_ACQUIRE);
+            uint64_t cursor = __atomic_load_n(f->cursor, __ATOMIC_RELAXED);
+            if (cursor < head) {
+                __atomic_compare_exchange_n(f->cursor, &cursor, head, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+            }
+            __atomic_store_n(f->rumble_request, (n >> 6) & 0xFFFF, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * The poll thread side: publish one report per step, round-robin over
+ * the controllers, and pick up rumble requests
+ */
+static void run_sharing(const SharedFields* fields, const ReportStream* stream, int passes) {
+    pthread_t readers[SHARING_READERS];
+    PadSnapshot snapshot;
+    uint32_t sink = 0;
+
+    memset(&snapshot, 0, sizeof(snapshot));
+    g_sharing_running = 1;
+    for (int r = 0; r < g_sharing_readers; r++) {
+        pthread_create(&readers[r], NULL, sharing_reader, (void*)fields);
+    }
+
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < stream->count; i++) {
+            const SharedFields* f = &fields[i & (SHARING_CONTROLLERS - 1)];
+            snapshot.state.buttons = (uint32_t)i;
+            snapshot.update_time = (uint64_t)i + 1;
+            pad_slot_publish(f->published, &snapshot);
+            __atomic_store_n(f->head, *f->head + 1, __ATOMIC_RELEASE);
+
+            uint32_t request = __atomic_load_n(f->rumble_request, __ATOMIC_RELAXED);
+            if (request != *f->rumble_sent) {
+                *f->rumble_sent = request;
+                sink++;
+            }
+        }
+    }
+
+    g_sharing_running = 0;
+    for (int r = 0; r < g_sharing_readers; r++) {
+        pthread_join(readers[r], NULL);
+    }
+    g_sink += sink;
+}
+
+static void run_sharing_packed(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    (void)tables;
+    SharedFields fields[SHARING_CONTROLLERS];
+
+    for (int c = 0; c < SHARING_CONTROLLERS; c++) {
+        PackedController* ctrl = &g_packed[c];
+        fields[c] = (SharedFields){ &ctrl->published, &ctrl->head, &ctrl->cursor, &ctrl->last_read_us,
+                                    &ctrl->read_count, &ctrl->rumble_request, &ctrl->rumble_sent };
+    }
+    run_sharing(fields, stream, passes);
+}
+
+static void run_sharing_split(const ReportStream* stream, const TranslatorTables* tables, int passes) {
+    (void)tables;
+    SharedFields fields[SHARING_CONTROLLERS];
+
+    for (int c = 0; c < SHARING_CONTROLLERS; c++) {
+        SplitController* ctrl = &g_split[c];
+        fields[c] = (SharedFields){ &ctrl->published, &ctrl->history.head, &ctrl->history.cursor,
+                                    &ctrl->schedule.last_read_us, &ctrl->schedule.read_count,
+                                    &ctrl->rumble_request, &ctrl->rumble_sent };
+    }
+    run_sharing(fields, stream, passes);
+}
+
+typedef void (*BenchKernel)(const ReportStream* stream, const TranslatorTables* tables, int passes);
+
+static BenchKernel kernel_for_type(ControllerType type) {
+    switch (type) {
+        case CONTROLLER_XBOXONE: return run_xboxone;
+        case CONTROLLER_SWITCH:  return run_switch;
+        default:                 return run_xbox360;
+    }
+}
+
+// ============================================
+// Checks
+// ============================================
+
+/*
+ * Runtime-built tables with no swaps or rules must equal the
+ * compile-time defaults, or the two remap paths disagree
+ */
+static int check_remap_defaults(void) {
+    static const struct {
+        const char*       name;
+        const RemapTable* table;
+    } defaults[] = {
+        { "360",    &g_remap_xbox360 },
+        { "one",    &g_remap_xboxone },
+        { "switch", &g_remap_switch },
+    };
+    static RemapTable built;
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+        remap_build(&built, defaults[i].table, 0, 0, NULL, 0);
+        if (memcmp(&built, defaults[i].table, sizeof(built)) != 0) {
+            fprintf(stderr, "bench: %s runtime remap table differs from default\n", defaults[i].name);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/*
+ * Axial linear tables must reproduce translator_apply_deadzone, and
+ * the runtime build of the defaults must equal the compile-time ones
+ */
+static int check_axis_defaults(void) {
+    static AxisTable built;
+    AxisConfig config = { .mode = AXIS_DEADZONE_AXIAL, .curve = AXIS_CURVE_LINEAR };
+    int failures = 0;
+
+    // Above 63 the old function wraps below 0 on the negative end
+    for (int deadzone = 0; deadzone <= 63; deadzone++) {
+        config.deadzone = (uint8_t)deadzone;
+        axis_build(&built, NULL, &config, 1, 0);
+        for (int v = 0; v < 256; v++) {
+            if (built.left.x[v] != translator_apply_deadzone((uint8_t)v, (uint8_t)deadzone) ||
+                built.left.y[v] != translator_apply_deadzone((uint8_t)(255 - v), (uint8_t)deadzone)) {
+                fprintf(stderr, "bench: axis table differs at deadzone %d value %d\n", deadzone, v);
+                failures++;
+                break;
+            }
+        }
+    }
+
+    config.deadzone = DEFAULT_STICK_DEADZONE;
+    axis_build(&built, NULL, &config, 1, 1);
+    if (memcmp(&built, &g_axis_default, sizeof(built)) != 0) {
+        fprintf(stderr, "bench: runtime axis table differs from default\n");
+        failures++;
+    }
+    axis_build(&built, NULL, &config, 0, 0);
+    if (memcmp(&built, &g_axis_default_noninverted, sizeof(built)) != 0) {
+        fprintf(stderr, "bench: runtime non-inverted axis table differs from default\n");
+        failures++;
+    }
+    return failures;
+}
+
+/*
+ * The batch emitter must write exactly what the portable one does, for
+ * every stick and trigger value and every batch length
+ */
+static int check_emit_batch(void) {
+    static PadState states[256];
+    static OrbisPadData batch[256];
+    OrbisPadData single;
+    int failures = 0;
+
+    // Edges: every stick high byte, every trigger value in range
+    for (int v = 0; v < 65536; v += 256) {
+        for (int i = 0; i < 256; i++) {
+            states[i].buttons = rng_next();
+            states[i].left_x = (int16_t)(v + i);
+            states[i].left_y = (int16_t)(-v - i);
+            states[i].right_x = (int16_t)(v ^ (i << 4));
+            states[i].right_y = (int16_t)(v + 255 - i);
+            states[i].l2 = (uint16_t)((v >> 6) + (i & 3));
+            states[i].r2 = (uint16_t)(PAD_TRIGGER_MAX - ((v >> 6) + (i & 3)));
+            states[i].timestamp = ((uint64_t)rng_next() << 32) | rng_next();
+        }
+
+        int count = 1 + (v >> 8);
+        memset(batch, 0xA5, sizeof(batch));
+        pad_state_emit_batch(states, batch, count);
+        for (int i = 0; i < 256; i++) {
+            if (i < count) {
+                memset(&single, 0x5A, sizeof(single));
+                pad_state_emit_scalar(&states[i], &single);
+            } else {
+                memset(&single, 0xA5, sizeof(single));   // Past the batch: untouched
+            }
+            if (memcmp(&single, &batch[i], sizeof(single)) != 0) {
+                fprintf(stderr, "bench: batch emitter differs at %d/%d (stick %d)\n", i, count, v);
+                failures++;
+                break;
+            }
+        }
+    }
+
+    // Random states through the single-state entry point
+    for (int n = 0; n < 100000; n++) {
+        PadState state;
+        OrbisPadData emitted;
+        uint32_t r = rng_next();
+        state.buttons = rng_next();
+        state.left_x = (int16_t)r;
+        state.left_y = (int16_t)(r >> 16);
+        r = rng_next();
+        state.right_x = (int16_t)r;
+        state.right_y = (int16_t)(r >> 16);
+        r = rng_next();
+        state.l2 = (uint16_t)(r & PAD_TRIGGER_MAX);
+        state.r2 = (uint16_t)((r >> 16) & PAD_TRIGGER_MAX);
+        state.timestamp = rng_next();
+
+        pad_state_emit(&state, &emitted);
+        pad_state_emit_scalar(&state, &single);
+        if (memcmp(&emitted, &single, sizeof(single)) != 0) {
+            fprintf(stderr, "bench: emitter differs from the portable one\n");
+            failures++;
+            break;
+        }
+    }
+    return failures;
+}
+
+// ============================================
+// Timing
+// ============================================
+
+typedef struct {
+    char                name[CASE_NAME_LENGTH];
+    BenchKernel         kernel;
+    const TranslatorTables* tables;         // NULL = built-in defaults
+    const ReportStream* stream;
+    int                 passes;             // Passes per trial
+    double              ns_per_report;
+    double              cycles_per_report;
+    double              baseline_ns;        // 0 if not in the baseline
+} BenchCase;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t read_cycles(void) {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Pick the number of stream passes that makes one trial last trial_ms
+ */
+static void calibrate_case(BenchCase* bench, uint32_t trial_ms) {
+    uint64_t target = (uint64_t)trial_ms * 1000000ull;
+    int passes = 1;
+
+    for (;;) {
+        uint64_t t0 = now_ns();
+        bench->kernel(bench->stream, bench->tables, passes);
+        uint64_t elapsed = now_ns() - t0;
+        if (elapsed >= target / 4 || passes >= (1 << 24)) {
+            bench->passes = (int)((double)passes * (double)target / (double)(elapsed ? elapsed : 1)) + 1;
+            return;
+        }
+        passes *= 2;
+    }
+}
+
+/*
+ * One timed trial; keeps the fastest seen so far
+ */
+static void run_trial(BenchCase* bench) {
+    uint64_t c0 = read_cycles();
+    uint64_t t0 = now_ns();
+    bench->kernel(bench->stream, bench->tables, bench->passes);
+    uint64_t t1 = now_ns();
+    uint64_t c1 = read_cycles();
+
+    double reports = (double)bench->passes * (double)bench->stream->count;
+    double ns = (double)(t1 - t0) / reports;
+    if (bench->ns_per_report == 0.0 || ns < bench->ns_per_report) {
+        bench->ns_per_report = ns;
+        bench->cycles_per_report = (double)(c1 - c0) / reports;
+    }
+}
+
+// ============================================
+// Baseline
+// ============================================
+
+static int load_baseline(const char* path, BenchCase* cases, int count) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    char name[CASE_NAME_LENGTH];
+    double ns;
+    while (fscanf(file, "%63s %lf", name, &ns) == 2) {
+        for (int i = 0; i < count; i++) {
+            if (strcmp(cases[i].name, name) == 0) {
+                cases[i].baseline_ns = ns;
+            }
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+static int save_baseline(const char* path, const BenchCase* cases, int count) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (cases[i].ns_per_report > 0.0) {
+            fprintf(file, "%s %.3f\n", cases[i].name, cases[i].ns_per_report);
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+// ============================================
+// Main
+// ============================================
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [-i script]... [-m ms_per_trial] [-n trials]\n"
+            "          [-b baseline] [-w baseline] [-t threshold_pct] [-f filter]\n",
+            argv0);
+}
+
+int main(int argc, char* argv[]) {
+    const char* recorded_paths[MAX_RECORDED];
+    int recorded_count = 0;
+    const char* baseline_path = NULL;
+    const char* write_path = NULL;
+    const char* filter = NULL;
+    uint32_t trial_ms = 100;
+    int trials = 5;
+    double threshold = 15.0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:m:n:b:w:t:f:h")) != -1) {
+        switch (opt) {
+            case 'i':
+                if (recorded_count < MAX_RECORDED) recorded_paths[recorded_count++] = optarg;
+                break;
+            case 'm': trial_ms = (uint32_t)atoi(optarg); break;
+            case 'n': trials = atoi(optarg); break;
+            case 'b': baseline_path = optarg; break;
+            case 'w': write_path = optarg; break;
+            case 't': threshold = atof(optarg); break;
+            case 'f': filter = optarg; break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    if (trial_ms == 0 || trials <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    static const struct {
+        ControllerType type;
+        const char*    name;
+    } types[] = {
+        { CONTROLLER_XBOX360, "360" },
+        { CONTROLLER_XBOXONE, "one" },
+        { CONTROLLER_SWITCH,  "switch" },
+    };
+
+    if (check_remap_defaults() != 0 || check_axis_defaults() != 0 || check_emit_batch() != 0) {
+        return 1;
+    }
+
+    // Swapped face buttons plus a user remap, to show remaps are free
+    static const RemapRule rules[] = {
+        { DS4_BUTTON_L1, DS4_BUTTON_L1 | DS4_BUTTON_R1 },
+        { DS4_BUTTON_SHARE, 0 },
+    };
+    static TranslatorTables remapped;
+    TranslatorConfig config;
+    translator_init(&config);
+    config.swap_ab = 1;
+    config.swap_xy = 1;
+    translator_compile(&config, rules, (int)(sizeof(rules) / sizeof(rules[0])), &remapped);
+
+    // Scaled radial deadzone with a curve, the most expensive stick path
+    static TranslatorTables radial;
+    translator_init(&config);
+    config.deadzone_mode = AXIS_DEADZONE_SCALED_RADIAL;
+    config.stick_curve = AXIS_CURVE_EXPONENTIAL;
+    config.curve_exponent = 1.5f;
+    translator_compile(&config, NULL, 0, &radial);
+
+    static ReportStream streams[MAX_CASES];
+    static BenchCase cases[MAX_CASES];
+    int stream_count = 0;
+    int case_count = 0;
+
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        ReportStream* session = &streams[stream_count++];
+        ReportStream* idle = &streams[stream_count++];
+        ReportStream* random = &streams[stream_count++];
+        if (build_session(session, types[t].type, "session") != 0 ||
+            build_idle(idle, types[t].type, "idle") != 0 ||
+            build_random(random, types[t].type, "random") != 0) {
+            fprintf(stderr, "bench: out of memory\n");
+            return 1;
+        }
+
+        const ReportStream* generated[3] = { session, idle, random };
+        for (int s = 0; s < 3; s++) {
+            BenchCase* bench = &cases[case_count++];
+            snprintf(bench->name, sizeof(bench->name), "%s/%s", types[t].name, generated[s]->name);
+            bench->kernel = kernel_for_type(types[t].type);
+            bench->stream = generated[s];
+        }
+
+        BenchCase* bench = &cases[case_count++];
+        snprintf(bench->name, sizeof(bench->name), "%s/session+remap", types[t].name);
+        bench->kernel = kernel_for_type(types[t].type);
+        bench->stream = session;
+        bench->tables = &remapped;
+
+        bench = &cases[case_count++];
+        snprintf(bench->name, sizeof(bench->name), "%s/session+radial", types[t].name);
+        bench->kernel = kernel_for_type(types[t].type);
+        bench->stream = session;
+        bench->tables = &radial;
+
+        const ReportStream* skipped[2] = { session, idle };
+        static const char* skip_names[2] = { "session+skip", "idle+skip" };
+        for (int s = 0; s < 2; s++) {
+            bench = &cases[case_count++];
+            snprintf(bench->name, sizeof(bench->name), "%s/%s", types[t].name, skip_names[s]);
+            bench->kernel = run_skip_unchanged;
+            bench->stream = skipped[s];
+        }
+    }
+
+    for (int r = 0; r < recorded_count; r++) {
+        ReportStream* recorded = &streams[stream_count++];
+        if (load_recorded(recorded, recorded_paths[r]) != 0) {
+            fprintf(stderr, "bench: cannot load %s\n", recorded_paths[r]);
+            return 1;
+        }
+
+        BenchCase* bench = &cases[case_count++];
+        snprintf(bench->name, sizeof(bench->name), "%s/%s",
+                 types[recorded->type - CONTROLLER_XBOX360].name, recorded->name);
+        bench->kernel = kernel_for_type(recorded->type);
+        bench->stream = recorded;
+    }
+
+    // Output clearing alone, on the session stream's report count
+    BenchCase* clear = &cases[case_count++];
+    snprintf(clear->name, sizeof(clear->name), "clear/memset");
+    clear->kernel = run_memset;
+    clear->stream = &streams[0];
+
+    clear = &cases[case_count++];
+    snprintf(clear->name, sizeof(clear->name), "clear/memset+motion");
+    clear->kernel = run_memset_motion;
+    clear->stream = &streams[0];
+
+    clear = &cases[case_count++];
+    snprintf(clear->name, sizeof(clear->name), "clear/emit");
+    clear->kernel = run_emit;
+    clear->stream = &streams[0];
+
+    clear = &cases[case_count++];
+    snprintf(clear->name, sizeof(clear->name), "clear/emit-scalar");
+    clear->kernel = run_emit_scalar;
+    clear->stream = &streams[0];
+
+    clear = &cases[case_count++];
+    snprintf(clear->name, sizeof(clear->name), "clear/emit-batch");
+    clear->kernel = run_emit_batch;
+    clear->stream = &streams[0];
+
+    // One publish per report while game threads read; needs real parallelism
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus >= 2) {
+        g_sharing_readers = (cpus > SHARING_READERS) ? SHARING_READERS : (int)cpus - 1;
+
+        BenchCase* sharing = &cases[case_count++];
+        snprintf(sharing->name, sizeof(sharing->name), "sharing/packed");
+        sharing->kernel = run_sharing_packed;
+        sharing->stream = &streams[0];
+
+        sharing = &cases[case_count++];
+        snprintf(sharing->name, sizeof(sharing->name), "sharing/split");
+        sharing->kernel = run_sharing_split;
+        sharing->stream = &streams[0];
+    } else {
+        fprintf(stderr, "bench: one CPU online, skipping the sharing cases\n");
+    }
+
+    if (baseline_path && load_baseline(baseline_path, cases, case_count) != 0) {
+        fprintf(stderr, "bench: no baseline at %s, comparing nothing\n", baseline_path);
+        baseline_path = NULL;
+    }
+
+    // Trials are interleaved across cases so a burst of noise on the
+    // machine cannot land on every trial of one case
+    for (int i = 0; i < case_count; i++) {
+        if (filter == NULL || strstr(cases[i].name, filter) != NULL) {
+            calibrate_case(&cases[i], trial_ms);
+        }
+    }
+    for (int t = 0; t < trials; t++) {
+        for (int i = 0; i < case_count; i++) {
+            if (cases[i].passes > 0) {
+                run_trial(&cases[i]);
+            }
+        }
+    }
+
+    printf("%-32s %10s %10s %12s %10s\n", "case", "ns/report", "cyc/report", "Mreports/s", "vs base");
+
+    int regressions = 0;
+    for (int i = 0; i < case_count; i++) {
+        BenchCase* bench = &cases[i];
+        if (bench->passes == 0) {
+            continue;
+        }
+
+        printf("%-32s %10.2f %10.1f %12.1f", bench->name, bench->ns_per_report,
+               bench->cycles_per_report, 1000.0 / bench->ns_per_report);
+
+        if (bench->baseline_ns > 0.0) {
+            double delta = (bench->ns_per_report / bench->baseline_ns - 1.0) * 100.0;
+            int regressed = delta > threshold;
+            regressions += regressed;
+            printf(" %+9.1f%%%s", delta, regressed ? "  REGRESSION" : "");
+        }
+        printf("\n");
+    }
+
+    if (write_path) {
+        if (save_baseline(write_path, cases, case_count) != 0) {
+            fprintf(stderr, "bench: cannot write %s\n", write_path);
+            return 1;
+        }
+        printf("baseline written to %s\n", write_path);
+    }
+
+    if (regressions) {
+        printf("%d case(s) slower than baseline by more than %.1f%%\n", regressions, threshold);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * Capture File Reader Implementation
+ */
+
+#include "capture_file.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int capture_file_detect(const char* path) {
+    char magic[4];
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    int match = fread(magic, sizeof(magic), 1, file) == 1 &&
+                memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+    return match;
+}
+
+int capture_file_load(const char* path, CaptureFileCallback callback, void* context) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+
+    CaptureFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CAPTURE_VERSION || header.header_size < sizeof(header)) {
+        fclose(file);
+        return -2;
+    }
+    fseek(file, header.header_size, SEEK_SET);
+
+    // A capture cut off mid-record (plugin killed) ends at the last whole one
+    CaptureRecord record;
+    uint8_t data[256];
+    uint64_t time_us = 0;
+    int count = 0;
+    while (fread(&record, sizeof(record), 1, file) == 1 &&
+           fread(data, 1, record.length, file) == record.length) {
+        time_us += record.delta_us;
+        count++;
+        if (callback(context, &record, time_us, data) != 0) {
+            break;
+        }
+    }
+
+    fclose(file);
+    return count;
+}
@@ -0,0 +1,32 @@
+/*
+ * Capture File Reader
+ * Reads XCAP files written by the plugin's report capture (capture.h).
+ */
+
+#ifndef CAPTURE_FILE_H
+#define CAPTURE_FILE_H
+
+#include "capture.h"
+#include <stdint.h>
+
+/*
+ * Called for every record in the file
+ * @param time_us   Record time since the capture started
+ * @return 0 to continue, nonzero to stop reading
+ */
+typedef int (*CaptureFileCallback)(void* context, const CaptureRecord* record, uint64_t time_us,
+                                   const uint8_t* data);
+
+/*
+ * Check whether a file starts with the XCAP magic
+ */
+int capture_file_detect(const char* path);
+
+/*
+ * Read a capture file
+ * @return Number of records passed to the callback, -1 if the file
+ *         cannot be opened, -2 if it is not a capture of a known version
+ */
+int capture_file_load(const char* path, CaptureFileCallback callback, void* context);
+
+#endif // CAPTURE_FILE_H
@@ -0,0 +1,37 @@
+/*
+ * Host stand-in for the GoldHEN SDK Detour API
+ * HOOK_CONTINUE resolves straight to the mocked system function.
+ */
+
+#ifndef HOST_DETOUR_H
+#define HOST_DETOUR_H
+
+#include <stdint.h>
+
+typedef enum {
+    DetourMode_x64 = 0,
+    DetourMode_x32 = 1
+} DetourMode;
+
+typedef struct {
+    DetourMode Mode;
+    uint64_t   FunctionPtr;
+    void*      HookPtr;
+    void*      StubPtr;
+} Detour;
+
+void Detour_Construct(Detour* detour, DetourMode mode);
+void Detour_Destroy(Detour* detour);
+void* Detour_DetourFunction(Detour* detour, uint64_t function_ptr, void* hook, int save_bytes);
+
+#define HOOK_INIT(function) Detour Detour_##function
+#define HOOK(function) \
+    Detour_Construct(&Detour_##function, DetourMode_x64); \
+    Detour_DetourFunction(&Detour_##function, (uint64_t)function, (void*)function##_hook, 1)
+#define HOOK32(function) \
+    Detour_Construct(&Detour_##function, DetourMode_x32); \
+    Detour_DetourFunction(&Detour_##function, (uint64_t)function, (void*)function##_hook, 1)
+#define UNHOOK(function) Detour_Destroy(&Detour_##function)
+#define HOOK_CONTINUE(function, type, ...) ((type)Detour_##function.StubPtr)(__VA_ARGS__)
+
+#endif // HOST_DETOUR_H
@@ -0,0 +1,28 @@
+/*
+ * Host stand-in for the GoldHEN plugin SDK umbrella header
+ */
+
+#ifndef HOST_GOLDHEN_H
+#define HOST_GOLDHEN_H
+
+#include <stdint.h>
+#include "Detour.h"
+#include "Patcher.h"
+#include "Utilities.h"
+
+/*
+ * Running process, as reported by the GoldHEN SDK
+ */
+struct proc_info {
+    int      pid;
+    char     name[32];
+    char     path[64];
+    char     titleid[16];
+    char     contentid[64];
+    char     version[8];
+    uint64_t base_address;
+};
+
+int32_t sys_sdk_proc_info(struct proc_info* info);
+
+#endif // HOST_GOLDHEN_H
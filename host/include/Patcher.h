@@ -0,0 +1,20 @@
+/*
+ * Host stand-in for the GoldHEN SDK Patcher API
+ */
+
+#ifndef HOST_PATCHER_H
+#define HOST_PATCHER_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t address;
+    uint8_t  original[64];
+    uint32_t length;
+} Patcher;
+
+void Patcher_Construct(Patcher* patcher);
+void Patcher_Destroy(Patcher* patcher);
+void Patcher_Install_Patch(Patcher* patcher, uint64_t address, const void* data, uint32_t length);
+
+#endif // HOST_PATCHER_H
@@ -0,0 +1,10 @@
+/*
+ * Host stand-in for the GoldHEN SDK Utilities header
+ */
+
+#ifndef HOST_UTILITIES_H
+#define HOST_UTILITIES_H
+
+#include <stdint.h>
+
+#endif // HOST_UTILITIES_H
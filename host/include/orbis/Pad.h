@@ -0,0 +1,19 @@
+/*
+ * Host stand-in for OpenOrbis orbis/Pad.h
+ */
+
+#ifndef HOST_ORBIS_PAD_H
+#define HOST_ORBIS_PAD_H
+
+#include <stdint.h>
+#include "_types/pad.h"
+
+int32_t scePadInit(void);
+int32_t scePadOpen(int32_t userId, int32_t type, int32_t index, void* param);
+int32_t scePadClose(int32_t handle);
+int32_t scePadRead(int32_t handle, OrbisPadData* data, int32_t num);
+int32_t scePadReadState(int32_t handle, OrbisPadData* data);
+int32_t scePadGetControllerInformation(int32_t handle, OrbisPadInformation* info);
+int32_t scePadSetVibration(int32_t handle, const OrbisPadVibeParam* param);
+
+#endif // HOST_ORBIS_PAD_H
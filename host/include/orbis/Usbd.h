@@ -0,0 +1,174 @@
+/*
+ * Host stand-in for OpenOrbis orbis/Usbd.h
+ * sceUsbd is a thin wrapper around libusb-1.0; the types below
+ * follow the libusb layout for the fields the plugin touches.
+ */
+
+#ifndef HOST_ORBIS_USBD_H
+#define HOST_ORBIS_USBD_H
+
+#include <stdint.h>
+#include <sys/time.h>
+
+typedef struct libusb_device libusb_device;
+typedef struct libusb_device_handle libusb_device_handle;
+
+struct libusb_device_descriptor {
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t bcdUSB;
+    uint8_t  bDeviceClass;
+    uint8_t  bDeviceSubClass;
+    uint8_t  bDeviceProtocol;
+    uint8_t  bMaxPacketSize0;
+    uint16_t idVendor;
+    uint16_t idProduct;
+    uint16_t bcdDevice;
+    uint8_t  iManufacturer;
+    uint8_t  iProduct;
+    uint8_t  iSerialNumber;
+    uint8_t  bNumConfigurations;
+};
+
+struct libusb_endpoint_descriptor {
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bEndpointAddress;
+    uint8_t  bmAttributes;
+    uint16_t wMaxPacketSize;
+    uint8_t  bInterval;
+    uint8_t  bRefresh;
+    uint8_t  bSynchAddress;
+    const unsigned char* extra;
+    int      extra_length;
+};
+
+struct libusb_interface_descriptor {
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bInterfaceNumber;
+    uint8_t  bAlternateSetting;
+    uint8_t  bNumEndpoints;
+    uint8_t  bInterfaceClass;
+    uint8_t  bInterfaceSubClass;
+    uint8_t  bInterfaceProtocol;
+    uint8_t  iInterface;
+    const struct libusb_endpoint_descriptor* endpoint;
+    const unsigned char* extra;
+    int      extra_length;
+};
+
+struct libusb_interface {
+    const struct libusb_interface_descriptor* altsetting;
+    int      num_altsetting;
+};
+
+struct libusb_config_descriptor {
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t wTotalLength;
+    uint8_t  bNumInterfaces;
+    uint8_t  bConfigurationValue;
+    uint8_t  iConfiguration;
+    uint8_t  bmAttributes;
+    uint8_t  MaxPower;
+    const struct libusb_interface* interface;
+    const unsigned char* extra;
+    int      extra_length;
+};
+
+enum libusb_error {
+    LIBUSB_SUCCESS = 0,
+    LIBUSB_ERROR_IO = -1,
+    LIBUSB_ERROR_INVALID_PARAM = -2,
+    LIBUSB_ERROR_ACCESS = -3,
+    LIBUSB_ERROR_NO_DEVICE = -4,
+    LIBUSB_ERROR_NOT_FOUND = -5,
+    LIBUSB_ERROR_BUSY = -6,
+    LIBUSB_ERROR_TIMEOUT = -7,
+    LIBUSB_ERROR_OVERFLOW = -8,
+    LIBUSB_ERROR_PIPE = -9,
+    LIBUSB_ERROR_INTERRUPTED = -10,
+    LIBUSB_ERROR_NO_MEM = -11,
+    LIBUSB_ERROR_NOT_SUPPORTED = -12,
+    LIBUSB_ERROR_OTHER = -99
+};
+
+enum libusb_transfer_status {
+    LIBUSB_TRANSFER_COMPLETED = 0,
+    LIBUSB_TRANSFER_ERROR,
+    LIBUSB_TRANSFER_TIMED_OUT,
+    LIBUSB_TRANSFER_CANCELLED,
+    LIBUSB_TRANSFER_STALL,
+    LIBUSB_TRANSFER_NO_DEVICE,
+    LIBUSB_TRANSFER_OVERFLOW
+};
+
+enum libusb_transfer_type {
+    LIBUSB_TRANSFER_TYPE_CONTROL = 0,
+    LIBUSB_TRANSFER_TYPE_ISOCHRONOUS = 1,
+    LIBUSB_TRANSFER_TYPE_BULK = 2,
+    LIBUSB_TRANSFER_TYPE_INTERRUPT = 3
+};
+
+struct libusb_iso_packet_descriptor {
+    unsigned int length;
+    unsigned int actual_length;
+    enum libusb_transfer_status status;
+};
+
+struct libusb_transfer;
+typedef void (*libusb_transfer_cb_fn)(struct libusb_transfer* transfer);
+
+struct libusb_transfer {
+    libusb_device_handle* dev_handle;
+    uint8_t  flags;
+    unsigned char endpoint;
+    unsigned char type;
+    unsigned int timeout;
+    enum libusb_transfer_status status;
+    int      length;
+    int      actual_length;
+    libusb_transfer_cb_fn callback;
+    void*    user_data;
+    unsigned char* buffer;
+    int      num_iso_packets;
+    struct libusb_iso_packet_descriptor iso_packet_desc[];
+};
+
+int32_t sceUsbdInit(void);
+void    sceUsbdExit(void);
+int32_t sceUsbdGetDeviceList(libusb_device*** list);
+void    sceUsbdFreeDeviceList(libusb_device** list);
+int32_t sceUsbdGetDeviceDescriptor(libusb_device* device, struct libusb_device_descriptor* desc);
+int32_t sceUsbdGetActiveConfigDescriptor(libusb_device* device, struct libusb_config_descriptor** config);
+void    sceUsbdFreeConfigDescriptor(struct libusb_config_descriptor* config);
+uint8_t sceUsbdGetBusNumber(libusb_device* device);
+uint8_t sceUsbdGetDeviceAddress(libusb_device* device);
+libusb_device* sceUsbdRefDevice(libusb_device* device);
+void    sceUsbdUnrefDevice(libusb_device* device);
+libusb_device* sceUsbdGetDevice(libusb_device_handle* handle);
+int32_t sceUsbdOpen(libusb_device* device, libusb_device_handle** handle);
+void    sceUsbdClose(libusb_device_handle* handle);
+int32_t sceUsbdClaimInterface(libusb_device_handle* handle, int32_t interface_number);
+int32_t sceUsbdReleaseInterface(libusb_device_handle* handle, int32_t interface_number);
+int32_t sceUsbdDetachKernelDriver(libusb_device_handle* handle, int32_t interface_number);
+int32_t sceUsbdSetInterfaceAltSetting(libusb_device_handle* handle, int32_t interface_number, int32_t alternate_setting);
+int32_t sceUsbdCheckConnected(libusb_device_handle* handle);
+int32_t sceUsbdInterruptTransfer(libusb_device_handle* handle, unsigned char endpoint,
+                                 unsigned char* data, int32_t length, int32_t* transferred,
+                                 uint32_t timeout);
+
+// Asynchronous transfers; callbacks run inside sceUsbdHandleEvents*
+struct libusb_transfer* sceUsbdAllocTransfer(int32_t iso_packets);
+void    sceUsbdFreeTransfer(struct libusb_transfer* transfer);
+void    sceUsbdFillInterruptTransfer(struct libusb_transfer* transfer, libusb_device_handle* handle,
+                                     unsigned char endpoint, unsigned char* buffer, int32_t length,
+                                     libusb_transfer_cb_fn callback, void* user_data,
+                                     uint32_t timeout);
+int32_t sceUsbdSubmitTransfer(struct libusb_transfer* transfer);
+int32_t sceUsbdCancelTransfer(struct libusb_transfer* transfer);
+int32_t sceUsbdHandleEvents(void);
+int32_t sceUsbdHandleEventsTimeout(struct timeval* tv);
+
+#endif // HOST_ORBIS_USBD_H
@@ -0,0 +1,32 @@
+/*
+ * Host stand-in for OpenOrbis orbis/UserService.h
+ */
+
+#ifndef HOST_ORBIS_USERSERVICE_H
+#define HOST_ORBIS_USERSERVICE_H
+
+#include <stdint.h>
+
+#define ORBIS_USER_SERVICE_MAX_LOGIN_USERS  4
+#define ORBIS_USER_SERVICE_USER_ID_INVALID  -1
+
+typedef struct OrbisUserServiceLoginUserIdList {
+    int32_t userId[ORBIS_USER_SERVICE_MAX_LOGIN_USERS];
+} OrbisUserServiceLoginUserIdList;
+
+typedef enum OrbisUserServiceEventType {
+    ORBIS_USER_SERVICE_EVENT_TYPE_LOGIN = 0,
+    ORBIS_USER_SERVICE_EVENT_TYPE_LOGOUT = 1,
+} OrbisUserServiceEventType;
+
+typedef struct OrbisUserServiceEvent {
+    OrbisUserServiceEventType eventType;
+    int32_t userId;
+} OrbisUserServiceEvent;
+
+int32_t sceUserServiceInitialize(void* params);
+int32_t sceUserServiceGetForegroundUser(int32_t* userId);
+int32_t sceUserServiceGetLoginUserIdList(OrbisUserServiceLoginUserIdList* userIdList);
+int32_t sceUserServiceGetEvent(OrbisUserServiceEvent* event);
+
+#endif // HOST_ORBIS_USERSERVICE_H
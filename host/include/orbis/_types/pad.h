@@ -0,0 +1,108 @@
+/*
+ * Host stand-in for OpenOrbis orbis/_types/pad.h
+ * Layout mirrors the OpenOrbis toolchain definitions
+ */
+
+#ifndef HOST_ORBIS_TYPES_PAD_H
+#define HOST_ORBIS_TYPES_PAD_H
+
+#include <stdint.h>
+
+typedef enum OrbisPadButton {
+    ORBIS_PAD_BUTTON_L3         = 0x0002,
+    ORBIS_PAD_BUTTON_R3         = 0x0004,
+    ORBIS_PAD_BUTTON_OPTIONS    = 0x0008,
+    ORBIS_PAD_BUTTON_UP         = 0x0010,
+    ORBIS_PAD_BUTTON_RIGHT      = 0x0020,
+    ORBIS_PAD_BUTTON_DOWN       = 0x0040,
+    ORBIS_PAD_BUTTON_LEFT       = 0x0080,
+    ORBIS_PAD_BUTTON_L2         = 0x0100,
+    ORBIS_PAD_BUTTON_R2         = 0x0200,
+    ORBIS_PAD_BUTTON_L1         = 0x0400,
+    ORBIS_PAD_BUTTON_R1         = 0x0800,
+    ORBIS_PAD_BUTTON_TRIANGLE   = 0x1000,
+    ORBIS_PAD_BUTTON_CIRCLE     = 0x2000,
+    ORBIS_PAD_BUTTON_CROSS      = 0x4000,
+    ORBIS_PAD_BUTTON_SQUARE     = 0x8000,
+    ORBIS_PAD_BUTTON_TOUCH_PAD  = 0x100000,
+    ORBIS_PAD_BUTTON_INTERCEPTED = 0x80000000
+} OrbisPadButton;
+
+#define ORBIS_PAD_CONNECTION_TYPE_STANDARD  0
+#define ORBIS_PAD_CONNECTION_TYPE_REMOTE    2
+
+#define ORBIS_PAD_DEVICE_CLASS_INVALID      -1
+#define ORBIS_PAD_DEVICE_CLASS_PAD          0
+
+typedef struct {
+    uint8_t x;
+    uint8_t y;
+} stick;
+
+typedef struct {
+    uint8_t l2;
+    uint8_t r2;
+} analog;
+
+typedef struct {
+    float x;
+    float y;
+    float z;
+    float w;
+} vec_float4;
+
+typedef struct {
+    float x;
+    float y;
+    float z;
+} vec_float3;
+
+typedef struct OrbisPadTouch {
+    uint16_t x;
+    uint16_t y;
+    uint8_t  finger;
+    uint8_t  pad[3];
+} OrbisPadTouch;
+
+typedef struct OrbisPadTouchData {
+    uint8_t       fingers;
+    uint8_t       padding[3];
+    OrbisPadTouch touch[2];
+} OrbisPadTouchData;
+
+typedef struct OrbisPadData {
+    unsigned int      buttons;
+    stick             leftStick;
+    stick             rightStick;
+    analog            analogButtons;
+    uint16_t          padding;
+    vec_float4        quat;
+    vec_float3        vel;
+    vec_float3        acell;
+    OrbisPadTouchData touch;
+    uint8_t           connected;
+    uint64_t          timestamp;
+    uint8_t           ext[16];
+    uint8_t           count;
+    uint8_t           unknown[15];
+} OrbisPadData;
+
+typedef struct OrbisPadInformation {
+    float    touchpadDensity;
+    uint16_t touchResolutionX;
+    uint16_t touchResolutionY;
+    uint8_t  stickDeadzoneL;
+    uint8_t  stickDeadzoneR;
+    uint8_t  connectionType;
+    uint8_t  count;
+    int32_t  connected;
+    int32_t  deviceClass;
+    uint8_t  unknown[8];
+} OrbisPadInformation;
+
+typedef struct OrbisPadVibeParam {
+    uint8_t lgMotor;
+    uint8_t smMotor;
+} OrbisPadVibeParam;
+
+#endif // HOST_ORBIS_TYPES_PAD_H
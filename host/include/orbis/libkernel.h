@@ -0,0 +1,56 @@
+/*
+ * Host stand-in for OpenOrbis orbis/libkernel.h
+ * Only the calls used by the plugin are declared
+ */
+
+#ifndef HOST_ORBIS_LIBKERNEL_H
+#define HOST_ORBIS_LIBKERNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/stat.h>
+
+typedef enum OrbisNotificationRequestType {
+    NotificationRequest = 0,
+    SystemNotification = 1,
+    SystemNotificationWithUserId = 2,
+    SystemNotificationWithDeviceId = 3,
+    SystemNotificationWithDeviceIdRelatedToUser = 4,
+    SystemNotificationWithText = 5,
+    SystemNotificationWithTextRelatedToUser = 6,
+    SystemNotificationWithErrorCode = 7,
+    SystemNotificationWithAppId = 8,
+    SystemNotificationWithAppName = 9,
+    SystemNotificationWithAppInfo = 9,
+    SystemNotificationWithAppNameRelatedToUser = 10,
+    NotificationWithDeviceId = 11,
+} OrbisNotificationRequestType;
+
+typedef struct OrbisNotificationRequest {
+    OrbisNotificationRequestType type;
+    int reqId;
+    int priority;
+    int msgId;
+    int targetId;
+    int userId;
+    int unk1;
+    int unk2;
+    int appId;
+    int errorNum;
+    int unk3;
+    unsigned char useIconImageUri;
+    char message[1024];
+    char iconUri[1024];
+    char unk[1024];
+} OrbisNotificationRequest;
+
+typedef struct stat OrbisKernelStat;
+
+int sceKernelSendNotificationRequest(int device, OrbisNotificationRequest* req, size_t size, int blocking);
+uint64_t sceKernelGetProcessTime(void);
+int sceKernelUsleep(unsigned int microseconds);
+uint64_t sceKernelReadTsc(void);
+uint64_t sceKernelGetTscFrequency(void);
+int sceKernelStat(const char* path, OrbisKernelStat* sb);
+
+#endif // HOST_ORBIS_LIBKERNEL_H
@@ -0,0 +1,1005 @@
+/*
+ * Host Mock of the PS4 System Libraries
+ *
+ * Stand-in implementation of the sceUsbd, scePad, sceUserService and
+ * sceKernel calls the plugin makes, plus the GoldHEN Detour/Patcher
+ * entry points, so the plugin sources build and run on Linux.
+ */
+
+#include "mock_sce.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <orbis/libkernel.h>
+#include <orbis/Pad.h>
+#include <orbis/Usbd.h>
+#include <orbis/UserService.h>
+
+#include <GoldHEN.h>
+
+#define MOCK_MAX_DEVICES    16
+#define MOCK_REPORT_MAX     64
+#define MOCK_NOTIFY_COST_US 2000    // Typical sceKernelSendNotificationRequest round trip
+
+// ============================================
+// Kernel
+// ============================================
+
+static int g_verbose = 0;
+
+void mock_set_verbose(int verbose) {
+    g_verbose = verbose;
+}
+
+uint64_t sceKernelGetProcessTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000ull;
+}
+
+// The host "TSC" is the monotonic clock in nanoseconds
+uint64_t sceKernelReadTsc(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t sceKernelGetTscFrequency(void) {
+    return 1000000000ull;
+}
+
+// Sleep until an absolute sceKernelGetProcessTime() value
+static void sleep_until_us(uint64_t when) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(when / 1000000ull);
+    ts.tv_nsec = (long)(when % 1000000ull) * 1000L;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+int sceKernelUsleep(unsigned int microseconds) {
+    sleep_until_us(sceKernelGetProcessTime() + microseconds);
+    return 0;
+}
+
+int sceKernelStat(const char* path, OrbisKernelStat* sb) {
+    return stat(path, sb);
+}
+
+int sceKernelSendNotificationRequest(int device, OrbisNotificationRequest* req, size_t size, int blocking) {
+    (void)device;
+    (void)size;
+    (void)blocking;
+    if (g_verbose) {
+        fprintf(stderr, "[notify] %s\n", req->message);
+    }
+    // The real call is IPC to the shell: whoever calls it waits
+    sceKernelUsleep(MOCK_NOTIFY_COST_US);
+    return 0;
+}
+
+const char* sceKernelGetFsSandboxRandomWord(void) {
+    return "host";
+}
+
+int sys_dynlib_load_prx(const char* path, int* handle) {
+    (void)path;
+    *handle = 1;
+    return 0;
+}
+
+// ============================================
+// GoldHEN Detour / Patcher
+// ============================================
+
+void Detour_Construct(Detour* detour, DetourMode mode) {
+    memset(detour, 0, sizeof(*detour));
+    detour->Mode = mode;
+}
+
+void Detour_Destroy(Detour* detour) {
+    detour->StubPtr = NULL;
+}
+
+// HOOK_CONTINUE calls straight through to the mocked function
+void* Detour_DetourFunction(Detour* detour, uint64_t function_ptr, void* hook, int save_bytes) {
+    (void)save_bytes;
+    detour->FunctionPtr = function_ptr;
+    detour->HookPtr = hook;
+    detour->StubPtr = (void*)function_ptr;
+    return detour->StubPtr;
+}
+
+void Patcher_Construct(Patcher* patcher) {
+    memset(patcher, 0, sizeof(*patcher));
+}
+
+void Patcher_Destroy(Patcher* patcher) {
+    (void)patcher;
+}
+
+void Patcher_Install_Patch(Patcher* patcher, uint64_t address, const void* data, uint32_t length) {
+    (void)data;
+    patcher->address = address;
+    patcher->length = length;
+}
+
+static char g_title_id[16] = "CUSA00000";
+
+void mock_set_title_id(const char* title_id) {
+    strncpy(g_title_id, title_id, sizeof(g_title_id) - 1);
+}
+
+int32_t sys_sdk_proc_info(struct proc_info* info) {
+    memset(info, 0, sizeof(*info));
+    info->pid = 1;
+    strncpy(info->name, "eboot.bin", sizeof(info->name) - 1);
+    memcpy(info->titleid, g_title_id, sizeof(info->titleid));
+    return 0;
+}
+
+// ============================================
+// User Service
+// ============================================
+
+#define MOCK_USER_EVENTS                16
+#define MOCK_USER_NO_EVENT              0x80960007  // SCE_USER_SERVICE_ERROR_NO_EVENT
+
+static int32_t g_logins[ORBIS_USER_SERVICE_MAX_LOGIN_USERS];
+static int     g_login_count = 0;
+static int32_t g_foreground = 0;
+static OrbisUserServiceEvent g_user_events[MOCK_USER_EVENTS];
+static int     g_user_event_head = 0;
+static int     g_user_event_count = 0;
+static pthread_mutex_t g_user_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void push_user_event(OrbisUserServiceEventType type, int32_t user_id) {
+    if (g_user_event_count == MOCK_USER_EVENTS) {
+        return;
+    }
+    OrbisUserServiceEvent* event = &g_user_events[(g_user_event_head + g_user_event_count) % MOCK_USER_EVENTS];
+    event->eventType = type;
+    event->userId = user_id;
+    g_user_event_count++;
+}
+
+void mock_user_set_logins(const int32_t* user_ids, int count) {
+    if (count > ORBIS_USER_SERVICE_MAX_LOGIN_USERS) {
+        count = ORBIS_USER_SERVICE_MAX_LOGIN_USERS;
+    }
+    pthread_mutex_lock(&g_user_lock);
+    memcpy(g_logins, user_ids, sizeof(int32_t) * (size_t)count);
+    g_login_count = count;
+    g_foreground = (count > 0) ? user_ids[0] : 0;
+    pthread_mutex_unlock(&g_user_lock);
+}
+
+void mock_user_login(int32_t user_id) {
+    pthread_mutex_lock(&g_user_lock);
+    if (g_login_count < ORBIS_USER_SERVICE_MAX_LOGIN_USERS) {
+        g_logins[g_login_count++] = user_id;
+        if (g_foreground == 0) {
+            g_foreground = user_id;
+        }
+        push_user_event(ORBIS_USER_SERVICE_EVENT_TYPE_LOGIN, user_id);
+    }
+    pthread_mutex_unlock(&g_user_lock);
+}
+
+void mock_user_logout(int32_t user_id) {
+    pthread_mutex_lock(&g_user_lock);
+    for (int i = 0; i < g_login_count; i++) {
+        if (g_logins[i] == user_id) {
+            memmove(&g_logins[i], &g_logins[i + 1], sizeof(int32_t) * (size_t)(g_login_count - i - 1));
+            g_login_count--;
+            if (g_foreground == user_id) {
+                g_foreground = (g_login_count > 0) ? g_logins[0] : 0;
+            }
+            push_user_event(ORBIS_USER_SERVICE_EVENT_TYPE_LOGOUT, user_id);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_user_lock);
+}
+
+void mock_user_set_foreground(int32_t user_id) {
+    pthread_mutex_lock(&g_user_lock);
+    g_foreground = user_id;
+    pthread_mutex_unlock(&g_user_lock);
+}
+
+int32_t sceUserServiceInitialize(void* params) {
+    (void)params;
+    return 0;
+}
+
+int32_t sceUserServiceGetForegroundUser(int32_t* userId) {
+    pthread_mutex_lock(&g_user_lock);
+    int32_t foreground = g_foreground;
+    pthread_mutex_unlock(&g_user_lock);
+
+    if (foreground == 0) {
+        return -1;
+    }
+    *userId = foreground;
+    return 0;
+}
+
+int32_t sceUserServiceGetLoginUserIdList(OrbisUserServiceLoginUserIdList* userIdList) {
+    pthread_mutex_lock(&g_user_lock);
+    for (int i = 0; i < ORBIS_USER_SERVICE_MAX_LOGIN_USERS; i++) {
+        userIdList->userId[i] = (i < g_login_count) ? g_logins[i] : ORBIS_USER_SERVICE_USER_ID_INVALID;
+    }
+    pthread_mutex_unlock(&g_user_lock);
+    return 0;
+}
+
+int32_t sceUserServiceGetEvent(OrbisUserServiceEvent* event) {
+    int32_t result = (int32_t)MOCK_USER_NO_EVENT;
+
+    pthread_mutex_lock(&g_user_lock);
+    if (g_user_event_count > 0) {
+        *event = g_user_events[g_user_event_head];
+        g_user_event_head = (g_user_event_head + 1) % MOCK_USER_EVENTS;
+        g_user_event_count--;
+        result = 0;
+    }
+    pthread_mutex_unlock(&g_user_lock);
+    return result;
+}
+
+// ============================================
+// Pad (the "real" DS4 behind the hooks)
+// ============================================
+
+static void neutral_pad(OrbisPadData* data) {
+    memset(data, 0, sizeof(*data));
+    data->leftStick.x = 128;
+    data->leftStick.y = 128;
+    data->rightStick.x = 128;
+    data->rightStick.y = 128;
+    data->quat.w = 1.0f;
+    data->connected = 1;
+    data->timestamp = sceKernelGetProcessTime();
+}
+
+int32_t scePadInit(void) {
+    return 0;
+}
+
+int32_t scePadOpen(int32_t userId, int32_t type, int32_t index, void* param) {
+    (void)type;
+    (void)index;
+    (void)param;
+    return 0x100 + (userId & 0xFF);
+}
+
+int32_t scePadClose(int32_t handle) {
+    (void)handle;
+    return 0;
+}
+
+int32_t scePadRead(int32_t handle, OrbisPadData* data, int32_t num) {
+    (void)handle;
+    if (num <= 0) {
+        return 0;
+    }
+    neutral_pad(data);
+    return 1;
+}
+
+int32_t scePadReadState(int32_t handle, OrbisPadData* data) {
+    (void)handle;
+    neutral_pad(data);
+    return 0;
+}
+
+int32_t scePadReadExt(int32_t handle, OrbisPadData* data, int32_t num) {
+    return scePadRead(handle, data, num);
+}
+
+int32_t scePadReadStateExt(int32_t handle, OrbisPadData* data) {
+    return scePadReadState(handle, data);
+}
+
+int32_t scePadGetControllerInformation(int32_t handle, OrbisPadInformation* info) {
+    (void)handle;
+    memset(info, 0, sizeof(*info));
+    info->connected = 1;
+    info->deviceClass = ORBIS_PAD_DEVICE_CLASS_PAD;
+    return 0;
+}
+
+int32_t scePadSetVibration(int32_t handle, const OrbisPadVibeParam* param) {
+    (void)handle;
+    (void)param;
+    return 0;
+}
+
+// ============================================
+// USB
+// ============================================
+
+typedef struct {
+    uint64_t at_us;             // Offset from script start
+    int      length;
+    uint8_t  data[MOCK_REPORT_MAX];
+} ScriptEntry;
+
+struct libusb_device {
+    uint16_t        vendor_id;
+    uint16_t        product_id;
+    uint8_t         bus;
+    uint8_t         address;
+    volatile int    attached;
+    pthread_mutex_t lock;
+
+    uint32_t        latency_us;
+    uint32_t        interval_us;
+    uint8_t         endpoint_in;
+    uint8_t         endpoint_out;
+
+    ScriptEntry*    script;
+    int             script_count;
+    int             script_capacity;
+    uint64_t        script_start;
+    int             loop;
+    int             delivered;      // Index of the last delivered report (-1 = none)
+    uint64_t        last_delivery;
+
+    uint64_t        reports_delivered;
+    uint64_t        reports_coalesced;
+    uint64_t        timeouts;
+
+    uint8_t         last_out[MOCK_REPORT_MAX];
+    int             last_out_length;
+    uint64_t        outputs_sent;
+};
+
+struct libusb_device_handle {
+    libusb_device*  device;
+};
+
+static libusb_device*  g_devices[MOCK_MAX_DEVICES];
+static int             g_device_count = 0;
+static uint8_t         g_next_address = 1;
+static pthread_mutex_t g_bus_lock = PTHREAD_MUTEX_INITIALIZER;
+
+MockUsbDevice* mock_usb_attach(uint16_t vendor_id, uint16_t product_id) {
+    libusb_device* dev = calloc(1, sizeof(*dev));
+    if (dev == NULL) {
+        return NULL;
+    }
+
+    dev->vendor_id = vendor_id;
+    dev->product_id = product_id;
+    dev->bus = 1;
+    dev->interval_us = 1000;
+    dev->endpoint_in = 0x81;
+    dev->endpoint_out = 0x01;
+    dev->delivered = -1;
+    dev->attached = 1;
+    pthread_mutex_init(&dev->lock, NULL);
+
+    pthread_mutex_lock(&g_bus_lock);
+    if (g_device_count >= MOCK_MAX_DEVICES) {
+        pthread_mutex_unlock(&g_bus_lock);
+        free(dev);
+        return NULL;
+    }
+    dev->address = g_next_address++;
+    g_devices[g_device_count++] = dev;
+    pthread_mutex_unlock(&g_bus_lock);
+
+    return dev;
+}
+
+void mock_usb_detach(MockUsbDevice* dev) {
+    pthread_mutex_lock(&g_bus_lock);
+    for (int i = 0; i < g_device_count; i++) {
+        if (g_devices[i] == dev) {
+            g_devices[i] = g_devices[--g_device_count];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_bus_lock);
+
+    // Kept allocated: the plugin may still hold a handle
+    dev->attached = 0;
+}
+
+void mock_usb_set_latency(MockUsbDevice* dev, uint32_t latency_us) {
+    dev->latency_us = latency_us;
+}
+
+void mock_usb_set_interval(MockUsbDevice* dev, uint32_t interval_us) {
+    dev->interval_us = interval_us;
+}
+
+void mock_usb_set_endpoints(MockUsbDevice* dev, uint8_t endpoint_in, uint8_t endpoint_out) {
+    dev->endpoint_in = endpoint_in;
+    dev->endpoint_out = endpoint_out;
+}
+
+int mock_usb_script_report(MockUsbDevice* dev, const uint8_t* data, int length, uint32_t delay_us) {
+    if (length <= 0 || length > MOCK_REPORT_MAX) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&dev->lock);
+    if (dev->script_count == dev->script_capacity) {
+        int capacity = dev->script_capacity ? dev->script_capacity * 2 : 256;
+        ScriptEntry* script = realloc(dev->script, sizeof(ScriptEntry) * (size_t)capacity);
+        if (script == NULL) {
+            pthread_mutex_unlock(&dev->lock);
+            return -1;
+        }
+        dev->script = script;
+        dev->script_capacity = capacity;
+    }
+
+    ScriptEntry* entry = &dev->script[dev->script_count];
+    uint64_t previous = dev->script_count ? dev->script[dev->script_count - 1].at_us : 0;
+    entry->at_us = previous + delay_us;
+    entry->length = length;
+    memcpy(entry->data, data, (size_t)length);
+    int index = dev->script_count++;
+    pthread_mutex_unlock(&dev->lock);
+
+    return index;
+}
+
+uint64_t mock_usb_script_start(MockUsbDevice* dev, int loop) {
+    pthread_mutex_lock(&dev->lock);
+    dev->script_start = sceKernelGetProcessTime();
+    dev->loop = loop;
+    dev->delivered = -1;
+    uint64_t start = dev->script_start;
+    pthread_mutex_unlock(&dev->lock);
+    return start;
+}
+
+uint64_t mock_usb_reports_delivered(const MockUsbDevice* dev) {
+    return dev->reports_delivered;
+}
+
+uint64_t mock_usb_reports_coalesced(const MockUsbDevice* dev) {
+    return dev->reports_coalesced;
+}
+
+uint64_t mock_usb_transfers_timed_out(const MockUsbDevice* dev) {
+    return dev->timeouts;
+}
+
+int mock_usb_last_output(const MockUsbDevice* dev, uint8_t* data, int max_length) {
+    int length = dev->last_out_length < max_length ? dev->last_out_length : max_length;
+    memcpy(data, dev->last_out, (size_t)length);
+    return length;
+}
+
+uint64_t mock_usb_outputs_sent(const MockUsbDevice* dev) {
+    return dev->outputs_sent;
+}
+
+int32_t sceUsbdInit(void) {
+    return 0;
+}
+
+void sceUsbdExit(void) {
+}
+
+int32_t sceUsbdGetDeviceList(libusb_device*** list) {
+    pthread_mutex_lock(&g_bus_lock);
+    libusb_device** devices = calloc((size_t)g_device_count + 1, sizeof(libusb_device*));
+    int count = g_device_count;
+    if (devices != NULL) {
+        memcpy(devices, g_devices, sizeof(libusb_device*) * (size_t)count);
+    }
+    pthread_mutex_unlock(&g_bus_lock);
+
+    if (devices == NULL) {
+        return LIBUSB_ERROR_NO_MEM;
+    }
+    *list = devices;
+    return count;
+}
+
+void sceUsbdFreeDeviceList(libusb_device** list) {
+    free(list);
+}
+
+int32_t sceUsbdGetDeviceDescriptor(libusb_device* device, struct libusb_device_descriptor* desc) {
+    memset(desc, 0, sizeof(*desc));
+    desc->bLength = 18;
+    desc->bDescriptorType = 1;
+    desc->bcdUSB = 0x0200;
+    desc->bMaxPacketSize0 = 64;
+    desc->idVendor = device->vendor_id;
+    desc->idProduct = device->product_id;
+    desc->bNumConfigurations = 1;
+    return 0;
+}
+
+/*
+ * One configuration, interface 0 with an interrupt IN and OUT endpoint.
+ * bInterval is the device interval rounded down to 1ms frames.
+ */
+int32_t sceUsbdGetActiveConfigDescriptor(libusb_device* device, struct libusb_config_descriptor** config) {
+    struct {
+        struct libusb_config_descriptor    config;
+        struct libusb_interface            interface;
+        struct libusb_interface_descriptor altsetting;
+        struct libusb_endpoint_descriptor  endpoint[2];
+    }* block = calloc(1, sizeof(*block));
+    if (block == NULL) {
+        return LIBUSB_ERROR_NO_MEM;
+    }
+
+    uint32_t frames = device->interval_us / 1000;
+    uint8_t b_interval = (uint8_t)(frames < 1 ? 1 : (frames > 255 ? 255 : frames));
+
+    for (int i = 0; i < 2; i++) {
+        struct libusb_endpoint_descriptor* endpoint = &block->endpoint[i];
+        endpoint->bLength = 7;
+        endpoint->bDescriptorType = 5;
+        endpoint->bEndpointAddress = i == 0 ? device->endpoint_in : device->endpoint_out;
+        endpoint->bmAttributes = 3;     // Interrupt
+        endpoint->wMaxPacketSize = MOCK_REPORT_MAX;
+        endpoint->bInterval = b_interval;
+    }
+
+    block->altsetting.bLength = 9;
+    block->altsetting.bDescriptorType = 4;
+    block->altsetting.bNumEndpoints = 2;
+    block->altsetting.bInterfaceClass = 0xFF;
+    block->altsetting.endpoint = block->endpoint;
+    block->interface.altsetting = &block->altsetting;
+    block->interface.num_altsetting = 1;
+    block->config.bLength = 9;
+    block->config.bDescriptorType = 2;
+    block->config.wTotalLength = 9 + 9 + 7 * 2;
+    block->config.bNumInterfaces = 1;
+    block->config.bConfigurationValue = 1;
+    block->config.interface = &block->interface;
+
+    // The config descriptor is the first member, so freeing it frees the block
+    *config = &block->config;
+    return 0;
+}
+
+void sceUsbdFreeConfigDescriptor(struct libusb_config_descriptor* config) {
+    free(config);
+}
+
+uint8_t sceUsbdGetBusNumber(libusb_device* device) {
+    return device->bus;
+}
+
+uint8_t sceUsbdGetDeviceAddress(libusb_device* device) {
+    return device->address;
+}
+
+libusb_device* sceUsbdRefDevice(libusb_device* device) {
+    return device;
+}
+
+void sceUsbdUnrefDevice(libusb_device* device) {
+    (void)device;
+}
+
+libusb_device* sceUsbdGetDevice(libusb_device_handle* handle) {
+    return handle->device;
+}
+
+int32_t sceUsbdOpen(libusb_device* device, libusb_device_handle** handle) {
+    if (!device->attached) {
+        return LIBUSB_ERROR_NO_DEVICE;
+    }
+    libusb_device_handle* h = calloc(1, sizeof(*h));
+    if (h == NULL) {
+        return LIBUSB_ERROR_NO_MEM;
+    }
+    h->device = device;
+    *handle = h;
+    return 0;
+}
+
+void sceUsbdClose(libusb_device_handle* handle) {
+    free(handle);
+}
+
+int32_t sceUsbdClaimInterface(libusb_device_handle* handle, int32_t interface_number) {
+    (void)interface_number;
+    return handle->device->attached ? 0 : LIBUSB_ERROR_NO_DEVICE;
+}
+
+int32_t sceUsbdReleaseInterface(libusb_device_handle* handle, int32_t interface_number) {
+    (void)handle;
+    (void)interface_number;
+    return 0;
+}
+
+int32_t sceUsbdDetachKernelDriver(libusb_device_handle* handle, int32_t interface_number) {
+    (void)handle;
+    (void)interface_number;
+    return LIBUSB_ERROR_NOT_FOUND;
+}
+
+int32_t sceUsbdSetInterfaceAltSetting(libusb_device_handle* handle, int32_t interface_number, int32_t alternate_setting) {
+    (void)interface_number;
+    (void)alternate_setting;
+    return handle->device->attached ? 0 : LIBUSB_ERROR_NO_DEVICE;
+}
+
+int32_t sceUsbdCheckConnected(libusb_device_handle* handle) {
+    return handle->device->attached ? 0 : LIBUSB_ERROR_NO_DEVICE;
+}
+
+/*
+ * Pick the newest scripted report available at `now` (device locked)
+ * @return Script index, or -1 if nothing new is available yet
+ */
+static int newest_available(libusb_device* dev, uint64_t now, uint64_t* next_at) {
+    *next_at = UINT64_MAX;
+
+    if (dev->script_count == 0 || dev->script_start == 0) {
+        return -1;
+    }
+
+    uint64_t length = dev->script[dev->script_count - 1].at_us;
+
+    // Looping scripts restart once fully delivered and past their end
+    if (dev->loop && dev->delivered == dev->script_count - 1 &&
+        now >= dev->script_start + length + dev->interval_us) {
+        dev->script_start += length + dev->interval_us;
+        dev->delivered = -1;
+    }
+
+    int newest = -1;
+    for (int i = dev->delivered + 1; i < dev->script_count; i++) {
+        uint64_t at = dev->script_start + dev->script[i].at_us;
+        if (at > now) {
+            *next_at = at;
+            break;
+        }
+        newest = i;
+    }
+    return newest;
+}
+
+/*
+ * Move the delivery slot to the latest interval boundary at or before `now`
+ * (device locked). Slots stay on a fixed grid like bus frames do, so a read
+ * that arrives late within a frame does not push every later report back;
+ * frames nobody was reading in are skipped, not replayed as a burst.
+ */
+static void advance_delivery_slot(libusb_device* dev, uint64_t now) {
+    uint64_t interval = dev->interval_us ? dev->interval_us : 1;
+    dev->last_delivery += (now - dev->last_delivery) / interval * interval;
+}
+
+static int32_t read_scripted_report(libusb_device* dev, unsigned char* data, int32_t length,
+                                    int32_t* transferred, uint32_t timeout) {
+    uint64_t now = sceKernelGetProcessTime();
+    uint64_t deadline = timeout ? now + (uint64_t)timeout * 1000ull : UINT64_MAX;
+
+    pthread_mutex_lock(&dev->lock);
+    for (;;) {
+        if (!dev->attached) {
+            pthread_mutex_unlock(&dev->lock);
+            return LIBUSB_ERROR_NO_DEVICE;
+        }
+
+        now = sceKernelGetProcessTime();
+        uint64_t next_at;
+        uint64_t ready_at = dev->last_delivery + dev->interval_us;
+        int newest = newest_available(dev, now, &next_at);
+
+        if (newest >= 0 && now >= ready_at) {
+            ScriptEntry* entry = &dev->script[newest];
+            int32_t copy = entry->length < length ? entry->length : length;
+            memcpy(data, entry->data, (size_t)copy);
+            *transferred = copy;
+            dev->reports_coalesced += (uint64_t)(newest - dev->delivered - 1);
+            dev->reports_delivered++;
+            dev->delivered = newest;
+            advance_delivery_slot(dev, now);
+            uint32_t latency = dev->latency_us;
+            pthread_mutex_unlock(&dev->lock);
+
+            if (latency) {
+                sleep_until_us(now + latency);
+            }
+            return 0;
+        }
+
+        uint64_t wake = (newest >= 0) ? ready_at : next_at;
+        if (wake > deadline) {
+            wake = deadline;
+        }
+        if (now >= deadline) {
+            dev->timeouts++;
+            pthread_mutex_unlock(&dev->lock);
+            *transferred = 0;
+            return LIBUSB_ERROR_TIMEOUT;
+        }
+
+        pthread_mutex_unlock(&dev->lock);
+        sleep_until_us(wake);
+        pthread_mutex_lock(&dev->lock);
+    }
+}
+
+// OUT: remember the packet for inspection
+static void record_output(libusb_device* dev, const unsigned char* data, int32_t length) {
+    pthread_mutex_lock(&dev->lock);
+    int32_t copy = length < MOCK_REPORT_MAX ? length : MOCK_REPORT_MAX;
+    memcpy(dev->last_out, data, (size_t)copy);
+    dev->last_out_length = copy;
+    dev->outputs_sent++;
+    pthread_mutex_unlock(&dev->lock);
+}
+
+int32_t sceUsbdInterruptTransfer(libusb_device_handle* handle, unsigned char endpoint,
+                                 unsigned char* data, int32_t length, int32_t* transferred,
+                                 uint32_t timeout) {
+    libusb_device* dev = handle->device;
+
+    if (!dev->attached) {
+        return LIBUSB_ERROR_NO_DEVICE;
+    }
+
+    if (endpoint & 0x80) {
+        if (endpoint != dev->endpoint_in) {
+            return LIBUSB_ERROR_PIPE;
+        }
+        return read_scripted_report(dev, data, length, transferred, timeout);
+    }
+    if (endpoint != dev->endpoint_out) {
+        return LIBUSB_ERROR_PIPE;
+    }
+
+    record_output(dev, data, length);
+    *transferred = length;
+    return 0;
+}
+
+// ============================================
+// USB asynchronous transfers
+// ============================================
+
+/*
+ * Mock bookkeeping, allocated in front of each libusb_transfer
+ * Submitted transfers wait in one FIFO; sceUsbdHandleEventsTimeout
+ * completes them in order. An IN transfer takes the newest scripted
+ * report under the same rules as a synchronous one, then completes once
+ * the device latency has passed.
+ */
+typedef struct MockTransfer {
+    struct MockTransfer* next;
+    int                  submitted;
+    int                  cancelled;
+    int                  has_data;      // Report copied, waiting for `due`
+    uint64_t             due;
+    uint64_t             deadline;      // UINT64_MAX without timeout
+    uint64_t             reserved;      // Keeps the transfer 16-byte aligned
+} MockTransfer;
+
+#define MOCK_TRANSFER(t)    ((MockTransfer*)(t) - 1)
+
+static MockTransfer*   g_pending_head = NULL;
+static MockTransfer*   g_pending_tail = NULL;
+static pthread_mutex_t g_transfer_lock = PTHREAD_MUTEX_INITIALIZER;
+
+struct libusb_transfer* sceUsbdAllocTransfer(int32_t iso_packets) {
+    size_t size = sizeof(MockTransfer) + sizeof(struct libusb_transfer) +
+                  sizeof(struct libusb_iso_packet_descriptor) * (size_t)iso_packets;
+    MockTransfer* mock = calloc(1, size);
+    if (mock == NULL) {
+        return NULL;
+    }
+
+    struct libusb_transfer* transfer = (struct libusb_transfer*)(mock + 1);
+    transfer->num_iso_packets = iso_packets;
+    return transfer;
+}
+
+void sceUsbdFreeTransfer(struct libusb_transfer* transfer) {
+    if (transfer != NULL) {
+        free(MOCK_TRANSFER(transfer));
+    }
+}
+
+void sceUsbdFillInterruptTransfer(struct libusb_transfer* transfer, libusb_device_handle* handle,
+                                  unsigned char endpoint, unsigned char* buffer, int32_t length,
+                                  libusb_transfer_cb_fn callback, void* user_data,
+                                  uint32_t timeout) {
+    transfer->dev_handle = handle;
+    transfer->endpoint = endpoint;
+    transfer->type = LIBUSB_TRANSFER_TYPE_INTERRUPT;
+    transfer->timeout = timeout;
+    transfer->buffer = buffer;
+    transfer->length = length;
+    transfer->callback = callback;
+    transfer->user_data = user_data;
+}
+
+int32_t sceUsbdSubmitTransfer(struct libusb_transfer* transfer) {
+    MockTransfer* mock = MOCK_TRANSFER(transfer);
+
+    if (!transfer->dev_handle->device->attached) {
+        return LIBUSB_ERROR_NO_DEVICE;
+    }
+
+    pthread_mutex_lock(&g_transfer_lock);
+    if (mock->submitted) {
+        pthread_mutex_unlock(&g_transfer_lock);
+        return LIBUSB_ERROR_BUSY;
+    }
+
+    uint64_t now = sceKernelGetProcessTime();
+    mock->next = NULL;
+    mock->submitted = 1;
+    mock->cancelled = 0;
+    mock->has_data = 0;
+    mock->deadline = transfer->timeout ? now + (uint64_t)transfer->timeout * 1000ull : UINT64_MAX;
+    transfer->actual_length = 0;
+
+    if (g_pending_tail) {
+        g_pending_tail->next = mock;
+    } else {
+        g_pending_head = mock;
+    }
+    g_pending_tail = mock;
+    pthread_mutex_unlock(&g_transfer_lock);
+    return 0;
+}
+
+int32_t sceUsbdCancelTransfer(struct libusb_transfer* transfer) {
+    MockTransfer* mock = MOCK_TRANSFER(transfer);
+    int32_t ret = LIBUSB_ERROR_NOT_FOUND;
+
+    pthread_mutex_lock(&g_transfer_lock);
+    if (mock->submitted && !mock->cancelled) {
+        mock->cancelled = 1;
+        ret = 0;
+    }
+    pthread_mutex_unlock(&g_transfer_lock);
+    return ret;
+}
+
+/*
+ * Decide the outcome of a pending transfer (transfer list locked)
+ * @param wake  Lowered to the next time this transfer may progress
+ * @return Completion status, or -1 if it is still pending
+ */
+static int transfer_progress(MockTransfer* mock, uint64_t now, uint64_t* wake) {
+    struct libusb_transfer* transfer = (struct libusb_transfer*)(mock + 1);
+    libusb_device* dev = transfer->dev_handle->device;
+
+    if (mock->cancelled) {
+        return LIBUSB_TRANSFER_CANCELLED;
+    }
+    if (!dev->attached) {
+        return LIBUSB_TRANSFER_NO_DEVICE;
+    }
+
+    if (!(transfer->endpoint & 0x80)) {
+        if (transfer->endpoint != dev->endpoint_out) {
+            return LIBUSB_TRANSFER_STALL;
+        }
+        record_output(dev, transfer->buffer, transfer->length);
+        transfer->actual_length = transfer->length;
+        return LIBUSB_TRANSFER_COMPLETED;
+    }
+    if (transfer->endpoint != dev->endpoint_in) {
+        return LIBUSB_TRANSFER_STALL;
+    }
+
+    if (!mock->has_data) {
+        pthread_mutex_lock(&dev->lock);
+        uint64_t next_at;
+        uint64_t ready_at = dev->last_delivery + dev->interval_us;
+        int newest = newest_available(dev, now, &next_at);
+
+        if (newest >= 0 && now >= ready_at) {
+            ScriptEntry* entry = &dev->script[newest];
+            int32_t copy = entry->length < transfer->length ? entry->length : transfer->length;
+            memcpy(transfer->buffer, entry->data, (size_t)copy);
+            transfer->actual_length = copy;
+            dev->reports_coalesced += (uint64_t)(newest - dev->delivered - 1);
+            dev->reports_delivered++;
+            dev->delivered = newest;
+            advance_delivery_slot(dev, now);
+            mock->has_data = 1;
+            mock->due = now + dev->latency_us;
+        } else {
+            uint64_t at = (newest >= 0) ? ready_at : next_at;
+            if (at < *wake) *wake = at;
+        }
+        pthread_mutex_unlock(&dev->lock);
+    }
+
+    if (mock->has_data) {
+        if (now >= mock->due) {
+            return LIBUSB_TRANSFER_COMPLETED;
+        }
+        if (mock->due < *wake) *wake = mock->due;
+        return -1;
+    }
+
+    if (now >= mock->deadline) {
+        pthread_mutex_lock(&dev->lock);
+        dev->timeouts++;
+        pthread_mutex_unlock(&dev->lock);
+        return LIBUSB_TRANSFER_TIMED_OUT;
+    }
+    if (mock->deadline < *wake) *wake = mock->deadline;
+    return -1;
+}
+
+int32_t sceUsbdHandleEventsTimeout(struct timeval* tv) {
+    uint64_t now = sceKernelGetProcessTime();
+    uint64_t timeout = tv ? (uint64_t)tv->tv_sec * 1000000ull + (uint64_t)tv->tv_usec : 60000000ull;
+    uint64_t deadline = now + timeout;
+
+    for (;;) {
+        MockTransfer* done_head = NULL;
+        MockTransfer** done_tail = &done_head;
+        MockTransfer* prev = NULL;
+        uint64_t wake = deadline;
+
+        pthread_mutex_lock(&g_transfer_lock);
+        now = sceKernelGetProcessTime();
+        for (MockTransfer* mock = g_pending_head; mock != NULL; ) {
+            MockTransfer* next = mock->next;
+            int status = transfer_progress(mock, now, &wake);
+
+            if (status >= 0) {
+                // Unlink and queue for its callback
+                if (prev) {
+                    prev->next = next;
+                } else {
+                    g_pending_head = next;
+                }
+                if (g_pending_tail == mock) {
+                    g_pending_tail = prev;
+                }
+                ((struct libusb_transfer*)(mock + 1))->status = (enum libusb_transfer_status)status;
+                mock->submitted = 0;
+                mock->next = NULL;
+                *done_tail = mock;
+                done_tail = &mock->next;
+            } else {
+                prev = mock;
+            }
+            mock = next;
+        }
+        pthread_mutex_unlock(&g_transfer_lock);
+
+        // Callbacks run unlocked: they usually resubmit
+        if (done_head != NULL) {
+            while (done_head != NULL) {
+                MockTransfer* mock = done_head;
+                done_head = mock->next;
+                struct libusb_transfer* transfer = (struct libusb_transfer*)(mock + 1);
+                transfer->callback(transfer);
+            }
+            return 0;
+        }
+
+        if (now >= deadline) {
+            return 0;
+        }
+        sleep_until_us(wake);
+    }
+}
+
+int32_t sceUsbdHandleEvents(void) {
+    return sceUsbdHandleEventsTimeout(NULL);
+}
@@ -0,0 +1,106 @@
+/*
+ * Host Mock Control API
+ * Drives the stand-in sceUsbd/scePad/sceUserService/sceKernel layer
+ * that `make host` links in place of the PS4 system libraries.
+ *
+ * USB devices replay a scripted list of input reports. Report i becomes
+ * available at script start + sum of delays[0..i]; an IN transfer
+ * returns the newest available report (older ones are coalesced, as a
+ * real pad only reports its current state), at most once per slot of a
+ * fixed grid spaced by the device interval, and after the configured
+ * transfer latency. Asynchronous IN
+ * transfers follow the same rules and complete inside
+ * sceUsbdHandleEventsTimeout, in submission order.
+ */
+
+#ifndef MOCK_SCE_H
+#define MOCK_SCE_H
+
+#include <stdint.h>
+
+typedef struct libusb_device MockUsbDevice;
+
+/*
+ * Plug a device into the mock bus (bus 1, next free address)
+ * @return Device, or NULL if the bus is full
+ */
+MockUsbDevice* mock_usb_attach(uint16_t vendor_id, uint16_t product_id);
+
+/*
+ * Unplug a device. Open handles start failing with LIBUSB_ERROR_NO_DEVICE.
+ */
+void mock_usb_detach(MockUsbDevice* dev);
+
+/*
+ * Transfer completion latency added to every IN transfer
+ */
+void mock_usb_set_latency(MockUsbDevice* dev, uint32_t latency_us);
+
+/*
+ * Minimum time between two delivered IN reports
+ * The config descriptor reports it as bInterval in whole milliseconds.
+ */
+void mock_usb_set_interval(MockUsbDevice* dev, uint32_t interval_us);
+
+/*
+ * Interrupt endpoint addresses reported in the config descriptor
+ * (default 0x81 IN, 0x01 OUT). Transfers to other endpoints stall.
+ */
+void mock_usb_set_endpoints(MockUsbDevice* dev, uint8_t endpoint_in, uint8_t endpoint_out);
+
+/*
+ * Append a report to the device script
+ * @param delay_us  Time after the previous scripted report
+ * @return Index of the report in the script, negative if full
+ */
+int mock_usb_script_report(MockUsbDevice* dev, const uint8_t* data, int length, uint32_t delay_us);
+
+/*
+ * Restart the script clock (report 0 becomes available delay[0] from now)
+ * @param loop      Restart the script when it runs out
+ * @return Script start time (sceKernelGetProcessTime units)
+ */
+uint64_t mock_usb_script_start(MockUsbDevice* dev, int loop);
+
+/*
+ * Transfer counters
+ */
+uint64_t mock_usb_reports_delivered(const MockUsbDevice* dev);
+uint64_t mock_usb_reports_coalesced(const MockUsbDevice* dev);
+uint64_t mock_usb_transfers_timed_out(const MockUsbDevice* dev);
+
+/*
+ * Last OUT transfer sent to the device
+ * @return Length of the packet copied to data, 0 if none
+ */
+int mock_usb_last_output(const MockUsbDevice* dev, uint8_t* data, int max_length);
+uint64_t mock_usb_outputs_sent(const MockUsbDevice* dev);
+
+/*
+ * Logged-in users; the first one is the foreground user
+ */
+void mock_user_set_logins(const int32_t* user_ids, int count);
+
+/*
+ * Log a user in or out, queueing the matching sceUserServiceGetEvent
+ * event (mock_user_set_logins queues none)
+ */
+void mock_user_login(int32_t user_id);
+void mock_user_logout(int32_t user_id);
+
+/*
+ * Switch the foreground user (no event, as on the console)
+ */
+void mock_user_set_foreground(int32_t user_id);
+
+/*
+ * Title ID the running "game" reports through sys_sdk_proc_info
+ */
+void mock_set_title_id(const char* title_id);
+
+/*
+ * Print system notifications to stderr
+ */
+void mock_set_verbose(int verbose);
+
+#endif // MOCK_SCE_H
@@ -0,0 +1,575 @@
+/*
+ * Host Pipeline Harness
+ *
+ * Runs the real plugin sources (hooks, polling engine, translator) on
+ * Linux against the mock system layer. Mock controllers replay input
+ * reports; one thread per controller plays the game and calls the
+ * scePadRead hook at a fixed frame rate, asking for up to -n samples.
+ * Like a real game it also sets vibration several times per frame,
+ * changing the level every few frames.
+ *
+ * Generated reports carry an 8-bit sequence number in eight face,
+ * shoulder and menu buttons, so the reader can tell which report it
+ * got and how old that report was when the game saw it.
+ *
+ * Usage: pipeline [-c controllers] [-t 360|one|switch] [-r report_hz]
+ *                 [-l latency_us] [-f fps] [-n samples] [-s seconds] [-i script]
+ *                 [-d latency_dump] [-w capture] [-v]
+ *
+ * Script files hold one report per line: "<delay_us> <hex bytes>", or
+ * are XCAP captures (first controller only). -w records what the plugin
+ * receives to an XCAP capture for host/replay.c.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <orbis/libkernel.h>
+#include <orbis/Pad.h>
+
+#include "config.h"
+#include "translator.h"
+#include "usb_xbox.h"
+#include "latency.h"
+#include "mock_sce.h"
+#include "report_script.h"
+#include "capture.h"
+#include "notify.h"
+
+// Plugin entry points and hooks (not exported through headers)
+extern int32_t plugin_load(int32_t argc, const char* argv[]);
+extern int32_t plugin_unload(int32_t argc, const char* argv[]);
+extern int32_t scePadOpen_hook(int32_t userId, int32_t type, int32_t index, void* param);
+extern int32_t scePadClose_hook(int32_t handle);
+extern int32_t scePadRead_hook(int32_t handle, OrbisPadData* pData, int32_t num);
+extern int32_t scePadSetVibration_hook(int32_t handle, const OrbisPadVibeParam* param);
+
+#define FOREGROUND_USER     0x100
+#define SEQUENCE_BITS       8
+#define VIBRATION_CALLS     4       // scePadSetVibration calls per frame
+#define VIBRATION_FRAMES    8       // Frames between vibration level changes
+
+// ============================================
+// Options
+// ============================================
+
+typedef struct {
+    int             controllers;
+    ControllerType  type;
+    uint32_t        report_hz;
+    uint32_t        latency_us;
+    uint32_t        fps;
+    uint32_t        samples;
+    uint32_t        seconds;
+    const char*     script_path;
+    const char*     dump_path;
+    const char*     capture_path;
+    int             verbose;
+} PipelineOptions;
+
+static PipelineOptions g_options = {
+    .controllers = 1,
+    .type = CONTROLLER_XBOX360,
+    .report_hz = 1000,
+    .latency_us = 125,
+    .fps = 60,
+    .samples = 1,
+    .seconds = 3,
+    .script_path = NULL,
+    .dump_path = NULL,
+    .capture_path = NULL,
+    .verbose = 0,
+};
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [-c controllers] [-t 360|one|switch] [-r report_hz]\n"
+            "          [-l latency_us] [-f fps] [-n samples] [-s seconds] [-i script]\n"
+            "          [-d latency_dump] [-w capture] [-v]\n",
+            argv0);
+}
+
+static int parse_type(const char* name, ControllerType* type) {
+    if (strcmp(name, "360") == 0) {
+        *type = CONTROLLER_XBOX360;
+    } else if (strcmp(name, "one") == 0) {
+        *type = CONTROLLER_XBOXONE;
+    } else if (strcmp(name, "switch") == 0) {
+        *type = CONTROLLER_SWITCH;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+// ============================================
+// Report encoding
+// ============================================
+
+// DS4 button produced by each sequence bit, found by translating probes
+static uint32_t g_sequence_masks[SEQUENCE_BITS];
+
+static void device_ids(ControllerType type, uint16_t* vendor_id, uint16_t* product_id) {
+    switch (type) {
+        case CONTROLLER_XBOXONE:
+            *vendor_id = 0x045E;
+            *product_id = 0x02EA;
+            break;
+        case CONTROLLER_SWITCH:
+            *vendor_id = SWITCH_ROCKCAND_VID;
+            *product_id = SWITCH_ROCKCANDY_PID;
+            break;
+        default:
+            *vendor_id = 0x045E;
+            *product_id = 0x028E;
+            break;
+    }
+}
+
+/*
+ * Build a neutral report with the sequence number in its buttons
+ * @return Report length
+ */
+static int make_report(ControllerType type, uint8_t sequence, XboxRawReport* report) {
+    memset(report, 0, sizeof(*report));
+
+    switch (type) {
+        case CONTROLLER_XBOXONE: {
+            static const uint8_t low[6] = {
+                XBOXONE_A, XBOXONE_B, XBOXONE_X, XBOXONE_Y, XBOXONE_MENU, XBOXONE_VIEW
+            };
+            report->xboxone.report_type = XBOXONE_REPORT_INPUT;
+            report->xboxone.counter = sequence;
+            report->xboxone.length = (uint8_t)(sizeof(XboxOneReport) - 4);
+            for (int i = 0; i < 6; i++) {
+                if (sequence & (1 << i)) report->xboxone.buttons_low |= low[i];
+            }
+            if (sequence & 0x40) report->xboxone.buttons_high |= XBOXONE_LB;
+            if (sequence & 0x80) report->xboxone.buttons_high |= XBOXONE_RB;
+            return (int)sizeof(XboxOneReport);
+        }
+
+        case CONTROLLER_SWITCH: {
+            static const uint8_t face[6] = {
+                SWITCH_BTN_Y, SWITCH_BTN_B, SWITCH_BTN_A, SWITCH_BTN_X, SWITCH_BTN_L, SWITCH_BTN_R
+            };
+            for (int i = 0; i < 6; i++) {
+                if (sequence & (1 << i)) report->switch_report.buttons0 |= face[i];
+            }
+            if (sequence & 0x40) report->switch_report.buttons1 |= SWITCH_BTN_MINUS;
+            if (sequence & 0x80) report->switch_report.buttons1 |= SWITCH_BTN_PLUS;
+            report->switch_report.hat = 8;
+            report->switch_report.left_stick_x = 128;
+            report->switch_report.left_stick_y = 128;
+            report->switch_report.right_stick_x = 128;
+            report->switch_report.right_stick_y = 128;
+            return SWITCH_INPUT_ONLY_REPORT_SIZE;
+        }
+
+        default: {
+            static const uint16_t bits[SEQUENCE_BITS] = {
+                XBOX360_BTN_A, XBOX360_BTN_B, XBOX360_BTN_X, XBOX360_BTN_Y,
+                XBOX360_BTN_LB, XBOX360_BTN_RB, XBOX360_BTN_START, XBOX360_BTN_BACK
+            };
+            uint16_t buttons = 0;
+            for (int i = 0; i < SEQUENCE_BITS; i++) {
+                if (sequence & (1 << i)) buttons |= bits[i];
+            }
+            report->xbox360.msg_type = 0x00;
+            report->xbox360.msg_length = XBOX360_REPORT_SIZE;
+            report->xbox360.buttons_low = (uint8_t)(buttons & 0xFF);
+            report->xbox360.buttons_high = (uint8_t)(buttons >> 8);
+            return XBOX360_REPORT_SIZE;
+        }
+    }
+}
+
+static void translate(ControllerType type, const XboxRawReport* report, OrbisPadData* state) {
+    switch (type) {
+        case CONTROLLER_XBOXONE:
+            xboxone_to_ds4(&report->xboxone, state);
+            break;
+        case CONTROLLER_SWITCH:
+            switch_to_ds4(&report->switch_report, state);
+            break;
+        default:
+            xbox360_to_ds4(&report->xbox360, state);
+            break;
+    }
+}
+
+/*
+ * Learn which DS4 button each sequence bit turns into
+ * @return 0 if all bits map to distinct buttons
+ */
+static int probe_sequence_masks(ControllerType type) {
+    uint32_t seen = 0;
+
+    for (int i = 0; i < SEQUENCE_BITS; i++) {
+        XboxRawReport report;
+        OrbisPadData state;
+        make_report(type, (uint8_t)(1 << i), &report);
+        translate(type, &report, &state);
+        g_sequence_masks[i] = state.buttons;
+        if (state.buttons == 0 || (state.buttons & seen)) {
+            return -1;
+        }
+        seen |= state.buttons;
+    }
+    return 0;
+}
+
+static uint8_t decode_sequence(uint32_t buttons) {
+    uint8_t sequence = 0;
+    for (int i = 0; i < SEQUENCE_BITS; i++) {
+        if (buttons & g_sequence_masks[i]) sequence |= (uint8_t)(1 << i);
+    }
+    return sequence;
+}
+
+static int script_device_report(void* context, uint32_t delay_us, const uint8_t* data, int length) {
+    return mock_usb_script_report((MockUsbDevice*)context, data, length, delay_us) < 0;
+}
+
+// ============================================
+// Game reader
+// ============================================
+
+typedef struct {
+    int             index;
+    int32_t         handle;
+    uint64_t        script_start;
+    uint32_t        report_interval;
+    int             sequenced;
+
+    pthread_t       thread;
+    uint64_t        reads;
+    uint64_t        read_ns;
+    uint64_t        fresh;          // Reads that saw a newer report
+    uint64_t        skipped;        // Reports superseded between two reads
+    uint32_t*       ages;           // Report age at first read, microseconds
+    uint64_t        age_count;
+    uint64_t        age_capacity;
+    uint64_t        vibrations;     // scePadSetVibration calls
+} GameReader;
+
+static volatile int g_running = 1;
+
+static void* reader_thread_func(void* arg) {
+    GameReader* reader = (GameReader*)arg;
+    uint64_t frame_us = 1000000ull / g_options.fps;
+    uint64_t next_frame = sceKernelGetProcessTime();
+    int64_t last_report = -1;
+
+    while (g_running) {
+        OrbisPadData samples[PAD_HISTORY_SAMPLES];
+
+        uint64_t t0 = sceKernelReadTsc();
+        int32_t ret = scePadRead_hook(reader->handle, samples, (int32_t)g_options.samples);
+        uint64_t t1 = sceKernelReadTsc();
+        uint64_t now = sceKernelGetProcessTime();
+
+        reader->reads++;
+        reader->read_ns += (t1 - t0) * 1000000000ull / sceKernelGetTscFrequency();
+
+        for (int32_t i = 0; i < ret && reader->sequenced; i++) {
+            const OrbisPadData* data = &samples[i];
+            if (data->timestamp == 0 || data->buttons == 0) {
+                continue;
+            }
+
+            // Unwrap the 8-bit sequence against the last report seen
+            uint8_t sequence = decode_sequence(data->buttons);
+            int64_t report = (last_report < 0)
+                ? sequence
+                : last_report + (uint8_t)(sequence - (uint8_t)last_report);
+
+            if (report != last_report) {
+                if (last_report >= 0) {
+                    reader->skipped += (uint64_t)(report - last_report - 1);
+                }
+                last_report = report;
+                reader->fresh++;
+
+                uint64_t available = reader->script_start +
+                                     (uint64_t)(report + 1) * reader->report_interval;
+                if (now >= available && reader->age_count < reader->age_capacity) {
+                    reader->ages[reader->age_count++] = (uint32_t)(now - available);
+                }
+            }
+        }
+
+        // Rumble: same value every call, new level every few frames
+        uint8_t level = ((reader->reads / VIBRATION_FRAMES) & 1) ? 0xC0 : 0x00;
+        OrbisPadVibeParam vibe = { .lgMotor = level, .smMotor = (uint8_t)(level >> 1) };
+        for (int v = 0; v < VIBRATION_CALLS; v++) {
+            scePadSetVibration_hook(reader->handle, &vibe);
+            reader->vibrations++;
+        }
+
+        next_frame += frame_us;
+        now = sceKernelGetProcessTime();
+        if (next_frame > now) {
+            sceKernelUsleep((unsigned int)(next_frame - now));
+        }
+    }
+
+    return NULL;
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile(const uint32_t* sorted, uint64_t count, int pct) {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = (count * (uint64_t)pct + 99) / 100;
+    return sorted[rank ? rank - 1 : 0];
+}
+
+// ============================================
+// Main
+// ============================================
+
+int main(int argc, char* argv[]) {
+    int opt;
+    while ((opt = getopt(argc, argv, "c:t:r:l:f:n:s:i:d:w:vh")) != -1) {
+        switch (opt) {
+            case 'c': g_options.controllers = atoi(optarg); break;
+            case 'r': g_options.report_hz = (uint32_t)atoi(optarg); break;
+            case 'l': g_options.latency_us = (uint32_t)atoi(optarg); break;
+            case 'f': g_options.fps = (uint32_t)atoi(optarg); break;
+            case 'n': g_options.samples = (uint32_t)atoi(optarg); break;
+            case 's': g_options.seconds = (uint32_t)atoi(optarg); break;
+            case 'i': g_options.script_path = optarg; break;
+            case 'd': g_options.dump_path = optarg; break;
+            case 'w': g_options.capture_path = optarg; break;
+            case 'v': g_options.verbose = 1; break;
+            case 't':
+                if (parse_type(optarg, &g_options.type) == 0) break;
+                /* fall through */
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    if (g_options.controllers < 1 || g_options.controllers > MAX_XBOX_CONTROLLERS ||
+        g_options.report_hz == 0 || g_options.fps == 0 || g_options.seconds == 0 ||
+        g_options.samples == 0 || g_options.samples > PAD_HISTORY_SAMPLES) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    mock_set_verbose(g_options.verbose);
+
+    if (g_options.script_path == NULL && probe_sequence_masks(g_options.type) != 0) {
+        fprintf(stderr, "pipeline: sequence buttons do not map to distinct DS4 buttons\n");
+        return 1;
+    }
+
+    // One foreground user plus one login per Xbox controller
+    int32_t users[1 + MAX_XBOX_CONTROLLERS];
+    for (int i = 0; i <= g_options.controllers; i++) {
+        users[i] = FOREGROUND_USER + i;
+    }
+    mock_user_set_logins(users, g_options.controllers + 1);
+
+    // Script the controllers before they are plugged in
+    uint32_t interval = 1000000u / g_options.report_hz;
+    uint16_t vendor_id, product_id;
+    device_ids(g_options.type, &vendor_id, &product_id);
+
+    MockUsbDevice* devices[MAX_XBOX_CONTROLLERS];
+    for (int i = 0; i < g_options.controllers; i++) {
+        devices[i] = mock_usb_attach(vendor_id, product_id);
+        if (devices[i] == NULL) {
+            fprintf(stderr, "pipeline: mock bus full\n");
+            return 1;
+        }
+        mock_usb_set_interval(devices[i], interval);
+        mock_usb_set_latency(devices[i], g_options.latency_us);
+        if (g_options.type == CONTROLLER_XBOXONE) {
+            mock_usb_set_endpoints(devices[i], 0x82, 0x02);
+        }
+
+        if (g_options.script_path) {
+            if (report_script_load(g_options.script_path, script_device_report, devices[i]) <= 0) {
+                fprintf(stderr, "pipeline: cannot load script %s\n", g_options.script_path);
+                return 1;
+            }
+        } else {
+            uint64_t reports = (uint64_t)g_options.report_hz * g_options.seconds;
+            for (uint64_t r = 0; r < reports; r++) {
+                XboxRawReport report;
+                int length = make_report(g_options.type, (uint8_t)r, &report);
+                mock_usb_script_report(devices[i], report.raw, length, interval);
+            }
+        }
+    }
+
+    if (g_options.capture_path && capture_start(g_options.capture_path) != 0) {
+        fprintf(stderr, "pipeline: cannot write %s\n", g_options.capture_path);
+        return 1;
+    }
+
+    if (plugin_load(0, NULL) != 0) {
+        fprintf(stderr, "pipeline: plugin_load failed\n");
+        return 1;
+    }
+
+    // Wait for hot-plug detection to open every controller
+    uint64_t deadline = sceKernelGetProcessTime() + 2000000ull + HOTPLUG_SCAN_INTERVAL_US;
+    while (xbox_usb_get_controller_count() < g_options.controllers) {
+        if (sceKernelGetProcessTime() > deadline) {
+            fprintf(stderr, "pipeline: only %d of %d controllers connected\n",
+                    xbox_usb_get_controller_count(), g_options.controllers);
+            plugin_unload(0, NULL);
+            return 1;
+        }
+        sceKernelUsleep(1000);
+    }
+
+    // Init packets sent on open are not rumble
+    uint64_t outputs_before[MAX_XBOX_CONTROLLERS];
+    for (int i = 0; i < g_options.controllers; i++) {
+        outputs_before[i] = mock_usb_outputs_sent(devices[i]);
+    }
+
+    GameReader readers[MAX_XBOX_CONTROLLERS];
+    memset(readers, 0, sizeof(readers));
+
+    for (int i = 0; i < g_options.controllers; i++) {
+        GameReader* reader = &readers[i];
+        reader->index = i;
+        reader->handle = scePadOpen_hook(users[i + 1], 0, 0, NULL);
+        reader->report_interval = interval;
+        reader->sequenced = (g_options.script_path == NULL);
+        reader->age_capacity = (uint64_t)g_options.fps * g_options.seconds + 16;
+        reader->ages = calloc(reader->age_capacity, sizeof(uint32_t));
+        if (!IS_VIRTUAL_HANDLE(reader->handle) || reader->ages == NULL) {
+            fprintf(stderr, "pipeline: controller %d did not get a virtual pad\n", i);
+            plugin_unload(0, NULL);
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < g_options.controllers; i++) {
+        readers[i].script_start = mock_usb_script_start(devices[i], g_options.script_path != NULL);
+    }
+    for (int i = 0; i < g_options.controllers; i++) {
+        pthread_create(&readers[i].thread, NULL, reader_thread_func, &readers[i]);
+    }
+
+    sceKernelUsleep(g_options.seconds * 1000000u);
+    g_running = 0;
+
+    for (int i = 0; i < g_options.controllers; i++) {
+        pthread_join(readers[i].thread, NULL);
+        scePadClose_hook(readers[i].handle);
+    }
+
+    // Snapshot the device counters before the plugin closes them
+    uint64_t delivered = 0, coalesced = 0, timeouts = 0, outputs = 0, vibrations = 0;
+    PollScheduleStats schedules[MAX_XBOX_CONTROLLERS];
+    for (int i = 0; i < g_options.controllers; i++) {
+        xbox_usb_get_poll_stats(i, &schedules[i]);
+        delivered += mock_usb_reports_delivered(devices[i]);
+        coalesced += mock_usb_reports_coalesced(devices[i]);
+        timeouts += mock_usb_transfers_timed_out(devices[i]);
+        outputs += mock_usb_outputs_sent(devices[i]) - outputs_before[i];
+        vibrations += readers[i].vibrations;
+    }
+    uint8_t last_output[64];
+    int last_output_length = mock_usb_last_output(devices[0], last_output, sizeof(last_output));
+
+    plugin_unload(0, NULL);
+    capture_stop();
+
+    NotifyStats notifications;
+    notify_get_stats(&notifications);
+
+    static const char* type_names[] = { "none", "360", "one", "switch" };
+    printf("pipeline: %d x %s, %u Hz reports, %u us latency, %u fps, %u samples/read, %u s\n",
+           g_options.controllers, type_names[g_options.type], g_options.report_hz,
+           g_options.latency_us, g_options.fps, g_options.samples, g_options.seconds);
+
+    uint64_t total_reads = 0, total_ns = 0;
+    for (int i = 0; i < g_options.controllers; i++) {
+        GameReader* reader = &readers[i];
+        total_reads += reader->reads;
+        total_ns += reader->read_ns;
+
+        qsort(reader->ages, reader->age_count, sizeof(uint32_t), compare_u32);
+        printf("  controller %d: %llu reads, %llu fresh, %llu reports skipped",
+               i, (unsigned long long)reader->reads, (unsigned long long)reader->fresh,
+               (unsigned long long)reader->skipped);
+        if (reader->sequenced) {
+            printf(", age p50 %u us, p99 %u us, max %u us",
+                   percentile(reader->ages, reader->age_count, 50),
+                   percentile(reader->ages, reader->age_count, 99),
+                   reader->age_count ? reader->ages[reader->age_count - 1] : 0);
+        }
+        printf("\n");
+        free(reader->ages);
+
+        const PollScheduleStats* schedule = &schedules[i];
+        if (schedule->transfers_queued) {
+            printf("    poll: %llu completions, device interval %u us, game read period %u us, %u transfers queued, %llu unchanged\n",
+                   (unsigned long long)schedule->polls, schedule->device_interval_us,
+                   schedule->read_period_us, schedule->transfers_queued,
+                   (unsigned long long)schedule->unchanged);
+        } else {
+            printf("    poll: %llu polls, device interval %u us, game read period %u us, poll period %u us, %llu unchanged\n",
+                   (unsigned long long)schedule->polls, schedule->device_interval_us,
+                   schedule->read_period_us, schedule->poll_period_us,
+                   (unsigned long long)schedule->unchanged);
+        }
+
+        LatencyStats stats;
+        if (latency_get_stats(i, &stats) == 0 && stats.published > 0) {
+            for (int l = 0; l < LATENCY_INTERVAL_COUNT; l++) {
+                const LatencyIntervalStats* interval = &stats.interval[l];
+                printf("    %-10s p50 %8llu ns  p99 %8llu ns  max %8llu ns  (%llu)\n", latency_interval_name((LatencyInterval)l),
+                       (unsigned long long)interval->p50_ns, (unsigned long long)interval->p99_ns,
+                       (unsigned long long)interval->max_ns, (unsigned long long)interval->count);
+            }
+        }
+    }
+
+    printf("  scePadRead hook: %.1f ns/call\n",
+           total_reads ? (double)total_ns / (double)total_reads : 0.0);
+    printf("  usb: %llu reports delivered (%.0f/s), %llu coalesced, %llu timeouts\n",
+           (unsigned long long)delivered, (double)delivered / g_options.seconds,
+           (unsigned long long)coalesced, (unsigned long long)timeouts);
+
+    printf("  rumble: %llu vibration calls, %llu OUT packets, last:",
+           (unsigned long long)vibrations, (unsigned long long)outputs);
+    for (int i = 0; i < last_output_length; i++) {
+        printf(" %02x", last_output[i]);
+    }
+    printf("\n");
+
+    printf("  notify: %u posted, %u shown, %u duplicates, %u dropped\n",
+           notifications.posted, notifications.sent, notifications.duplicates, notifications.dropped);
+
+    if (g_options.capture_path) {
+        printf("  capture: %s, %llu records dropped\n", g_options.capture_path,
+               (unsigned long long)capture_dropped());
+    }
+
+    if (g_options.dump_path && latency_dump(g_options.dump_path) != 0) {
+        fprintf(stderr, "pipeline: cannot write %s\n", g_options.dump_path);
+        return 1;
+    }
+
+    return 0;
+}
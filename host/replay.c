@@ -0,0 +1,521 @@
+/*
+ * Capture Replay Driver
+ *
+ * Feeds an XCAP capture recorded by the plugin (capture.h) back through
+ * the plugin code on the host:
+ *
+ *   translate - decode every record the way the poll thread does (GIP
+ *               engine for Xbox One packets) and run it through the
+ *               translators; prints ns/report and a hash of the DS4
+ *               states, and fails if the hash differs from -e
+ *   usb       - script each captured controller on a mock device with
+ *               the recorded timing and run the real polling engine and
+ *               scePadRead hook against it, reading at -f fps; checks
+ *               that the last state the game saw matches translate mode
+ *
+ * Both modes apply the profile the plugin would load (PROFILE_PATH, or
+ * -p in translate mode) for title -t; without the file they use defaults.
+ * Translate mode runs turbo and macros on the capture's own timeline,
+ * so their output hashes as deterministically as the rest.
+ *
+ * Usage: replay [-m translate|usb] [-n passes] [-e expected_hash] [-f fps]
+ *               [-p profile.ini] [-t title_id] [-v] capture.xcap
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <orbis/libkernel.h>
+#include <orbis/Pad.h>
+
+#include "config.h"
+#include "translator.h"
+#include "usb_xbox.h"
+#include "drivers.h"
+#include "profile.h"
+#include "turbo.h"
+#include "capture_file.h"
+#include "mock_sce.h"
+
+// Plugin entry points and hooks (not exported through headers)
+extern int32_t plugin_load(int32_t argc, const char* argv[]);
+extern int32_t plugin_unload(int32_t argc, const char* argv[]);
+extern int32_t scePadOpen_hook(int32_t userId, int32_t type, int32_t index, void* param);
+extern int32_t scePadClose_hook(int32_t handle);
+extern int32_t scePadRead_hook(int32_t handle, OrbisPadData* pData, int32_t num);
+
+#define FOREGROUND_USER     0x100
+#define FNV_OFFSET          0xcbf29ce484222325ull
+#define FNV_PRIME           0x100000001b3ull
+
+// ============================================
+// Options
+// ============================================
+
+typedef enum {
+    REPLAY_TRANSLATE = 0,
+    REPLAY_USB
+} ReplayMode;
+
+typedef struct {
+    ReplayMode  mode;
+    int         passes;
+    int         check_hash;
+    uint64_t    expected_hash;
+    uint32_t    fps;
+    const char* profile;
+    const char* title_id;
+    int         verbose;
+    const char* path;
+} ReplayOptions;
+
+static ReplayOptions g_options = {
+    .mode = REPLAY_TRANSLATE,
+    .passes = 1,
+    .check_hash = 0,
+    .expected_hash = 0,
+    .fps = 60,
+    .profile = PROFILE_PATH,
+    .title_id = "CUSA00000",
+    .verbose = 0,
+    .path = NULL,
+};
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [-m translate|usb] [-n passes] [-e expected_hash] [-f fps]\n"
+            "          [-p profile.ini] [-t title_id] [-v] capture.xcap\n",
+            argv0);
+}
+
+// ============================================
+// Capture in memory
+// ============================================
+
+typedef struct {
+    uint64_t time_us;
+    uint8_t  controller;
+    uint8_t  type;
+    uint8_t  length;
+    uint8_t  data[USB_ASYNC_BUFFER_SIZE];
+} ReplayRecord;
+
+typedef struct {
+    ReplayRecord* records;
+    int           count;
+    int           capacity;
+    int           controllers;      // Highest controller slot + 1
+    uint8_t       types[MAX_XBOX_CONTROLLERS];
+} Capture;
+
+static int capture_add(void* context, const CaptureRecord* record, uint64_t time_us,
+                       const uint8_t* data) {
+    Capture* capture = (Capture*)context;
+
+    if (record->controller >= MAX_XBOX_CONTROLLERS) {
+        return 0;
+    }
+    if (capture->count == capture->capacity) {
+        int capacity = capture->capacity ? capture->capacity * 2 : 4096;
+        ReplayRecord* records = realloc(capture->records, (size_t)capacity * sizeof(ReplayRecord));
+        if (records == NULL) {
+            return 1;
+        }
+        capture->records = records;
+        capture->capacity = capacity;
+    }
+
+    ReplayRecord* out = &capture->records[capture->count++];
+    out->time_us = time_us;
+    out->controller = record->controller;
+    out->type = record->type;
+    out->length = record->length < sizeof(out->data) ? record->length : (uint8_t)sizeof(out->data);
+    memcpy(out->data, data, out->length);
+
+    if (record->controller >= capture->controllers) {
+        capture->controllers = record->controller + 1;
+    }
+    capture->types[record->controller] = record->type;
+    return 0;
+}
+
+// ============================================
+// Translate mode
+// ============================================
+
+typedef struct {
+    DriverState   protocol;
+    XboxRawReport last_report;
+    int           have_report;
+    OrbisPadData  state;
+    TurboState    turbo;
+    uint64_t      translated;
+    uint64_t      ignored;          // Short reports and protocol packets
+} ReplayDecoder;
+
+static Profile g_profile;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t hash_state(uint64_t hash, const OrbisPadData* state) {
+    const uint8_t fields[] = {
+        (uint8_t)state->buttons, (uint8_t)(state->buttons >> 8),
+        (uint8_t)(state->buttons >> 16), (uint8_t)(state->buttons >> 24),
+        state->leftStick.x, state->leftStick.y, state->rightStick.x, state->rightStick.y,
+        state->analogButtons.l2, state->analogButtons.r2
+    };
+
+    for (size_t i = 0; i < sizeof(fields); i++) {
+        hash = (hash ^ fields[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/*
+ * Decode one record the way the poll thread would
+ * @return 1 if the DS4 state was (re)translated
+ */
+static int decode_record(ReplayDecoder* decoder, const ReplayRecord* record) {
+    const ControllerDriver* driver = driver_for_type((ControllerType)record->type);
+
+    if (driver == NULL) {
+        return 0;
+    }
+
+    switch (driver->decode(&decoder->protocol, record->data, record->length, record->time_us)) {
+        case DRIVER_DECODE_REPORT:
+            memcpy(&decoder->last_report, record->data, record->length);
+            decoder->have_report = 1;
+            break;
+        case DRIVER_DECODE_REPEAT:
+            if (!decoder->have_report) {
+                return 0;
+            }
+            break;
+        default:
+            return 0;
+    }
+
+    PadState pad;
+    driver->translate(&decoder->protocol, &g_profile.tables, &decoder->last_report, &pad);
+    if (turbo_enabled(&g_profile.turbo)) {
+        turbo_apply(&g_profile.turbo, &decoder->turbo, &pad, record->time_us);
+    }
+    pad_state_emit(&pad, &decoder->state);
+    return 1;
+}
+
+/*
+ * Decode the whole capture once
+ * @return Hash of every translated state, in record order
+ */
+static uint64_t translate_pass(const Capture* capture, ReplayDecoder* decoders) {
+    uint64_t hash = FNV_OFFSET;
+
+    memset(decoders, 0, sizeof(ReplayDecoder) * MAX_XBOX_CONTROLLERS);
+    for (int i = 0; i < MAX_XBOX_CONTROLLERS; i++) {
+        gip_reset(&decoders[i].protocol.gip);
+        turbo_reset(&decoders[i].turbo);
+    }
+
+    for (int r = 0; r < capture->count; r++) {
+        const ReplayRecord* record = &capture->records[r];
+        ReplayDecoder* decoder = &decoders[record->controller];
+
+        if (decode_record(decoder, record)) {
+            decoder->translated++;
+            hash = hash_state(hash, &decoder->state);
+        } else {
+            decoder->ignored++;
+        }
+    }
+    return hash;
+}
+
+static int run_translate(const Capture* capture, ReplayDecoder* decoders) {
+    uint64_t hash = 0;
+    uint64_t best_ns = UINT64_MAX;
+
+    for (int pass = 0; pass < g_options.passes; pass++) {
+        uint64_t t0 = now_ns();
+        hash = translate_pass(capture, decoders);
+        uint64_t elapsed = now_ns() - t0;
+        if (elapsed < best_ns) {
+            best_ns = elapsed;
+        }
+    }
+
+    uint64_t translated = 0;
+    for (int i = 0; i < capture->controllers; i++) {
+        const ReplayDecoder* decoder = &decoders[i];
+        translated += decoder->translated;
+        const GipState* gip = &decoder->protocol.gip;
+        printf("  controller %d: %llu translated, %llu ignored, %llu duplicate, %llu stale\n",
+               i, (unsigned long long)decoder->translated, (unsigned long long)decoder->ignored,
+               (unsigned long long)gip->duplicates, (unsigned long long)gip->stale);
+    }
+
+    printf("  translate: %.1f ns/report (best of %d)\n",
+           translated ? (double)best_ns / (double)translated : 0.0, g_options.passes);
+    printf("  hash: %016llx\n", (unsigned long long)hash);
+
+    if (g_options.check_hash && hash != g_options.expected_hash) {
+        fprintf(stderr, "replay: hash mismatch, expected %016llx\n",
+                (unsigned long long)g_options.expected_hash);
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================
+// USB mode
+// ============================================
+
+static void device_ids(ControllerType type, uint16_t* vendor_id, uint16_t* product_id) {
+    switch (type) {
+        case CONTROLLER_XBOXONE:
+            *vendor_id = 0x045E;
+            *product_id = 0x02EA;
+            break;
+        case CONTROLLER_SWITCH:
+            *vendor_id = SWITCH_ROCKCAND_VID;
+            *product_id = SWITCH_ROCKCANDY_PID;
+            break;
+        default:
+            *vendor_id = 0x045E;
+            *product_id = 0x028E;
+            break;
+    }
+}
+
+/*
+ * A turbo button held at the end is in whatever phase the wall clock
+ * left it, so only the other buttons are compared
+ */
+static int same_state(const OrbisPadData* a, const OrbisPadData* b) {
+    uint32_t buttons = ~g_profile.turbo.turbo_mask;
+
+    return (a->buttons & buttons) == (b->buttons & buttons) &&
+           a->leftStick.x == b->leftStick.x && a->leftStick.y == b->leftStick.y &&
+           a->rightStick.x == b->rightStick.x && a->rightStick.y == b->rightStick.y &&
+           a->analogButtons.l2 == b->analogButtons.l2 && a->analogButtons.r2 == b->analogButtons.r2;
+}
+
+static int run_usb(const Capture* capture, const ReplayDecoder* decoders) {
+    int controllers = capture->controllers;
+
+    int32_t users[1 + MAX_XBOX_CONTROLLERS];
+    for (int i = 0; i <= controllers; i++) {
+        users[i] = FOREGROUND_USER + i;
+    }
+    mock_user_set_logins(users, controllers + 1);
+
+    // Each device replays its own records with the recorded spacing
+    MockUsbDevice* devices[MAX_XBOX_CONTROLLERS];
+    for (int i = 0; i < controllers; i++) {
+        uint16_t vendor_id, product_id;
+        device_ids((ControllerType)capture->types[i], &vendor_id, &product_id);
+        devices[i] = mock_usb_attach(vendor_id, product_id);
+        if (devices[i] == NULL) {
+            fprintf(stderr, "replay: mock bus full\n");
+            return 1;
+        }
+        if (capture->types[i] == CONTROLLER_XBOXONE) {
+            mock_usb_set_endpoints(devices[i], 0x82, 0x02);
+        }
+
+        uint64_t last_us = 0;
+        for (int r = 0; r < capture->count; r++) {
+            const ReplayRecord* record = &capture->records[r];
+            if (record->controller != i || record->length == 0) {
+                continue;
+            }
+            if (mock_usb_script_report(devices[i], record->data, record->length,
+                                       (uint32_t)(record->time_us - last_us)) < 0) {
+                fprintf(stderr, "replay: mock script full\n");
+                return 1;
+            }
+            last_us = record->time_us;
+        }
+    }
+
+    if (plugin_load(0, NULL) != 0) {
+        fprintf(stderr, "replay: plugin_load failed\n");
+        return 1;
+    }
+
+    uint64_t deadline = sceKernelGetProcessTime() + 2000000ull + HOTPLUG_SCAN_INTERVAL_US;
+    while (xbox_usb_get_controller_count() < controllers) {
+        if (sceKernelGetProcessTime() > deadline) {
+            fprintf(stderr, "replay: only %d of %d controllers connected\n",
+                    xbox_usb_get_controller_count(), controllers);
+            plugin_unload(0, NULL);
+            return 1;
+        }
+        sceKernelUsleep(1000);
+    }
+
+    int32_t handles[MAX_XBOX_CONTROLLERS];
+    for (int i = 0; i < controllers; i++) {
+        handles[i] = scePadOpen_hook(users[i + 1], 0, 0, NULL);
+    }
+    for (int i = 0; i < controllers; i++) {
+        mock_usb_script_start(devices[i], 0);
+    }
+
+    // Play the game until the capture is over, plus time to drain
+    uint64_t duration_us = capture->count ? capture->records[capture->count - 1].time_us : 0;
+    uint64_t frame_us = 1000000ull / g_options.fps;
+    uint64_t start = sceKernelGetProcessTime();
+    uint64_t end = start + duration_us + 100000ull;
+    uint64_t next_frame = start;
+
+    OrbisPadData last[MAX_XBOX_CONTROLLERS];
+    uint64_t reads[MAX_XBOX_CONTROLLERS] = { 0 };
+    uint64_t fresh[MAX_XBOX_CONTROLLERS] = { 0 };
+    uint64_t last_timestamp[MAX_XBOX_CONTROLLERS] = { 0 };
+    memset(last, 0, sizeof(last));
+
+    while (sceKernelGetProcessTime() < end) {
+        for (int i = 0; i < controllers; i++) {
+            OrbisPadData samples[PAD_HISTORY_SAMPLES];
+            int32_t ret = scePadRead_hook(handles[i], samples, 1);
+            reads[i]++;
+            if (ret > 0) {
+                last[i] = samples[0];
+                if (samples[0].timestamp != last_timestamp[i]) {
+                    last_timestamp[i] = samples[0].timestamp;
+                    fresh[i]++;
+                }
+            }
+        }
+
+        next_frame += frame_us;
+        uint64_t now = sceKernelGetProcessTime();
+        if (next_frame > now) {
+            sceKernelUsleep((unsigned int)(next_frame - now));
+        }
+    }
+
+    uint64_t delivered = 0, coalesced = 0;
+    for (int i = 0; i < controllers; i++) {
+        scePadClose_hook(handles[i]);
+        delivered += mock_usb_reports_delivered(devices[i]);
+        coalesced += mock_usb_reports_coalesced(devices[i]);
+    }
+
+    plugin_unload(0, NULL);
+
+    int mismatches = 0;
+    for (int i = 0; i < controllers; i++) {
+        int match = !decoders[i].translated || same_state(&last[i], &decoders[i].state);
+        mismatches += !match;
+        printf("  controller %d: %llu reads, %llu fresh, final state %s\n",
+               i, (unsigned long long)reads[i], (unsigned long long)fresh[i],
+               match ? "matches" : "DIFFERS");
+    }
+    printf("  usb: %llu reports delivered, %llu coalesced, over %.2f s\n",
+           (unsigned long long)delivered, (unsigned long long)coalesced,
+           (double)duration_us / 1000000.0);
+
+    return mismatches ? 1 : 0;
+}
+
+// ============================================
+// Main
+// ============================================
+
+int main(int argc, char* argv[]) {
+    int opt;
+    while ((opt = getopt(argc, argv, "m:n:e:f:p:t:vh")) != -1) {
+        switch (opt) {
+            case 'n': g_options.passes = atoi(optarg); break;
+            case 'f': g_options.fps = (uint32_t)atoi(optarg); break;
+            case 'p': g_options.profile = optarg; break;
+            case 't': g_options.title_id = optarg; break;
+            case 'v': g_options.verbose = 1; break;
+            case 'e':
+                g_options.expected_hash = strtoull(optarg, NULL, 16);
+                g_options.check_hash = 1;
+                break;
+            case 'm':
+                if (strcmp(optarg, "translate") == 0) {
+                    g_options.mode = REPLAY_TRANSLATE;
+                    break;
+                }
+                if (strcmp(optarg, "usb") == 0) {
+                    g_options.mode = REPLAY_USB;
+                    break;
+                }
+                /* fall through */
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    // The plugin under test always reads PROFILE_PATH
+    int other_profile = strcmp(g_options.profile, PROFILE_PATH) != 0;
+    if (optind != argc - 1 || g_options.passes < 1 || g_options.fps == 0 ||
+        (g_options.mode == REPLAY_USB && other_profile)) {
+        usage(argv[0]);
+        return 2;
+    }
+    g_options.path = argv[optind];
+
+    mock_set_verbose(g_options.verbose);
+    mock_set_title_id(g_options.title_id);
+
+    ProfileSettings settings;
+    int title_section = 0;
+    int skipped = profile_parse(g_options.profile, g_options.title_id, &settings, &title_section);
+    if (skipped < 0 && other_profile) {
+        fprintf(stderr, "replay: %s cannot be opened\n", g_options.profile);
+        return 1;
+    }
+    profile_compile(&settings, &g_profile);
+    if (skipped >= 0) {
+        printf("profile: %s [%s], %d lines skipped, poll %u us, %d turbo, %d macros\n", g_options.profile,
+               title_section ? g_options.title_id : "default", skipped, g_profile.poll_interval_us,
+               g_profile.turbo.rule_count, g_profile.turbo.macro_count);
+    }
+
+    Capture capture;
+    memset(&capture, 0, sizeof(capture));
+    int ret = capture_file_load(g_options.path, capture_add, &capture);
+    if (ret < 0) {
+        fprintf(stderr, "replay: %s %s\n", g_options.path,
+                ret == -1 ? "cannot be opened" : "is not a capture");
+        return 1;
+    }
+    if (capture.count == 0) {
+        fprintf(stderr, "replay: %s holds no records\n", g_options.path);
+        return 1;
+    }
+
+    static const char* type_names[] = { "none", "360", "one", "switch" };
+    printf("replay: %s, %d records, %.2f s\n", g_options.path, capture.count,
+           (double)capture.records[capture.count - 1].time_us / 1000000.0);
+    for (int i = 0; i < capture.controllers; i++) {
+        printf("  controller %d: %s\n", i,
+               capture.types[i] < 4 ? type_names[capture.types[i]] : "unknown");
+    }
+
+    // USB mode compares against the translated result, so always translate first
+    ReplayDecoder decoders[MAX_XBOX_CONTROLLERS];
+    int result = run_translate(&capture, decoders);
+    if (result == 0 && g_options.mode == REPLAY_USB) {
+        result = run_usb(&capture, decoders);
+    }
+
+    free(capture.records);
+    return result;
+}
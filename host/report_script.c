@@ -0,0 +1,87 @@
+/*
+ * Report Script Files Implementation
+ */
+
+#include "report_script.h"
+#include "capture_file.h"
+
+#include <stdio.h>
+
+#define MAX_SCRIPT_LINE 512
+
+static int parse_hex(const char* text, uint8_t* data, int max_length) {
+    int length = 0;
+    unsigned int byte;
+    int consumed;
+
+    while (length < max_length && sscanf(text, " %2x%n", &byte, &consumed) == 1) {
+        data[length++] = (uint8_t)byte;
+        text += consumed;
+    }
+    return length;
+}
+
+typedef struct {
+    ReportScriptCallback callback;
+    void*                context;
+    int                  controller;    // First controller seen, -1 before any
+    uint64_t             last_us;
+    int                  count;
+} CaptureAdapter;
+
+static int capture_to_script(void* context, const CaptureRecord* record, uint64_t time_us,
+                             const uint8_t* data) {
+    CaptureAdapter* adapter = (CaptureAdapter*)context;
+
+    if (adapter->controller < 0) {
+        adapter->controller = record->controller;
+        adapter->last_us = time_us;
+    }
+    if (record->controller != adapter->controller || record->length == 0) {
+        return 0;
+    }
+
+    int length = record->length < REPORT_SCRIPT_MAX_REPORT ? record->length : REPORT_SCRIPT_MAX_REPORT;
+    uint32_t delay = (uint32_t)(time_us - adapter->last_us);
+    adapter->last_us = time_us;
+    adapter->count++;
+    return adapter->callback(adapter->context, delay, data, length);
+}
+
+int report_script_load(const char* path, ReportScriptCallback callback, void* context) {
+    if (capture_file_detect(path)) {
+        CaptureAdapter adapter = { callback, context, -1, 0, 0 };
+        int ret = capture_file_load(path, capture_to_script, &adapter);
+        return ret < 0 ? ret : adapter.count;
+    }
+
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    char line[MAX_SCRIPT_LINE];
+    int count = 0;
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long delay;
+        int consumed;
+        uint8_t data[REPORT_SCRIPT_MAX_REPORT];
+
+        if (line[0] == '#' || sscanf(line, "%lu%n", &delay, &consumed) != 1) {
+            continue;
+        }
+
+        int length = parse_hex(line + consumed, data, (int)sizeof(data));
+        if (length <= 0) {
+            continue;
+        }
+
+        count++;
+        if (callback(context, (uint32_t)delay, data, length) != 0) {
+            break;
+        }
+    }
+
+    fclose(file);
+    return count;
+}
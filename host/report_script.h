@@ -0,0 +1,35 @@
+/*
+ * Report Script Files
+ * Text streams of USB input reports, one per line:
+ *
+ *     <delay_us> <hex bytes>
+ *
+ * Blank lines and lines starting with '#' are ignored. Used by the
+ * pipeline harness to script mock devices and by the benchmarks as
+ * recorded report streams.
+ *
+ * XCAP captures (capture.h) are accepted in place of a script: the
+ * reports of the first controller in the capture are passed on, each
+ * with its delay since that controller's previous report.
+ */
+
+#ifndef REPORT_SCRIPT_H
+#define REPORT_SCRIPT_H
+
+#include <stdint.h>
+
+#define REPORT_SCRIPT_MAX_REPORT 64
+
+/*
+ * Called for every report in the file
+ * @return 0 to continue, nonzero to stop reading
+ */
+typedef int (*ReportScriptCallback)(void* context, uint32_t delay_us, const uint8_t* data, int length);
+
+/*
+ * Read a report script
+ * @return Number of reports passed to the callback, negative if the file cannot be opened
+ */
+int report_script_load(const char* path, ReportScriptCallback callback, void* context);
+
+#endif // REPORT_SCRIPT_H
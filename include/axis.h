@@ -0,0 +1,118 @@
+/*
+ * Analog Stick Processing
+ * Deadzones and response curves for the 8-bit DS4 stick axes.
+ *
+ * Everything configurable is folded into lookup tables when the
+ * configuration is compiled: inversion, deadzone and curve for each
+ * axis, and for the radial modes a gain table indexed by the squared
+ * stick magnitude. Per report a stick costs two byte loads (axial) or
+ * two byte loads, one gain load and a few multiplies (radial), with no
+ * division and no floating point.
+ */
+
+#ifndef AXIS_H
+#define AXIS_H
+
+#include <stdint.h>
+
+/*
+ * Deadzone shape
+ */
+typedef enum {
+    AXIS_DEADZONE_AXIAL = 0,        // Each axis on its own (square deadzone)
+    AXIS_DEADZONE_RADIAL,           // Stick magnitude, travel outside is unchanged
+    AXIS_DEADZONE_SCALED_RADIAL     // Stick magnitude, travel outside rescaled to full range
+} AxisDeadzoneMode;
+
+/*
+ * Response curve applied to the travel outside the deadzone
+ */
+typedef enum {
+    AXIS_CURVE_LINEAR = 0,
+    AXIS_CURVE_EXPONENTIAL,         // out = in ^ exponent
+    AXIS_CURVE_CUSTOM               // Piecewise linear through curve points
+} AxisCurveType;
+
+// Custom curve points at 0/8, 1/8, ... 8/8 of the travel (values 0-127)
+#define AXIS_CURVE_POINTS   9
+
+// Radial gain table, indexed by squared magnitude >> 3 (128^2 * 2 >> 3)
+#define AXIS_RADIAL_SHIFT   3
+#define AXIS_RADIAL_ENTRIES ((128 * 128 * 2 >> AXIS_RADIAL_SHIFT) + 1)
+#define AXIS_GAIN_BITS      12      // Gain is Q12: 4096 = unchanged
+
+/*
+ * Stick processing settings
+ */
+typedef struct {
+    AxisDeadzoneMode mode;
+    uint8_t          deadzone;                      // 0-127
+    AxisCurveType    curve;
+    float            exponent;                      // AXIS_CURVE_EXPONENTIAL
+    uint8_t          points[AXIS_CURVE_POINTS];     // AXIS_CURVE_CUSTOM
+} AxisConfig;
+
+/*
+ * Per-axis tables of one stick
+ * Axial mode: final output. Radial modes: input with inversion applied.
+ */
+typedef struct {
+    uint8_t x[256];
+    uint8_t y[256];
+} AxisStickTable;
+
+/*
+ * Compiled stick processing for both sticks
+ */
+typedef struct {
+    AxisDeadzoneMode mode;
+    AxisStickTable   left;
+    AxisStickTable   right;
+} AxisTable;
+
+// Compile-time defaults: axial DEFAULT_STICK_DEADZONE, linear
+extern const AxisTable g_axis_default;              // Y axes inverted (Xbox)
+extern const AxisTable g_axis_default_noninverted;  // Y axes as reported (Switch)
+
+/*
+ * Compile stick settings into tables
+ * @param table         Output per-axis tables
+ * @param radial_gain   Output gain table of AXIS_RADIAL_ENTRIES, filled
+ *                      for the radial modes only (may be NULL if axial)
+ * @param config        Stick settings
+ * @param invert_left_y Invert left stick Y axis
+ * @param invert_right_y Invert right stick Y axis
+ */
+void axis_build(AxisTable* table, uint16_t* radial_gain, const AxisConfig* config,
+                int invert_left_y, int invert_right_y);
+
+/*
+ * Process one stick
+ * @param table         Compiled tables (mode)
+ * @param stick         Tables of this stick
+ * @param radial_gain   Gain table from axis_build (unused in axial mode)
+ * @param x, y          Raw 8-bit axes (center = 128)
+ * @param out_x, out_y  Processed axes
+ */
+static inline void axis_apply(const AxisTable* table, const AxisStickTable* stick,
+                              const uint16_t* radial_gain, uint8_t x, uint8_t y,
+                              uint8_t* out_x, uint8_t* out_y) {
+    if (table->mode == AXIS_DEADZONE_AXIAL) {
+        *out_x = stick->x[x];
+        *out_y = stick->y[y];
+        return;
+    }
+
+    int32_t cx = (int32_t)stick->x[x] - 128;
+    int32_t cy = (int32_t)stick->y[y] - 128;
+    int32_t gain = radial_gain[(uint32_t)(cx * cx + cy * cy) >> AXIS_RADIAL_SHIFT];
+
+    // Divide by a power of two: compiles to shifts, rounds toward zero
+    int32_t ox = 128 + cx * gain / (1 << AXIS_GAIN_BITS);
+    int32_t oy = 128 + cy * gain / (1 << AXIS_GAIN_BITS);
+
+    *out_x = (uint8_t)(ox < 0 ? 0 : (ox > 255 ? 255 : ox));
+    *out_y = (uint8_t)(oy < 0 ? 0 : (oy > 255 ? 255 : oy));
+}
+
+#endif // AXIS_H
@@ -0,0 +1,92 @@
+/*
+ * Raw Report Capture
+ *
+ * Streams every IN transfer the poll thread receives to an XCAP file,
+ * so a real session can be replayed on the host (host/replay.c) against
+ * the translators and the mock USB layer.
+ *
+ * The poll thread only copies the record into a preallocated ring; a
+ * background thread drains it to the file in batches. A full ring drops
+ * records (counted) rather than stall the poller, and the hooks never
+ * touch the capture at all.
+ *
+ * File layout (little-endian, packed):
+ *
+ *     CaptureFileHeader
+ *     { CaptureRecord, data[length] } ...
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "config.h"
+#include <stdint.h>
+
+#define CAPTURE_MAGIC           "XCAP"
+#define CAPTURE_VERSION         1
+
+/*
+ * File header (16 bytes)
+ */
+typedef struct __attribute__((packed)) {
+    char     magic[4];          // "XCAP"
+    uint16_t version;           // CAPTURE_VERSION
+    uint16_t header_size;       // sizeof(CaptureFileHeader)
+    uint64_t start_us;          // Capture start (sceKernelGetProcessTime)
+} CaptureFileHeader;
+
+/*
+ * Record header (8 bytes), followed by `length` bytes of report
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t delta_us;          // Time since the previous record (any controller)
+    uint8_t  controller;        // Controller slot
+    uint8_t  type;              // ControllerType
+    uint8_t  length;            // Transfer length
+    uint8_t  reserved;
+} CaptureRecord;
+
+/*
+ * Ring shared by the poll thread (producer) and the writer thread
+ */
+typedef struct {
+    volatile uint64_t head;     // Bytes produced
+    volatile uint64_t tail;     // Bytes written to the file
+    uint64_t          last_us;  // Time of the previous record (producer)
+    volatile uint64_t dropped;  // Records lost to a full ring
+    uint8_t           data[CAPTURE_RING_BYTES];
+} CaptureRing;
+
+extern volatile int g_capture_active;
+
+/*
+ * Open the capture file and start the writer thread
+ * @return 0 on success, negative on error
+ */
+int capture_start(const char* path);
+
+/*
+ * Stop the writer thread, flush what is left and close the file
+ */
+void capture_stop(void);
+
+/*
+ * Append a record (poll thread only, never blocks)
+ */
+void capture_write(int controller, int type, const uint8_t* data, int32_t length);
+
+/*
+ * Record one received transfer if a capture is running
+ */
+static inline void capture_report(int controller, int type, const uint8_t* data, int32_t length) {
+    if (g_capture_active) {
+        capture_write(controller, type, data, length);
+    }
+}
+
+/*
+ * Records dropped because the writer fell behind
+ */
+uint64_t capture_dropped(void);
+
+#endif // CAPTURE_H
@@ -31,18 +31,92 @@
 #define VIRTUAL_USER_BASE       0x20000000  // Virtual user ID base
 
 // Timing
-#define USB_POLL_INTERVAL_US    4000    // 4ms = 250Hz polling rate
-#define USB_TRANSFER_TIMEOUT_MS 16      // USB transfer timeout
+#define USB_POLL_TIMEOUT_MS     2       // Input transfer timeout on the poll thread
+#define USB_TRANSFER_TIMEOUT_MS 16      // USB transfer timeout (control/output)
+#define HOTPLUG_SCAN_INTERVAL_US 250000 // Hot-plug device list diff every 250ms
+
+// Asynchronous input transfers (see usb_async.h)
+#define USB_ASYNC_TRANSFERS     3       // IN transfers kept queued per controller
+#define USB_ASYNC_BUFFER_SIZE   64      // Bytes per IN transfer (largest report)
+#define USB_ASYNC_STOP_WAIT_MS  100     // Longest wait for cancelled transfers on close
+
+// Rumble output: newest value wins, at most one OUT transfer per USB frame
+#define RUMBLE_MIN_INTERVAL_US  1000
+
+// Xbox One GIP protocol (see gip.h)
+#define GIP_STALE_WINDOW        16      // Packets this far behind the last sequence are dropped
+#define GIP_POWER_ON_RETRY_US   1000000 // Resend power on while the pad stays silent
+
+// Samples kept per controller for scePadRead (power of two)
+#define PAD_HISTORY_SAMPLES     64
+
+// Poll scheduling (see poll_sched.h)
+#define POLL_SAMPLES_PER_READ   4       // Device polls per game read while the game reads
+#define POLL_LEAD_US            500     // Margin before a predicted read for the last poll
+#define POLL_IDLE_AFTER_US      500000  // No game read for this long = idle
+#define POLL_IDLE_INTERVAL_US   16000   // Poll period while idle (also bounds hot-plug latency)
 
 // Deadzone defaults (0-127 range, applied to 0-128 half-axis)
 #define DEFAULT_STICK_DEADZONE  15      // ~12% deadzone
 #define DEFAULT_TRIGGER_THRESHOLD 30    // Digital trigger activation point
 
+// Per-title profiles (see profile.h)
+#ifndef PROFILE_PATH
+#define PROFILE_PATH            "/data/GoldHEN/xbox_controller.ini"
+#endif
+#define PROFILE_MAX_POLL_RATE_HZ 1000   // poll_rate_hz upper bound (one full-speed frame)
+#ifndef PROFILE_WATCH
+#define PROFILE_WATCH           1       // Set to 0 to read the profile at load only
+#endif
+#define PROFILE_WATCH_INTERVAL_US 1000000   // How often the file is checked for changes
+#define PROFILE_GRACE_POLL_US   1000    // Reload waiting for the reader to pass a quiescent point
+
+// Turbo and macros (see turbo.h)
+#define TURBO_MAX_HZ            30      // Faster than half a 60 fps frame per phase is lost
+#define MACRO_FRAME_US          16667   // One macro frame (60 fps)
+#define TURBO_MAX_STEP_FRAMES   60      // Longest macro step
+
+// User routing (see user_router.h)
+#define USER_ROUTER_INTERVAL_US 100000  // Login list and foreground user checked this often
+
+// Latency instrumentation (per-stage timestamps and histograms)
+#ifndef LATENCY_TRACKING
+#define LATENCY_TRACKING        1       // Set to 0 to compile the probes out
+#endif
+#ifndef LATENCY_DUMP_PATH
+#define LATENCY_DUMP_PATH       "/data/GoldHEN/xbox_controller_latency.txt"
+#endif
+#ifndef LATENCY_DUMP_REQUEST_PATH
+#define LATENCY_DUMP_REQUEST_PATH "/data/GoldHEN/xbox_controller_latency.req"   // Create to dump while running
+#endif
+
+// Raw report capture for host replay (see capture.h)
+#ifndef REPORT_CAPTURE
+#define REPORT_CAPTURE          0       // Set to 1 to record every session
+#endif
+#define CAPTURE_PATH            "/data/GoldHEN/xbox_controller_capture.xcap"
+#define CAPTURE_RING_BYTES      65536   // Power of two; ~0.5s of 4 pads at 1kHz
+#define CAPTURE_FLUSH_INTERVAL_US 100000
+
+// Notification queue (see notify.h)
+#define NOTIFY_QUEUE_SIZE       16      // Pending messages (power of two)
+#define NOTIFY_MESSAGE_SIZE     60      // Bytes per message, NUL included (cell = 64)
+#define NOTIFY_DRAIN_INTERVAL_US 100000 // Drain thread period
+#define NOTIFY_MIN_INTERVAL_US  1000000 // At most one toast per second
+#define NOTIFY_DEDUP_US         5000000 // Same text again within this is skipped
+
+// SSE2 DS4 emitter (see pad_state.h); the portable one is used without SSE2
+#ifndef PAD_STATE_SIMD
+#define PAD_STATE_SIMD          1       // Set to 0 to force the portable emitter
+#endif
+
 // Debug
+#ifndef DEBUG_NOTIFICATIONS
 #define DEBUG_NOTIFICATIONS     0       // Set to 1 for verbose notifications
+#endif
 
-// Helper macros
-#define IS_VIRTUAL_HANDLE(h)    ((h) >= VIRTUAL_HANDLE_BASE && (h) < VIRTUAL_HANDLE_BASE + MAX_XBOX_CONTROLLERS)
+// Helper macros (unsigned compare: one branch covers both range bounds)
+#define IS_VIRTUAL_HANDLE(h)    ((unsigned)(h) - (unsigned)VIRTUAL_HANDLE_BASE < MAX_XBOX_CONTROLLERS)
 #define HANDLE_TO_INDEX(h)      ((h) - VIRTUAL_HANDLE_BASE)
 #define INDEX_TO_HANDLE(i)      ((i) + VIRTUAL_HANDLE_BASE)
 
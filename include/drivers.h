@@ -0,0 +1,138 @@
+/*
+ * Controller Driver Registry
+ *
+ * Each supported pad family is one ControllerDriver: default endpoints,
+ * init sequence, report decoder, translator, rumble packet builder.
+ * The polling engine only talks to controllers through these hooks, so
+ * a new pad (8BitDo, PowerA, Hori...) is a driver plus one DRIVER_ID
+ * line per VID/PID in drivers.c.
+ *
+ * VID/PID lookup is a perfect hash: the table is built at compile time
+ * with designated initializers indexed by DRIVER_HASH, so a lookup is
+ * one multiply, one load and one compare. Two IDs that hash to the same
+ * slot are a build error (-Werror=override-init); pick another
+ * DRIVER_HASH_MULTIPLIER or widen DRIVER_HASH_BITS if that happens.
+ */
+
+#ifndef DRIVERS_H
+#define DRIVERS_H
+
+#include "usb_xbox.h"
+#include "gip.h"
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DRIVER_HASH_BITS        5
+#define DRIVER_HASH_SIZE        (1 << DRIVER_HASH_BITS)
+#define DRIVER_HASH_MULTIPLIER  0x9E3779B1u
+
+#define DRIVER_CONTROL_QUEUE    4       // Protocol packets waiting for the OUT endpoint
+
+#define DRIVER_HASH(vid, pid) \
+    ((((uint32_t)(vid) << 16 | (uint32_t)(pid)) * DRIVER_HASH_MULTIPLIER) >> (32 - DRIVER_HASH_BITS))
+
+/*
+ * Protocol state a driver keeps per controller (poll thread only)
+ */
+typedef struct {
+    GipState  gip;              // GIP pads: sequence tracking, Guide, power on
+    GipPacket control[DRIVER_CONTROL_QUEUE];    // Waiting for the OUT endpoint, oldest first
+    int       control_count;
+} DriverState;
+
+/*
+ * Queue a protocol packet behind the ones not sent yet
+ * Several transfers can complete in one event loop pass, so a reply
+ * must not replace an earlier one (an ACK would drop a power on).
+ * @return 0 if queued, -1 if the queue is full and the packet dropped
+ */
+static inline int driver_queue_control(DriverState* state, const GipPacket* packet) {
+    if (state->control_count == DRIVER_CONTROL_QUEUE) {
+        return -1;
+    }
+    state->control[state->control_count++] = *packet;
+    return 0;
+}
+
+// Remove the oldest queued packet once it has been sent
+static inline void driver_pop_control(DriverState* state) {
+    state->control_count--;
+    memmove(&state->control[0], &state->control[1], sizeof(GipPacket) * (size_t)state->control_count);
+}
+
+/*
+ * What the engine should publish after a received transfer
+ */
+typedef enum {
+    DRIVER_DECODE_NONE = 0,     // Nothing (protocol packet, bad report)
+    DRIVER_DECODE_REPORT,       // The transfer is a new input report
+    DRIVER_DECODE_REPEAT        // Input state outside the report changed: republish the last one
+} DriverDecodeResult;
+
+typedef struct {
+    const char*     name;           // Shown when the pad connects
+    ControllerType  type;
+    uint8_t         endpoint_in;    // Used when the descriptor is unreadable
+    uint8_t         endpoint_out;
+    uint8_t         compare_offset; // Leading report bytes that change without input changing
+
+    /*
+     * Init sequence sent once after open (NULL: none)
+     * @param init      Set to the packet to send; length 0 for none
+     */
+    void (*start)(DriverState* state, uint64_t now, GipPacket* init);
+
+    /*
+     * Classify one received transfer, queueing replies with driver_queue_control
+     */
+    DriverDecodeResult (*decode)(DriverState* state, const uint8_t* data, int32_t length, uint64_t now);
+
+    /*
+     * Decode a report decode() accepted into the normalized state
+     * @param tables    Compiled configuration (or NULL for defaults)
+     */
+    void (*translate)(const DriverState* state, const TranslatorTables* tables, const XboxRawReport* report,
+                      PadState* out);
+
+    /*
+     * Build the OUT packet for a motor pair (NULL: no motors)
+     * @return Packet length
+     */
+    int (*rumble)(DriverState* state, uint8_t left, uint8_t right, uint8_t* packet);
+
+    /*
+     * Queue a protocol packet if one is due (NULL: none)
+     */
+    void (*keepalive)(DriverState* state, uint64_t now);
+} ControllerDriver;
+
+/*
+ * Hash table entry
+ */
+typedef struct {
+    uint16_t                vendor_id;
+    uint16_t                product_id;
+    const ControllerDriver* driver;
+} DriverId;
+
+extern const DriverId g_driver_ids[DRIVER_HASH_SIZE];
+
+/*
+ * Find the driver for a USB device
+ * @return Driver, NULL if the device is not supported
+ */
+static inline const ControllerDriver* driver_lookup(uint16_t vid, uint16_t pid) {
+    const DriverId* id = &g_driver_ids[DRIVER_HASH(vid, pid)];
+
+    return (id->vendor_id == vid && id->product_id == pid) ? id->driver : NULL;
+}
+
+/*
+ * Find the driver for a controller type (captures store the type only)
+ * @return Driver, NULL for CONTROLLER_NONE or an unknown type
+ */
+const ControllerDriver* driver_for_type(ControllerType type);
+
+#endif // DRIVERS_H
@@ -0,0 +1,114 @@
+/*
+ * Xbox One Gaming Input Protocol (GIP) Engine
+ *
+ * Every packet on an Xbox One/Series interrupt endpoint starts with a
+ * 4-byte header: command, flags, sequence number, payload length. The
+ * input report (0x20) is only one command; the Guide button (0x07),
+ * announce (0x02) and status (0x03) packets arrive on the same pipe.
+ *
+ * gip_receive() dispatches a packet through a 256-entry handler table,
+ * drops duplicate and stale packets by per-command sequence number and
+ * tells the caller what to publish and what to send back (ACKs, power
+ * on after an announce). All state lives in GipState: no allocation,
+ * no locking, poll thread only.
+ */
+
+#ifndef GIP_H
+#define GIP_H
+
+#include "config.h"
+#include <stdint.h>
+
+/*
+ * GIP commands
+ */
+#define GIP_CMD_ACK             0x01
+#define GIP_CMD_ANNOUNCE        0x02
+#define GIP_CMD_STATUS          0x03
+#define GIP_CMD_POWER           0x05
+#define GIP_CMD_GUIDE           0x07
+#define GIP_CMD_RUMBLE          0x09
+#define GIP_CMD_INPUT           0x20
+
+/*
+ * Header flags
+ */
+#define GIP_FLAG_ACK            0x10    // Sender wants an ACK
+#define GIP_FLAG_INTERNAL       0x20    // System command
+
+#define GIP_HEADER_SIZE         4
+#define GIP_PACKET_MAX          16      // Largest packet the host sends
+
+/*
+ * What the caller should do with a received packet
+ */
+typedef enum {
+    GIP_RESULT_NONE = 0,        // Nothing to publish
+    GIP_RESULT_INPUT,           // New input report: translate and publish it
+    GIP_RESULT_GUIDE,           // Guide changed: republish the last input
+    GIP_RESULT_ANNOUNCE         // Controller (re)started: input reports stop until powered on
+} GipResult;
+
+/*
+ * Packet for the OUT endpoint
+ */
+typedef struct {
+    uint8_t data[GIP_PACKET_MAX];
+    int     length;             // 0 = nothing to send
+} GipPacket;
+
+/*
+ * Protocol state of one controller
+ */
+typedef struct {
+    uint8_t  last_sequence[256];    // Per command
+    uint8_t  seen[256 / 8];         // Commands with a valid last_sequence
+    uint8_t  out_sequence;          // Next host packet sequence number
+    uint8_t  guide;                 // Guide button held
+    int      answered;              // Any packet since the last power on
+    uint64_t power_on_us;           // Last power on command sent
+
+    // Diagnostics
+    uint32_t duplicates;
+    uint32_t stale;
+    uint32_t acks;
+    uint32_t power_ons;
+} GipState;
+
+/*
+ * Reset for a newly opened controller
+ */
+void gip_reset(GipState* gip);
+
+/*
+ * Build the power on command that starts input reports
+ */
+void gip_power_on(GipState* gip, uint64_t now, GipPacket* out);
+
+/*
+ * Dispatch one received packet
+ * @param reply     Set to an ACK or power on packet when one is due
+ */
+GipResult gip_receive(GipState* gip, const uint8_t* data, int32_t length, uint64_t now,
+                      GipPacket* reply);
+
+/*
+ * Keep-alive: power the controller on again if it has not answered
+ * GIP_POWER_ON_RETRY_US after the last power on (a pad that was already
+ * on when the plugin started may miss the first one)
+ * @return 1 if out holds a packet to send
+ */
+int gip_keepalive(GipState* gip, uint64_t now, GipPacket* out);
+
+/*
+ * Next host packet sequence number (rumble and other host commands)
+ */
+static inline uint8_t gip_next_sequence(GipState* gip) {
+    uint8_t sequence = gip->out_sequence++;
+    if (gip->out_sequence == 0) {
+        gip->out_sequence = 1;
+    }
+    return sequence;
+}
+
+#endif // GIP_H
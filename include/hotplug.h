@@ -0,0 +1,69 @@
+/*
+ * USB Hot-plug Detection
+ * A low-rate background thread diffs the USB device list against the
+ * devices it already knows, keyed by bus number and device address,
+ * and queues arrival/removal events for the poll thread.
+ */
+
+#ifndef HOTPLUG_H
+#define HOTPLUG_H
+
+#include <stdint.h>
+#include <orbis/Usbd.h>
+
+/*
+ * Hot-plug event type
+ */
+typedef enum {
+    HOTPLUG_ARRIVED = 0,
+    HOTPLUG_LEFT
+} HotplugEventType;
+
+/*
+ * Hot-plug event
+ */
+typedef struct {
+    HotplugEventType type;
+    uint16_t         location;      // HOTPLUG_LOCATION(bus, address)
+    uint16_t         vendor_id;     // Valid for HOTPLUG_ARRIVED
+    uint16_t         product_id;    // Valid for HOTPLUG_ARRIVED
+    libusb_device*   device;        // Referenced device for HOTPLUG_ARRIVED, else NULL
+} HotplugEvent;
+
+/*
+ * Device filter - return nonzero for devices the consumer wants to see
+ */
+typedef int (*HotplugFilter)(uint16_t vendor_id, uint16_t product_id);
+
+// Physical location key. sceUsbd exposes no port number, so the bus
+// number plus the address assigned at enumeration identify a device.
+#define HOTPLUG_LOCATION(bus, address)  ((uint16_t)(((bus) << 8) | (address)))
+
+/*
+ * Start the detection thread. The first scan runs immediately.
+ * @param filter    Devices that pass are reported, others only tracked
+ * @return 0 on success, negative on error
+ */
+int hotplug_start(HotplugFilter filter);
+
+/*
+ * Stop the detection thread and drop queued events
+ */
+void hotplug_stop(void);
+
+/*
+ * Pop the next event (single consumer, non-blocking)
+ * Costs two atomic loads when nothing changed.
+ * The consumer must sceUsbdUnrefDevice() event->device when done.
+ * @param event     Output event
+ * @return 1 if an event was returned, 0 if the queue is empty
+ */
+int hotplug_poll(HotplugEvent* event);
+
+/*
+ * Forget every known device so the next scan reports all present
+ * devices again (consumer ignores ones it already has open)
+ */
+void hotplug_request_scan(void);
+
+#endif // HOTPLUG_H
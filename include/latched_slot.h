@@ -0,0 +1,68 @@
+/*
+ * Latched Sequence Lock
+ *
+ * Single-writer / multi-reader publication of a value kept in two
+ * copies. The sequence counter tells readers which copy is stable, so a
+ * reader never waits for a publish in progress and only retries if the
+ * writer completed a whole update during its copy.
+ *
+ * The value type stays with the user: a slot is a `volatile uint32_t`
+ * sequence next to `copies[2]`, and these helpers only order the
+ * sequence around the caller's copies.
+ *
+ *   Writer:  seq = latched_write_begin(&s->sequence);
+ *            s->copies[0] = value;
+ *            latched_write_switch(&s->sequence, seq);
+ *            s->copies[1] = value;
+ *
+ *   Reader:  do {
+ *                seq = latched_read_begin(&s->sequence);
+ *                out = s->copies[seq & 1];
+ *            } while (latched_read_retry(&s->sequence, seq));
+ */
+
+#ifndef LATCHED_SLOT_H
+#define LATCHED_SLOT_H
+
+#include <stdint.h>
+
+/*
+ * Start a publish: readers switch to copies[1] while copies[0] is rewritten
+ * @return Sequence to pass to latched_write_switch
+ */
+static inline uint32_t latched_write_begin(volatile uint32_t* sequence) {
+    uint32_t seq = __atomic_load_n(sequence, __ATOMIC_RELAXED);
+
+    // Odd
+    __atomic_store_n(sequence, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return seq;
+}
+
+/*
+ * copies[0] is complete: readers switch back to it while copies[1] catches up
+ */
+static inline void latched_write_switch(volatile uint32_t* sequence, uint32_t seq) {
+    // Even
+    __atomic_store_n(sequence, seq + 2, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/*
+ * Start a read
+ * @return Sequence of the copy to read: copies[seq & 1]
+ */
+static inline uint32_t latched_read_begin(const volatile uint32_t* sequence) {
+    return __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Check whether the copy just read may be torn
+ * @return Non-zero if the read must be repeated
+ */
+static inline int latched_read_retry(const volatile uint32_t* sequence, uint32_t seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(sequence, __ATOMIC_RELAXED) != seq;
+}
+
+#endif // LATCHED_SLOT_H
@@ -0,0 +1,121 @@
+/*
+ * Input Latency Instrumentation
+ * Every published report carries TSC timestamps for each pipeline stage.
+ * Stage-to-stage intervals are aggregated per controller into lock-free
+ * log-scale histograms that can be polled or dumped to a file.
+ *
+ * Build with LATENCY_TRACKING=0 to compile the probes out.
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "config.h"
+#include <stdint.h>
+
+/*
+ * Pipeline stages, in order. Stamps are sceKernelReadTsc() values.
+ */
+typedef enum {
+    LATENCY_STAGE_USB = 0,      // Interrupt transfer completed (0 = no transfer)
+    LATENCY_STAGE_DECODE,       // Report validated
+    LATENCY_STAGE_TRANSLATE,    // DS4 state built
+    LATENCY_STAGE_PUBLISH,      // Snapshot handed to the seqlock
+    LATENCY_STAGE_COUNT
+} LatencyStage;
+
+/*
+ * Stage timestamps carried with a published snapshot
+ */
+typedef struct {
+    uint64_t stamp[LATENCY_STAGE_COUNT];
+} LatencyStamps;
+
+/*
+ * Measured intervals
+ */
+typedef enum {
+    LATENCY_DECODE = 0,         // USB completion -> decoded
+    LATENCY_TRANSLATE,          // Decoded -> translated
+    LATENCY_PUBLISH,            // Translated -> visible to readers
+    LATENCY_WAIT,               // Visible -> first scePad read
+    LATENCY_END_TO_END,         // USB completion -> first scePad read
+    LATENCY_INTERVAL_COUNT
+} LatencyInterval;
+
+/*
+ * Summary of one interval histogram (nanoseconds)
+ * Percentiles are bucket upper bounds, within 1/8 of the true value.
+ */
+typedef struct {
+    uint64_t count;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} LatencyIntervalStats;
+
+/*
+ * Per-controller latency statistics
+ */
+typedef struct {
+    uint64_t             published;     // Reports made visible to the hooks
+    uint64_t             consumed;      // Reports read by the game at least once
+    LatencyIntervalStats interval[LATENCY_INTERVAL_COUNT];
+} LatencyStats;
+
+#if LATENCY_TRACKING
+
+/*
+ * Stamp a stage
+ */
+void latency_stamp(LatencyStamps* stamps, LatencyStage stage);
+
+/*
+ * Record the poller-side intervals of a report just published
+ * Snapshots without a USB stamp are not recorded (here or on consume).
+ * @param controller    Controller index (0-3)
+ */
+void latency_record_publish(int controller, const LatencyStamps* stamps);
+
+/*
+ * Record a scePad read of a published report. Only the first read of
+ * each report is counted; later reads of the same report are ignored.
+ * @param controller    Controller index (0-3)
+ */
+void latency_record_consume(int controller, const LatencyStamps* stamps);
+
+#else
+
+#define latency_stamp(stamps, stage)                    ((void)(stamps))
+#define latency_record_publish(controller, stamps)      ((void)(controller))
+#define latency_record_consume(controller, stamps)      ((void)(controller))
+
+#endif // LATENCY_TRACKING
+
+/*
+ * Short display name of an interval ("decode", "end-to-end", ...)
+ */
+const char* latency_interval_name(LatencyInterval interval);
+
+/*
+ * Snapshot the statistics of one controller
+ * @param controller    Controller index (0-3)
+ * @param stats         Output statistics
+ * @return 0 on success, negative on invalid index
+ */
+int latency_get_stats(int controller, LatencyStats* stats);
+
+/*
+ * Clear the statistics of one controller, or all with -1
+ */
+void latency_reset(int controller);
+
+/*
+ * Write a text summary of every controller with data
+ * @param path  Output file
+ * @return 0 on success, negative on error
+ */
+int latency_dump(const char* path);
+
+#endif // LATENCY_H
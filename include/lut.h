@@ -0,0 +1,20 @@
+/*
+ * Compile-time Lookup Table Generation
+ * LUT_256(f) expands to a brace initializer { f(0), f(1), ..., f(255) }
+ * for a function-like macro f whose result is a constant expression.
+ */
+
+#ifndef LUT_H
+#define LUT_H
+
+#define LUT_ROW4(f, b)      f(b), f((b) + 1), f((b) + 2), f((b) + 3)
+#define LUT_ROW16(f, b)     LUT_ROW4(f, b), LUT_ROW4(f, (b) + 4), \
+                            LUT_ROW4(f, (b) + 8), LUT_ROW4(f, (b) + 12)
+#define LUT_256(f) { \
+    LUT_ROW16(f, 0x00), LUT_ROW16(f, 0x10), LUT_ROW16(f, 0x20), LUT_ROW16(f, 0x30), \
+    LUT_ROW16(f, 0x40), LUT_ROW16(f, 0x50), LUT_ROW16(f, 0x60), LUT_ROW16(f, 0x70), \
+    LUT_ROW16(f, 0x80), LUT_ROW16(f, 0x90), LUT_ROW16(f, 0xA0), LUT_ROW16(f, 0xB0), \
+    LUT_ROW16(f, 0xC0), LUT_ROW16(f, 0xD0), LUT_ROW16(f, 0xE0), LUT_ROW16(f, 0xF0)  \
+}
+
+#endif // LUT_H
@@ -0,0 +1,56 @@
+/*
+ * Notification Queue
+ *
+ * System toasts (sceKernelSendNotificationRequest) are kernel IPC and
+ * can take milliseconds, so nothing on the input path sends them.
+ * Callers copy a fixed-size message into a bounded lock-free queue
+ * (multi-producer, single-consumer) and return; a low-priority thread
+ * drains it every NOTIFY_DRAIN_INTERVAL_US.
+ *
+ * The drain thread shows at most one toast per NOTIFY_MIN_INTERVAL_US
+ * (the rest wait in the queue) and skips a message identical to the
+ * last one shown within NOTIFY_DEDUP_US. A full queue drops the new
+ * message.
+ */
+
+#ifndef NOTIFY_H
+#define NOTIFY_H
+
+#include "config.h"
+#include <stdint.h>
+
+/*
+ * Counters since the plugin was loaded
+ */
+typedef struct {
+    uint32_t posted;            // Accepted into the queue
+    uint32_t sent;              // Shown
+    uint32_t dropped;           // Queue full
+    uint32_t duplicates;        // Skipped as a repeat of the last one shown
+} NotifyStats;
+
+/*
+ * Queue a message (any thread, never blocks)
+ * Longer messages are truncated to NOTIFY_MESSAGE_SIZE - 1 characters.
+ * @return 0 if queued, -1 if the queue was full
+ */
+int notify_post(const char* message);
+
+/*
+ * Start the drain thread
+ * Messages posted before it starts wait in the queue.
+ * @return 0 on success
+ */
+int notify_start(void);
+
+/*
+ * Stop the drain thread, showing what is still queued (no rate limit)
+ */
+void notify_stop(void);
+
+void notify_get_stats(NotifyStats* stats);
+
+// Verbose notifications, only shown in debug builds
+#define notify_debug(message) do { if (DEBUG_NOTIFICATIONS) notify_post(message); } while (0)
+
+#endif // NOTIFY_H
@@ -0,0 +1,135 @@
+/*
+ * Controller Input History Ring
+ *
+ * Single-writer ring of the most recent translated samples of one
+ * controller, so scePadRead can hand the game every sample since its
+ * previous call (like the real pad queue) instead of N copies of the
+ * current state. Taps shorter than a frame survive this way.
+ *
+ * Writer: the USB poll thread. Readers: scePad hooks on any game thread.
+ * Readers claim the samples they return by advancing a shared cursor
+ * with CAS; a reader that loses the race gets the latest sample only.
+ * The writer never waits: a reader copying a slot that is being
+ * overwritten detects it afterwards and drops that sample.
+ *
+ * Positions only grow, so a reader racing a reset never sees head or
+ * cursor move backwards; a reset just marks where the new connection's
+ * samples begin.
+ */
+
+#ifndef PAD_HISTORY_H
+#define PAD_HISTORY_H
+
+#include "config.h"
+#include "latency.h"
+#include <stdint.h>
+#include <string.h>
+
+#include <orbis/Pad.h>
+
+#define PAD_HISTORY_MASK    (PAD_HISTORY_SAMPLES - 1)
+
+/*
+ * History of one controller
+ */
+typedef struct {
+    volatile uint64_t head __attribute__((aligned(64)));      // Samples pushed so far (writer)
+    volatile uint64_t start;                                   // First sample of this connection (writer)
+    volatile uint64_t cursor __attribute__((aligned(64)));    // First sample not yet returned (readers)
+    OrbisPadData      samples[PAD_HISTORY_SAMPLES] __attribute__((aligned(64)));
+    LatencyStamps     stamps[PAD_HISTORY_SAMPLES];
+} PadHistory;
+
+/*
+ * Append a sample (single writer only)
+ */
+static inline void pad_history_push(PadHistory* history, const OrbisPadData* state,
+                                    const LatencyStamps* stamps) {
+    uint64_t head = __atomic_load_n(&history->head, __ATOMIC_RELAXED);
+
+    history->samples[head & PAD_HISTORY_MASK] = *state;
+    history->stamps[head & PAD_HISTORY_MASK] = *stamps;
+    __atomic_store_n(&history->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Drop every sample pushed so far (single writer only)
+ * Reads return 0 until the next push.
+ */
+static inline void pad_history_reset(PadHistory* history) {
+    uint64_t head = __atomic_load_n(&history->head, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&history->start, head, __ATOMIC_RELEASE);
+    __atomic_store_n(&history->cursor, head, __ATOMIC_RELEASE);
+}
+
+/*
+ * Copy samples [first, head) out of the ring, wrapping at most once
+ */
+static inline void pad_history_copy(const PadHistory* history, uint64_t first, uint64_t head,
+                                    OrbisPadData* out) {
+    uint32_t start = (uint32_t)(first & PAD_HISTORY_MASK);
+    uint32_t count = (uint32_t)(head - first);
+    uint32_t tail = PAD_HISTORY_SAMPLES - start;
+
+    if (count <= tail) {
+        memcpy(out, &history->samples[start], sizeof(OrbisPadData) * count);
+    } else {
+        memcpy(out, &history->samples[start], sizeof(OrbisPadData) * tail);
+        memcpy(out + tail, &history->samples[0], sizeof(OrbisPadData) * (count - tail));
+    }
+}
+
+/*
+ * Copy the samples pushed since the previous read, oldest first
+ * Returns the newest `max` if more are pending, and the latest sample
+ * again if none is.
+ * @param out       Output samples
+ * @param max       Capacity of out
+ * @param newest    Output stage timestamps of the newest sample copied
+ * @return Number of samples copied (0 if nothing was pushed since the reset)
+ */
+static inline int pad_history_read(PadHistory* history, OrbisPadData* out, int max,
+                                   LatencyStamps* newest) {
+    uint64_t head = __atomic_load_n(&history->head, __ATOMIC_ACQUIRE);
+    uint64_t start = __atomic_load_n(&history->start, __ATOMIC_ACQUIRE);
+    if (head <= start || max <= 0) {
+        return 0;
+    }
+
+    // Claim everything up to head; losers of a race see cursor == head
+    uint64_t cursor = __atomic_load_n(&history->cursor, __ATOMIC_RELAXED);
+    while (cursor < head &&
+           !__atomic_compare_exchange_n(&history->cursor, &cursor, head, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+
+    uint64_t first = (cursor < head) ? cursor : head - 1;
+    if (first < start) first = start;
+    if (head - first > (uint64_t)max) first = head - (uint64_t)max;
+    if (head - first > PAD_HISTORY_SAMPLES) first = head - PAD_HISTORY_SAMPLES;
+
+    for (;;) {
+        pad_history_copy(history, first, head, out);
+        *newest = history->stamps[(head - 1) & PAD_HISTORY_MASK];
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        // Slots of samples older than (now - size) may have been rewritten
+        uint64_t now = __atomic_load_n(&history->head, __ATOMIC_RELAXED);
+        uint64_t oldest_valid = (now >= PAD_HISTORY_SAMPLES) ? now - PAD_HISTORY_SAMPLES + 1 : 0;
+        if (first >= oldest_valid) {
+            return (int)(head - first);
+        }
+        if (head > oldest_valid) {
+            uint64_t drop = oldest_valid - first;
+            memmove(out, out + drop, sizeof(OrbisPadData) * (size_t)(head - oldest_valid));
+            return (int)(head - oldest_valid);
+        }
+
+        // Lapped entirely during the copy: fall back to the latest sample
+        head = now;
+        first = head - 1;
+    }
+}
+
+#endif // PAD_HISTORY_H
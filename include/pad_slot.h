@@ -0,0 +1,82 @@
+/*
+ * Wait-free Controller State Slot
+ *
+ * Single-writer / multi-reader publication of the latest translated
+ * controller state, through a latched sequence lock (latched_slot.h),
+ * so a hook never waits for the poll thread.
+ *
+ * Writer: the USB poll thread. Readers: scePad hooks on any game thread.
+ */
+
+#ifndef PAD_SLOT_H
+#define PAD_SLOT_H
+
+#include "usb_xbox.h"
+#include "latency.h"
+#include "latched_slot.h"
+#include <stdint.h>
+
+/*
+ * One published controller state
+ */
+typedef struct {
+    OrbisPadData    state;          // Translated DS4 data
+    XboxRawReport   report;         // Raw report it was translated from
+    uint64_t        update_time;    // Publish time (0 = nothing published)
+    LatencyStamps   latency;        // Pipeline stage timestamps
+} PadSnapshot;
+
+/*
+ * Latched slot: readers use copies[sequence & 1]
+ */
+typedef struct {
+    volatile uint32_t sequence;
+    PadSnapshot       copies[2];
+} PadSlot;
+
+/*
+ * Publish a new snapshot (single writer only)
+ */
+static inline void pad_slot_publish(PadSlot* slot, const PadSnapshot* snapshot) {
+    uint32_t seq = latched_write_begin(&slot->sequence);
+    slot->copies[0] = *snapshot;
+    latched_write_switch(&slot->sequence, seq);
+    slot->copies[1] = *snapshot;
+}
+
+/*
+ * Copy the latest snapshot
+ * @return Sequence number of the copy (0 if nothing was ever published)
+ */
+static inline uint32_t pad_slot_read(const PadSlot* slot, PadSnapshot* out) {
+    uint32_t seq;
+
+    do {
+        seq = latched_read_begin(&slot->sequence);
+        *out = slot->copies[seq & 1];
+    } while (latched_read_retry(&slot->sequence, seq));
+
+    return seq;
+}
+
+/*
+ * Copy only the translated state of the latest snapshot (hook hot path)
+ * @param stamps    Output stage timestamps of the copy
+ * @return Publish time of the copy (0 if no state is available)
+ */
+static inline uint64_t pad_slot_read_state(const PadSlot* slot, OrbisPadData* state, LatencyStamps* stamps) {
+    uint32_t seq;
+    uint64_t update_time;
+
+    do {
+        seq = latched_read_begin(&slot->sequence);
+        const PadSnapshot* copy = &slot->copies[seq & 1];
+        update_time = copy->update_time;
+        *state = copy->state;
+        *stamps = copy->latency;
+    } while (latched_read_retry(&slot->sequence, seq));
+
+    return update_time;
+}
+
+#endif // PAD_SLOT_H
@@ -0,0 +1,82 @@
+/*
+ * Normalized Controller State
+ *
+ * What every decoder produces, whatever the pad: DS4 button mask, signed
+ * Q15 sticks, 10-bit triggers and a sample time in 24 bytes. Stick
+ * filtering (deadzone, curve, inversion), digital trigger buttons and
+ * anything that acts on input after that run once on this form; only
+ * pad_state_emit knows the OrbisPadData layout.
+ *
+ * Sticks are -32768..32767 with 0 at center, in DS4 orientation once
+ * filtered (up is negative Y). Lower precision sources are shifted up
+ * (8-bit Switch axes: (v - 128) << 8), so emitting is a shift back.
+ *
+ * With SSE2 (PAD_STATE_SIMD) the emitter converts the four sticks and
+ * both triggers of a state in one register and writes OrbisPadData with
+ * 16-byte stores of a neutral template held in registers across a
+ * batch. The portable emitter is the reference it must match byte for
+ * byte.
+ */
+
+#ifndef PAD_STATE_H
+#define PAD_STATE_H
+
+#include "config.h"
+#include "ds4.h"
+#include <stdint.h>
+
+#define PAD_TRIGGER_BITS    10
+#define PAD_TRIGGER_MAX     ((1 << PAD_TRIGGER_BITS) - 1)
+
+typedef struct {
+    uint32_t buttons;           // DS4_BUTTON_* after remapping
+    int16_t  left_x;
+    int16_t  left_y;
+    int16_t  right_x;
+    int16_t  right_y;
+    uint16_t l2;                // 0-PAD_TRIGGER_MAX
+    uint16_t r2;
+    uint64_t timestamp;         // Sample time (0 = not stamped yet)
+} PadState;
+
+_Static_assert(sizeof(PadState) == 24, "PadState must stay compact");
+
+// 8-bit DS4 value (0-255, center 128) <-> Q15 stick
+static inline int16_t pad_stick_from_u8(uint8_t value) {
+    return (int16_t)(((int32_t)value - 128) * 256);
+}
+
+static inline uint8_t pad_stick_to_u8(int16_t value) {
+    return (uint8_t)((value >> 8) + 128);
+}
+
+// 8-bit trigger <-> 10-bit trigger (255 -> 1020, 1023 -> 255)
+static inline uint16_t pad_trigger_from_u8(uint8_t value) {
+    return (uint16_t)(value << (PAD_TRIGGER_BITS - 8));
+}
+
+static inline uint8_t pad_trigger_to_u8(uint16_t value) {
+    return (uint8_t)(value >> (PAD_TRIGGER_BITS - 8));
+}
+
+/*
+ * Write the DS4 pad data for a state
+ * Every OrbisPadData byte is written: neutral motion, no touches,
+ * connected, the state's timestamp.
+ */
+void pad_state_emit(const PadState* state, OrbisPadData* ds4);
+
+/*
+ * Write the DS4 pad data for count states (same output as
+ * pad_state_emit on each)
+ * The plugin only emits one state per report through pad_state_emit;
+ * longer batches are exercised by bench.
+ */
+void pad_state_emit_batch(const PadState* states, OrbisPadData* ds4, int count);
+
+/*
+ * Portable emitter, one field at a time (reference for the SIMD one)
+ */
+void pad_state_emit_scalar(const PadState* state, OrbisPadData* ds4);
+
+#endif // PAD_STATE_H
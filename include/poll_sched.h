@@ -0,0 +1,89 @@
+/*
+ * Adaptive USB Poll Scheduler
+ *
+ * Decides when the poll thread issues the next IN transfer for one
+ * controller. The period follows the game: while it reads the pad, the
+ * device is polled POLL_SAMPLES_PER_READ times per game read (never
+ * faster than the endpoint bInterval), phase-aligned so the last poll
+ * before each predicted read completes just ahead of it. A controller
+ * nobody reads is polled at POLL_IDLE_INTERVAL_US.
+ *
+ * Controllers on asynchronous transfers (usb_async.h) keep transfers
+ * queued while the game reads, so the device paces them; there the
+ * schedule only decides when an idle or failing controller is polled.
+ *
+ * The scePad hooks only record each read (time and count); all the
+ * estimation runs on the poll thread.
+ */
+
+#ifndef POLL_SCHED_H
+#define POLL_SCHED_H
+
+#include <stdint.h>
+
+/*
+ * Scheduler state of one controller
+ */
+typedef struct {
+    // Written by the hooks (any game thread)
+    volatile uint64_t last_read_us __attribute__((aligned(64)));  // Time of the newest game read
+    volatile uint32_t read_count;       // Game reads so far
+
+    // Poll thread only (own cache line)
+    uint32_t device_interval_us __attribute__((aligned(64)));     // Endpoint bInterval
+    uint32_t seen_count;                // read_count at the last update
+    uint64_t seen_read_us;              // last_read_us at the last update
+    uint32_t read_period_us;            // Smoothed game read period (0 = idle)
+    uint32_t poll_period_us;            // Current time between polls
+    uint64_t next_poll_us;              // When to poll next
+    uint64_t polls;                     // Polls issued
+    int      idle;                      // Nobody is reading the pad
+} PollSchedule;
+
+/*
+ * Scheduler snapshot for diagnostics
+ */
+typedef struct {
+    uint32_t device_interval_us;
+    uint32_t read_period_us;            // 0 while idle
+    uint32_t poll_period_us;            // Unused while transfers are queued
+    uint64_t polls;                     // Polls or async completions
+    uint32_t transfers_queued;          // Async IN transfers in flight (0 = synchronous)
+    uint64_t unchanged;                 // Reports published without re-translation
+} PollScheduleStats;
+
+/*
+ * Reset the schedule of a newly opened controller
+ * Game read tracking carries over: the hooks read by slot, not device.
+ * @param interval_us   Endpoint polling interval from bInterval
+ * @param now           Current time (sceKernelGetProcessTime)
+ */
+void poll_sched_init(PollSchedule* sched, uint32_t interval_us, uint64_t now);
+
+/*
+ * Record a game read (hook path, lock-free)
+ */
+static inline void poll_sched_note_read(PollSchedule* sched, uint64_t now) {
+    __atomic_store_n(&sched->last_read_us, now, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sched->read_count, 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Account for a poll just completed and plan the next one
+ * @param now   Current time (sceKernelGetProcessTime)
+ * @return Time of the next poll (also stored in next_poll_us)
+ */
+uint64_t poll_sched_update(PollSchedule* sched, uint64_t now);
+
+/*
+ * Snapshot the schedule (any thread, values may be slightly stale)
+ */
+void poll_sched_get_stats(const PollSchedule* sched, PollScheduleStats* stats);
+
+/*
+ * Convert an interrupt endpoint bInterval to microseconds
+ * Every supported controller is a full-speed device (1ms frames).
+ */
+uint32_t poll_sched_interval_us(uint8_t b_interval);
+
+#endif // POLL_SCHED_H
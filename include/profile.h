@@ -0,0 +1,140 @@
+/*
+ * Per-Title Configuration Profiles
+ *
+ * Settings live in an INI file next to plugins.ini (PROFILE_PATH):
+ *
+ *     [default]                ; every game
+ *     stick_deadzone = 15
+ *     remap = L1 > L1+R1
+ *
+ *     [CUSA00001]              ; one game, on top of [default]
+ *     swap_ab = 1
+ *     turbo = square : 15      ; see turbo.h
+ *
+ * The file is parsed at plugin_load for the running title and compiled
+ * into TranslatorTables, so per report the polling thread does table
+ * lookups only: no parsing, no decisions on config fields.
+ * See xbox_controller.ini.example for every key.
+ *
+ * Hot reload: a watcher thread stats the file every
+ * PROFILE_WATCH_INTERVAL_US and, when it changed, compiles the new
+ * profile into the spare of two buffers and publishes it with one
+ * pointer store. The reader (poll thread) passes a quiescent point
+ * between reports with profile_quiescent(); the watcher only rebuilds
+ * into the old buffer after the reader has passed one, so a report
+ * that started on the old tables finishes on them.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "translator.h"
+#include "turbo.h"
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROFILE_MAX_REMAPS      16
+#define PROFILE_TITLE_ID_SIZE   16
+
+/*
+ * Settings as read from the file
+ */
+typedef struct {
+    TranslatorConfig config;
+    RemapRule        remaps[PROFILE_MAX_REMAPS];
+    int              remap_count;
+    TurboRule        turbos[TURBO_MAX_RULES];
+    int              turbo_count;
+    MacroRule        macros[TURBO_MAX_MACROS];
+    int              macro_count;
+    uint32_t         poll_rate_hz;      // 0 = endpoint bInterval
+} ProfileSettings;
+
+/*
+ * Compiled profile (immutable once published)
+ */
+typedef struct __attribute__((aligned(64))) {
+    TranslatorTables tables;
+    TurboTable       turbo;
+    uint32_t         poll_interval_us;  // 0 = endpoint bInterval
+    uint32_t         generation;        // Bumped by every publish
+    int              title_section;     // The title had its own section
+    char             title_id[PROFILE_TITLE_ID_SIZE];
+} Profile;
+
+/*
+ * Reader epochs (each on its own cache line)
+ * reader is 0 while the reader thread is offline.
+ */
+typedef struct {
+    volatile uint64_t epoch __attribute__((aligned(64)));     // Bumped after every publish
+    volatile uint64_t reader __attribute__((aligned(64)));    // Last epoch the reader saw
+} ProfileEpochs;
+
+extern ProfileEpochs g_profile_epochs;
+
+/*
+ * Read the [default] section and the title's section
+ * Settings start from translator_init defaults; unknown keys and bad
+ * values are skipped.
+ * @param title_id  Title section to apply on top of [default] (or NULL)
+ * @param found     Set to 1 if the title had a section (may be NULL)
+ * @return Number of lines skipped, -1 if the file cannot be opened
+ */
+int profile_parse(const char* path, const char* title_id, ProfileSettings* settings, int* found);
+
+/*
+ * Compile settings into a profile
+ */
+void profile_compile(const ProfileSettings* settings, Profile* profile);
+
+/*
+ * Load the running title's profile and make it active
+ * A missing file gives the defaults. The path is kept for reloads.
+ * @return Number of lines skipped, -1 if the file cannot be opened
+ */
+int profile_load(const char* path);
+
+/*
+ * Start/stop the thread that reloads the profile when its file changes
+ * @return 0 on success
+ */
+int profile_watch_start(void);
+void profile_watch_stop(void);
+
+/*
+ * Active profile (NULL before profile_load: translators use defaults)
+ */
+const Profile* profile_active(void);
+
+/*
+ * Active translator tables (NULL before profile_load)
+ */
+static inline const TranslatorTables* profile_tables(void) {
+    const Profile* profile = profile_active();
+    return profile ? &profile->tables : NULL;
+}
+
+/*
+ * Reader quiescent point: no profile pointer obtained before this call
+ * is used after it. Call from the reader thread between reports; it
+ * costs one load unless a reload is waiting on the reader.
+ */
+static inline void profile_quiescent(void) {
+    uint64_t epoch = __atomic_load_n(&g_profile_epochs.epoch, __ATOMIC_ACQUIRE);
+    if (g_profile_epochs.reader != epoch) {
+        __atomic_store_n(&g_profile_epochs.reader, epoch, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+}
+
+/*
+ * Reader holds no profile pointer until its next profile_quiescent()
+ * (reader thread exit)
+ */
+static inline void profile_offline(void) {
+    __atomic_store_n(&g_profile_epochs.reader, 0, __ATOMIC_RELEASE);
+}
+
+#endif // PROFILE_H
@@ -0,0 +1,70 @@
+/*
+ * Button Remap Engine
+ * Maps controller button bytes to DS4 button masks through lookup
+ * tables: every possible value of a button byte has a precomputed DS4
+ * mask, so translating all buttons is two loads and an OR.
+ *
+ * The default tables are generated at compile time. Swaps and user
+ * remaps are folded into a copy of a default table once, so they cost
+ * nothing per report.
+ */
+
+#ifndef REMAP_H
+#define REMAP_H
+
+#include <stdint.h>
+
+/*
+ * Button lookup tables for one controller type
+ */
+typedef struct {
+    uint32_t lo[256];           // First button byte -> DS4 buttons
+    uint32_t hi[256];           // Second button byte -> DS4 buttons
+    uint32_t hat[16];           // Hat switch value -> DS4 d-pad (Switch only)
+    uint32_t left_trigger;      // DS4 buttons set when LT passes the threshold
+    uint32_t right_trigger;     // DS4 buttons set when RT passes the threshold
+} RemapTable;
+
+/*
+ * User remap: the physical button that normally produces `from`
+ * produces `to` instead
+ */
+typedef struct {
+    uint32_t from;              // Single DS4 button (DS4_BUTTON_*)
+    uint32_t to;                // DS4 buttons to produce (0 = disabled)
+} RemapRule;
+
+// Compile-time defaults (no swaps, no user rules)
+extern const RemapTable g_remap_xbox360;     // lo = buttons_low, hi = buttons_high
+extern const RemapTable g_remap_xboxone;     // lo = buttons_low, hi = buttons_high
+extern const RemapTable g_remap_switch;      // lo = buttons0, hi = buttons1, hat
+
+/*
+ * Build a table from a default table
+ * Swaps apply first, then rules, each rewriting DS4 buttons:
+ * physical button -> default DS4 button -> swapped -> user rule.
+ * @param table     Output table (may not alias base)
+ * @param base      Default table of the controller type
+ * @param swap_ab   Swap Cross and Circle
+ * @param swap_xy   Swap Square and Triangle
+ * @param rules     User rules (NULL if none)
+ * @param count     Number of rules
+ */
+void remap_build(RemapTable* table, const RemapTable* base, int swap_ab, int swap_xy,
+                 const RemapRule* rules, int count);
+
+/*
+ * DS4 buttons of two button bytes
+ */
+static inline uint32_t remap_buttons(const RemapTable* table, uint8_t lo, uint8_t hi) {
+    return table->lo[lo] | table->hi[hi];
+}
+
+/*
+ * DS4 d-pad of a hat switch value (16+ = centered)
+ */
+static inline uint32_t remap_hat(const RemapTable* table, uint8_t hat) {
+    return table->hat[hat & 0x0F] & (0u - (uint32_t)(hat < 16));
+}
+
+#endif // REMAP_H
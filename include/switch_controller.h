@@ -10,7 +10,7 @@
 
 #include <stdint.h>
 
-// USB IDs for supported controllers
+// USB IDs (the full list is in drivers.c)
 #define SWITCH_ROCKCAND_VID  0x0e6f
 #define SWITCH_ROCKCANDY_PID 0x0187
 
@@ -60,20 +60,4 @@ typedef struct __attribute__((packed)) {
 #define SWITCH_HAT_UP_LEFT     7
 #define SWITCH_HAT_CENTERED    8  // 8 or higher = no direction
 
-/*
- * Helper to check if controller is a Switch Input-Only type
- */
-static inline int is_switch_input_only_controller(uint16_t vid, uint16_t pid) {
-    // PDP Rock Candy
-    if (vid == 0x0e6f && pid == 0x0187) return 1;
-    // PDP Faceoff Wired Pro
-    if (vid == 0x0e6f && pid == 0x0180) return 1;
-    // PDP Faceoff Deluxe Wired Pro
-    if (vid == 0x0e6f && pid == 0x0181) return 1;
-    // PDP Wired Fight Pad Pro
-    if (vid == 0x0e6f && pid == 0x0185) return 1;
-
-    return 0;
-}
-
 #endif // SWITCH_CONTROLLER_H
@@ -10,6 +10,9 @@
 #include "xboxone.h"
 #include "switch_controller.h"
 #include "ds4.h"
+#include "remap.h"
+#include "axis.h"
+#include "pad_state.h"
 #include "config.h"
 
 /*
@@ -28,28 +31,69 @@ typedef enum {
 typedef struct {
     uint8_t stick_deadzone;         // Deadzone for analog sticks (0-127)
     uint8_t trigger_threshold;      // Digital trigger activation point (0-255)
-    int     invert_left_y;          // Invert left stick Y axis
-    int     invert_right_y;         // Invert right stick Y axis
+    int     invert_left_y;          // Invert left stick Y axis (Switch: the opposite)
+    int     invert_right_y;         // Invert right stick Y axis (Switch: the opposite)
     int     swap_ab;                // Swap A/B buttons (for Japanese layout)
     int     swap_xy;                // Swap X/Y buttons
+    AxisDeadzoneMode deadzone_mode; // Axial, radial or scaled radial deadzone
+    AxisCurveType    stick_curve;   // Stick response curve
+    float   curve_exponent;         // Exponent of AXIS_CURVE_EXPONENTIAL
+    uint8_t curve_points[AXIS_CURVE_POINTS];   // Points of AXIS_CURVE_CUSTOM (0-127)
 } TranslatorConfig;
 
+/*
+ * Translator configuration compiled into per-controller-type tables
+ * Build with translator_compile; the translators only read it. Tables
+ * start on a cache line so a lookup never straddles two needlessly.
+ */
+typedef struct __attribute__((aligned(64))) {
+    TranslatorConfig config;
+    RemapTable       xbox360 __attribute__((aligned(64)));
+    RemapTable       xboxone;
+    RemapTable       switch_pad;
+    AxisTable        axes;          // Xbox sticks
+    AxisTable        switch_axes;   // Switch sticks (Y reported the other way up)
+    uint16_t         radial_gain[AXIS_RADIAL_ENTRIES];
+} TranslatorTables;
+
 /*
  * Initialize translator with default configuration
  */
 void translator_init(TranslatorConfig* config);
 
 /*
- * Translate Xbox 360 report to OrbisPadData
+ * Compile a configuration and optional user remaps into tables
+ *
+ * @param config    Translator configuration (or NULL for defaults)
+ * @param rules     User button remaps (or NULL)
+ * @param count     Number of remap rules
+ * @param tables    Output tables
+ */
+void translator_compile(const TranslatorConfig* config, const RemapRule* rules, int count,
+                        TranslatorTables* tables);
+
+/*
+ * Decode reports into the normalized state (remaps, stick filtering and
+ * digital triggers applied; timestamp left 0)
+ *
+ * @param tables    Compiled configuration (or NULL for defaults)
+ */
+void translator_decode(const Xbox360Report* xbox, PadState* pad, const TranslatorTables* tables);
+void translator_decode_xboxone(const XboxOneReport* xbox, PadState* pad, const TranslatorTables* tables);
+void translator_decode_switch(const SwitchInputOnlyReport* sw, PadState* pad, const TranslatorTables* tables);
+
+/*
+ * Translate Xbox 360 report to OrbisPadData (decode + pad_state_emit)
  *
  * @param xbox      Input Xbox 360 report
  * @param ds4       Output OrbisPadData structure
- * @param config    Translator configuration (or NULL for defaults)
+ * @param tables    Compiled configuration (or NULL for defaults)
  */
-void translator_convert(const Xbox360Report* xbox, OrbisPadData* ds4, const TranslatorConfig* config);
+void translator_convert(const Xbox360Report* xbox, OrbisPadData* ds4, const TranslatorTables* tables);
 
 /*
  * Apply deadzone to stick value
+ * Reference for the axial tables; the translators no longer call it.
  *
  * @param value     Raw stick value (0-255, center=128)
  * @param deadzone  Deadzone size (0-127)
@@ -63,13 +107,13 @@ uint8_t translator_apply_deadzone(uint8_t value, uint8_t deadzone);
 void xbox360_to_ds4(const Xbox360Report* xbox, OrbisPadData* ds4);
 
 /*
- * Translate Xbox One report to OrbisPadData
+ * Translate Xbox One report to OrbisPadData (decode + pad_state_emit)
  *
  * @param xbox      Input Xbox One report
  * @param ds4       Output OrbisPadData structure
- * @param config    Translator configuration (or NULL for defaults)
+ * @param tables    Compiled configuration (or NULL for defaults)
  */
-void translator_convert_xboxone(const XboxOneReport* xbox, OrbisPadData* ds4, const TranslatorConfig* config);
+void translator_convert_xboxone(const XboxOneReport* xbox, OrbisPadData* ds4, const TranslatorTables* tables);
 
 /*
  * Simple wrapper - translate Xbox One report to DS4 format using defaults
@@ -77,13 +121,13 @@ void translator_convert_xboxone(const XboxOneReport* xbox, OrbisPadData* ds4, co
 void xboxone_to_ds4(const XboxOneReport* xbox, OrbisPadData* ds4);
 
 /*
- * Translate Switch Input-Only controller report to OrbisPadData
+ * Translate Switch Input-Only controller report to OrbisPadData (decode + pad_state_emit)
  *
  * @param sw       Input Switch controller report
  * @param ds4      Output OrbisPadData structure
- * @param config   Translator configuration (or NULL for defaults)
+ * @param tables   Compiled configuration (or NULL for defaults)
  */
-void translator_convert_switch(const SwitchInputOnlyReport* sw, OrbisPadData* ds4, const TranslatorConfig* config);
+void translator_convert_switch(const SwitchInputOnlyReport* sw, OrbisPadData* ds4, const TranslatorTables* tables);
 
 /*
  * Simple wrapper - translate Switch controller report to DS4 format using defaults
@@ -0,0 +1,107 @@
+/*
+ * Turbo and Macro Engine
+ *
+ * Rewrites the DS4 button mask of a normalized state on the poll
+ * thread, after remapping:
+ *
+ *   turbo   - a held button is pressed and released at a fixed rate,
+ *             starting pressed at the moment it goes down
+ *   macro   - pressing a trigger button plays a short sequence of
+ *             button sets, each held for a number of frames; the
+ *             trigger itself never reaches the game
+ *
+ * All timing is on the poll thread's clock: phases count from the
+ * press, macro steps from the previous step's end, so the output does
+ * not depend on when reports arrive or when the game reads. Between
+ * reports the poll thread republishes the state when turbo_apply says
+ * the output changes next. The hooks see ordinary published states.
+ *
+ * Settings come from the profile (turbo = and macro = keys) compiled
+ * into a TurboTable; a profile without either leaves the engine off.
+ */
+
+#ifndef TURBO_H
+#define TURBO_H
+
+#include "pad_state.h"
+#include "config.h"
+#include <stdint.h>
+
+#define TURBO_MAX_RULES     8
+#define TURBO_MAX_MACROS    4
+#define TURBO_MAX_STEPS     16
+
+/*
+ * Turbo on one button
+ */
+typedef struct {
+    uint32_t button;            // Single DS4 button (DS4_BUTTON_*)
+    uint32_t rate_hz;           // Presses per second, 1-TURBO_MAX_HZ
+} TurboRule;
+
+/*
+ * One macro step: buttons held for a number of frames
+ */
+typedef struct {
+    uint32_t buttons;           // DS4 buttons (0 = gap)
+    uint32_t frames;            // 1-TURBO_MAX_STEP_FRAMES, MACRO_FRAME_US each
+} MacroStep;
+
+typedef struct {
+    uint32_t  trigger;          // Single DS4 button that starts it
+    int       step_count;
+    MacroStep steps[TURBO_MAX_STEPS];
+} MacroRule;
+
+/*
+ * Compiled settings (read-only, part of the profile)
+ */
+typedef struct {
+    uint32_t  turbo_mask;       // Buttons with turbo
+    uint32_t  trigger_mask;     // Macro trigger buttons
+    int       rule_count;
+    uint32_t  button[TURBO_MAX_RULES];
+    uint32_t  half_period_us[TURBO_MAX_RULES];
+    int       macro_count;
+    uint32_t  macro_trigger[TURBO_MAX_MACROS];
+    int       step_count[TURBO_MAX_MACROS];
+    uint32_t  step_buttons[TURBO_MAX_MACROS][TURBO_MAX_STEPS];
+    uint32_t  step_us[TURBO_MAX_MACROS][TURBO_MAX_STEPS];
+} TurboTable;
+
+/*
+ * Per-controller engine state (poll thread only)
+ */
+typedef struct {
+    uint32_t held;              // Input buttons of the previous call
+    uint64_t pressed_us[TURBO_MAX_RULES];   // When each turbo button went down
+    int      macro;             // Macro playing, -1 if none
+    int      step;              // Its current step
+    uint64_t step_end_us;       // When that step ends
+} TurboState;
+
+/*
+ * Compile rules (invalid ones are dropped)
+ */
+void turbo_compile(TurboTable* table, const TurboRule* rules, int rule_count,
+                   const MacroRule* macros, int macro_count);
+
+/*
+ * Forget presses and stop any macro (new controller or new profile)
+ */
+void turbo_reset(TurboState* state);
+
+/*
+ * Rewrite a state's buttons for time now
+ * @param pad   Translated state; buttons are replaced by the output
+ * @param now   Poll thread time (sceKernelGetProcessTime)
+ * @return Time the output next changes with the input unchanged,
+ *         UINT64_MAX if it does not
+ */
+uint64_t turbo_apply(const TurboTable* table, TurboState* state, PadState* pad, uint64_t now);
+
+static inline int turbo_enabled(const TurboTable* table) {
+    return (table->turbo_mask | table->trigger_mask) != 0;
+}
+
+#endif // TURBO_H
@@ -0,0 +1,128 @@
+/*
+ * Asynchronous USB Interrupt Transfers
+ *
+ * Keeps USB_ASYNC_TRANSFERS IN transfers queued on an endpoint through
+ * the libusb-style async API that sceUsbd wraps, so the host controller
+ * always has a transfer ready when the device reports and no report
+ * waits on the poll thread's turnaround. Completions are delivered from
+ * usb_async_handle_events(), which only the poll thread calls.
+ *
+ * Output uses one OUT transfer per endpoint: the caller holds the newest
+ * packet and sends it once the previous one is off the wire.
+ *
+ * A transfer the stack has not returned USB_ASYNC_STOP_WAIT_MS after
+ * its cancel is leaked, not freed. Its late completion is recognized
+ * (it is no longer the endpoint's transfer) and only frees it; until
+ * then the endpoint cannot be started again, since the stack may still
+ * write into its buffers.
+ */
+
+#ifndef USB_ASYNC_H
+#define USB_ASYNC_H
+
+#include "config.h"
+#include <stdint.h>
+
+#include <orbis/Usbd.h>
+
+/*
+ * Completion status passed to the handler
+ */
+typedef enum {
+    USB_ASYNC_COMPLETED = 0,    // Data received
+    USB_ASYNC_TIMED_OUT,        // Transfer timeout, no data
+    USB_ASYNC_CANCELLED,        // Cancelled by usb_async_stop
+    USB_ASYNC_GONE,             // Device removed
+    USB_ASYNC_ERROR             // Stall, overflow or other error
+} UsbAsyncStatus;
+
+/*
+ * Completion handler (runs inside usb_async_handle_events)
+ * @param context   Context given to usb_async_start
+ * @param data      Received data (COMPLETED only)
+ * @param length    Received length
+ * @return 1 to resubmit the transfer, 0 to park it until usb_async_resume
+ */
+typedef int (*UsbAsyncHandler)(void* context, const uint8_t* data, int32_t length,
+                               UsbAsyncStatus status);
+
+/*
+ * Queued transfers of one IN endpoint
+ */
+typedef struct {
+    struct libusb_transfer* transfers[USB_ASYNC_TRANSFERS];
+    uint8_t                 buffers[USB_ASYNC_TRANSFERS][USB_ASYNC_BUFFER_SIZE];
+    uint8_t                 pending[USB_ASYNC_TRANSFERS];   // Submitted, not completed
+    int                     in_flight;
+    int                     stopping;
+    int                     leaked;         // Stopped, not yet returned by the stack
+    UsbAsyncHandler         handler;
+    void*                   context;
+} UsbAsyncEndpoint;
+
+/*
+ * Single OUT transfer of one endpoint
+ */
+typedef struct {
+    struct libusb_transfer* transfer;
+    uint8_t                 buffer[USB_ASYNC_BUFFER_SIZE];
+    int                     pending;
+    int                     leaked;         // Stopped, not yet returned by the stack
+} UsbAsyncOutput;
+
+/*
+ * Allocate and submit every transfer of an endpoint
+ * @return 0 on success; negative if the async API is unavailable or
+ *         transfers of the previous start are still leaked, in which
+ *         case nothing is left allocated and the caller should fall
+ *         back to synchronous transfers
+ */
+int usb_async_start(UsbAsyncEndpoint* endpoint, libusb_device_handle* handle, uint8_t address,
+                    UsbAsyncHandler handler, void* context);
+
+/*
+ * Resubmit parked transfers
+ * @param max   Most transfers to resubmit
+ * @return Number of transfers resubmitted, negative if a submit failed
+ */
+int usb_async_resume(UsbAsyncEndpoint* endpoint, int max);
+
+/*
+ * Number of transfers parked (allocated but not submitted)
+ */
+static inline int usb_async_parked(const UsbAsyncEndpoint* endpoint) {
+    return USB_ASYNC_TRANSFERS - endpoint->in_flight;
+}
+
+/*
+ * Cancel every transfer, wait for their completions and free them
+ * Must not be called from a completion handler.
+ */
+void usb_async_stop(UsbAsyncEndpoint* endpoint);
+
+/*
+ * Allocate the OUT transfer of an endpoint
+ * @return 0 on success, negative if the async API is unavailable or
+ *         the previous transfer is still leaked
+ */
+int usb_async_output_start(UsbAsyncOutput* output, libusb_device_handle* handle, uint8_t address);
+
+/*
+ * Send a packet (copied) unless the previous one is still on the wire
+ * @return 0 if submitted, 1 if busy, negative on error
+ */
+int usb_async_output_send(UsbAsyncOutput* output, const void* data, int32_t length);
+
+/*
+ * Cancel the pending packet, if any, and free the transfer
+ * Must not be called from a completion handler.
+ */
+void usb_async_output_stop(UsbAsyncOutput* output);
+
+/*
+ * Run completion handlers, waiting up to timeout_us for the first one
+ * @return 0 on success, negative on error
+ */
+int usb_async_handle_events(uint32_t timeout_us);
+
+#endif // USB_ASYNC_H
@@ -1,12 +1,15 @@
 /*
- * Xbox 360 USB Controller Reader
- * Handles USB enumeration, connection, and input polling
+ * USB Controller Polling Engine
+ * Handles USB enumeration, connection and input polling for every
+ * supported controller type. All transfers run on a background thread
+ * which publishes the latest translated state for the scePad hooks.
  */
 
 #ifndef USB_XBOX_H
 #define USB_XBOX_H
 
-#include "xbox360.h"
+#include "translator.h"
+#include "poll_sched.h"
 #include "config.h"
 #include <stdint.h>
 
@@ -19,19 +22,33 @@ typedef enum {
     XBOX_STATE_ERROR
 } XboxControllerState;
 
+/*
+ * Raw input report, large enough for any supported controller
+ */
+typedef union {
+    Xbox360Report         xbox360;
+    XboxOneReport         xboxone;
+    SwitchInputOnlyReport switch_report;
+    uint8_t               raw[64];
+} XboxRawReport;
+
 /*
  * Controller slot information
  */
 typedef struct {
     XboxControllerState state;
-    Xbox360Report       last_report;
-    uint64_t            last_update;    // Timestamp of last report
+    ControllerType      type;
     uint16_t            vendor_id;
     uint16_t            product_id;
+
+    // Rewritten on every report: kept off the line the hooks poll state from
+    XboxRawReport       last_report __attribute__((aligned(64)));
+    uint64_t            last_update;    // Timestamp of last report
 } XboxControllerSlot;
 
 /*
- * Initialize USB subsystem and start controller detection
+ * Initialize USB subsystem
+ * Controller detection starts with xbox_usb_start_polling
  * @return 0 on success, negative on error
  */
 int xbox_usb_init(void);
@@ -42,7 +59,7 @@ int xbox_usb_init(void);
 void xbox_usb_cleanup(void);
 
 /*
- * Start background polling thread
+ * Start background polling and hot-plug detection threads
  * @return 0 on success, negative on error
  */
 int xbox_usb_start_polling(void);
@@ -66,22 +83,52 @@ int xbox_usb_get_controller_count(void);
 int xbox_usb_is_connected(int index);
 
 /*
- * Read latest report from controller
+ * Read latest raw report from controller
  * @param index     Controller index (0-3)
  * @param report    Output report structure
  * @return 0 on success, negative on error or no data
  */
-int xbox_usb_read_report(int index, Xbox360Report* report);
+int xbox_usb_read_report(int index, XboxRawReport* report);
+
+/*
+ * Copy the latest translated state published by the poll thread
+ * Never touches USB; safe to call from the scePad hooks.
+ * @param index     Controller index (0-3)
+ * @param state     Output pad data
+ * @return 0 on success, negative if disconnected or no report yet
+ */
+int xbox_usb_read_state(int index, OrbisPadData* state);
 
 /*
- * Send rumble command to controller
+ * Copy the translated samples published since the previous call
+ * Oldest first; the newest `max` if more are pending, the latest sample
+ * again if none is. Never touches USB; safe to call from the hooks.
+ * @param index     Controller index (0-3)
+ * @param states    Output samples
+ * @param max       Capacity of states
+ * @return Number of samples (1-max), negative if disconnected or no report yet
+ */
+int xbox_usb_read_history(int index, OrbisPadData* states, int max);
+
+/*
+ * Request rumble motor levels (never blocks)
+ * The poll thread sends the newest request, skipping unchanged values
+ * and at most one packet per RUMBLE_MIN_INTERVAL_US.
  * @param index         Controller index (0-3)
  * @param left_motor    Left (large) motor intensity (0-255)
  * @param right_motor   Right (small) motor intensity (0-255)
- * @return 0 on success, negative on error
+ * @return 0 if queued, -2 if disconnected, -3 if the controller has no rumble
  */
 int xbox_usb_set_rumble(int index, uint8_t left_motor, uint8_t right_motor);
 
+/*
+ * Snapshot the poll schedule of a controller
+ * @param index     Controller index (0-3)
+ * @param stats     Output schedule statistics
+ * @return 0 on success, negative on invalid index
+ */
+int xbox_usb_get_poll_stats(int index, PollScheduleStats* stats);
+
 /*
  * Get controller slot information
  * @param index Controller index (0-3)
@@ -91,7 +138,8 @@ const XboxControllerSlot* xbox_usb_get_slot(int index);
 
 /*
  * Force rescan for controllers
- * Useful after USB device changes
+ * Hot-plug detection picks up changes on its own; this makes the next
+ * scan report every present device again.
  */
 void xbox_usb_rescan(void);
 
@@ -0,0 +1,65 @@
+/*
+ * User Routing
+ *
+ * Decides which PS4 user gets which virtual pad. The foreground user
+ * keeps the real DS4; every other logged-in user is given a player
+ * slot (virtual pad index) in login order and keeps it until logout,
+ * when the slot becomes free for the next login.
+ *
+ * The login/logout event queue belongs to the game, so the plugin never
+ * reads it on its own: the sceUserServiceGetEvent hook hands each event
+ * to the game unchanged and, unless the router thread is in the middle
+ * of a pass, applies it to the table in the same call, so a scePadOpen
+ * made right after the game sees a login is routed. The hook never
+ * blocks on the router thread. A background thread compares successive
+ * login lists (for games that never read events) and follows the
+ * foreground user, which has no event. The table is a latched seqlock
+ * (latched_slot.h), so scePadOpen_hook reads it with a copy and a
+ * compare and never calls the user service.
+ */
+
+#ifndef USER_ROUTER_H
+#define USER_ROUTER_H
+
+#include "config.h"
+#include <stdint.h>
+
+#include <orbis/UserService.h>
+
+/*
+ * Route table (immutable once published)
+ */
+typedef struct {
+    int32_t foreground;                     // Real DS4 user (0 = unknown)
+    int32_t players[MAX_XBOX_CONTROLLERS];  // User routed to each virtual pad (0 = free)
+} UserRoutes;
+
+/*
+ * Read the current logins and start following events
+ * The first table is published before this returns.
+ * @return 0 on success
+ */
+int user_router_start(void);
+
+void user_router_stop(void);
+
+/*
+ * Apply an event the game just received (sceUserServiceGetEvent hook,
+ * one game thread)
+ * The table is republished before this returns if it changed, or by
+ * the router thread's next pass if it was busy.
+ */
+void user_router_event(const OrbisUserServiceEvent* event);
+
+/*
+ * Copy the current table (any thread, wait-free)
+ */
+void user_router_get(UserRoutes* routes);
+
+/*
+ * Virtual pad index routed to a user (any thread, wait-free)
+ * @return Index, -1 for the foreground user or a user with no route
+ */
+int user_router_lookup(int32_t user_id);
+
+#endif // USER_ROUTER_H
@@ -90,6 +90,41 @@ typedef struct __attribute__((packed)) {
 #define XBOXONE_PID_SERIES_BT   0x0B13  // Xbox Series X|S controller (Bluetooth)
 #define XBOXONE_PID_2021        0x0B20  // 2021 Xbox controller
 
+/*
+ * Xbox One GIP rumble packet (13 bytes, OUT endpoint)
+ *
+ * Byte layout:
+ *   [0]     Command (0x09 = rumble)
+ *   [1]     Flags (0x00)
+ *   [2]     Sequence number
+ *   [3]     Payload length (9)
+ *   [4]     Unknown (0x00)
+ *   [5]     Motor mask (bit 0 right, 1 left, 2 right trigger, 3 left trigger)
+ *   [6-9]   Left trigger, right trigger, left, right motor (0-100)
+ *   [10]    On period (0xFF = until replaced)
+ *   [11]    Off period
+ *   [12]    Repeat count
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  command;
+    uint8_t  flags;
+    uint8_t  sequence;
+    uint8_t  length;
+    uint8_t  unknown;
+    uint8_t  motors;
+    uint8_t  left_trigger;
+    uint8_t  right_trigger;
+    uint8_t  left_motor;        // Large/low-frequency motor
+    uint8_t  right_motor;       // Small/high-frequency motor
+    uint8_t  on_period;
+    uint8_t  off_period;
+    uint8_t  repeat;
+} XboxOneRumblePacket;
+
+#define XBOXONE_CMD_RUMBLE      0x09
+#define XBOXONE_MOTORS_ALL      0x0F
+#define XBOXONE_RUMBLE_MAX      100
+
 /*
  * Utility functions (inline for performance)
  */
@@ -109,4 +144,22 @@ static inline uint8_t xboxone_trigger_to_8bit(uint16_t trigger) {
     return (uint8_t)(trigger >> 2);  // 1023 -> 255
 }
 
+// Initialize a rumble packet; motor input is 0-255 like the DS4
+static inline void xboxone_init_rumble(XboxOneRumblePacket* out, uint8_t sequence,
+                                       uint8_t left, uint8_t right) {
+    out->command = XBOXONE_CMD_RUMBLE;
+    out->flags = 0x00;
+    out->sequence = sequence;
+    out->length = (uint8_t)(sizeof(XboxOneRumblePacket) - 4);
+    out->unknown = 0x00;
+    out->motors = XBOXONE_MOTORS_ALL;
+    out->left_trigger = 0;
+    out->right_trigger = 0;
+    out->left_motor = (uint8_t)((left * XBOXONE_RUMBLE_MAX + 127) / 255);
+    out->right_motor = (uint8_t)((right * XBOXONE_RUMBLE_MAX + 127) / 255);
+    out->on_period = 0xFF;
+    out->off_period = 0x00;
+    out->repeat = 0xFF;
+}
+
 #endif // XBOXONE_H
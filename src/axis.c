@@ -0,0 +1,159 @@
+/*
+ * Analog Stick Processing Implementation
+ *
+ * The axial tables reproduce translator_apply_deadzone exactly for a
+ * linear curve (the integer rescale is kept and the curve is applied to
+ * its result), so the defaults are bit-identical to the old per-report
+ * path. Floating point is only used here, while building.
+ */
+
+#include "axis.h"
+#include "config.h"
+#include "lut.h"
+#include <math.h>
+#include <stddef.h>
+
+// ============================================
+// Compile-time defaults
+// ============================================
+
+#define AXIS_DEFAULT_SCALE(a) \
+    ((((a) - DEFAULT_STICK_DEADZONE) * 127) / (127 - DEFAULT_STICK_DEADZONE))
+
+#define AXIS_CLAMP(v)   ((v) < 0 ? 0 : ((v) > 255 ? 255 : (v)))
+
+#define AXIS_DEFAULT(u) \
+    ((u) >= 128 - DEFAULT_STICK_DEADZONE && (u) <= 128 + DEFAULT_STICK_DEADZONE ? 128 : \
+     AXIS_CLAMP((u) < 128 ? 128 - AXIS_DEFAULT_SCALE(128 - (u)) \
+                          : 128 + AXIS_DEFAULT_SCALE((u) - 128)))
+
+#define AXIS_DEFAULT_INVERTED(v)    AXIS_DEFAULT(255 - (v))
+
+const AxisTable g_axis_default = {
+    .mode = AXIS_DEADZONE_AXIAL,
+    .left = { .x = LUT_256(AXIS_DEFAULT), .y = LUT_256(AXIS_DEFAULT_INVERTED) },
+    .right = { .x = LUT_256(AXIS_DEFAULT), .y = LUT_256(AXIS_DEFAULT_INVERTED) },
+};
+
+const AxisTable g_axis_default_noninverted = {
+    .mode = AXIS_DEADZONE_AXIAL,
+    .left = { .x = LUT_256(AXIS_DEFAULT), .y = LUT_256(AXIS_DEFAULT) },
+    .right = { .x = LUT_256(AXIS_DEFAULT), .y = LUT_256(AXIS_DEFAULT) },
+};
+
+// ============================================
+// Runtime build
+// ============================================
+
+/*
+ * Response curve over normalized travel
+ * @param t     Travel outside the deadzone (0.0-1.0)
+ * @return      Output travel (0.0-1.0)
+ */
+static float curve_eval(const AxisConfig* config, float t) {
+    switch (config->curve) {
+    case AXIS_CURVE_EXPONENTIAL:
+        return (config->exponent > 0.0f) ? powf(t, config->exponent) : t;
+
+    case AXIS_CURVE_CUSTOM: {
+        float pos = t * (AXIS_CURVE_POINTS - 1);
+        int k = (int)pos;
+        if (k >= AXIS_CURVE_POINTS - 1) {
+            return config->points[AXIS_CURVE_POINTS - 1] / 127.0f;
+        }
+        float a = config->points[k];
+        float b = config->points[k + 1];
+        return (a + (b - a) * (pos - (float)k)) / 127.0f;
+    }
+
+    case AXIS_CURVE_LINEAR:
+    default:
+        return t;
+    }
+}
+
+/*
+ * Curve over integer half-axis travel 0-128
+ * 128 only occurs on the negative side (raw 0) and stays one past 127.
+ */
+static void build_curve(uint8_t curve[129], const AxisConfig* config) {
+    for (int i = 0; i < 128; i++) {
+        int v = (int)lroundf(curve_eval(config, i / 127.0f) * 127.0f);
+        curve[i] = (uint8_t)(v < 0 ? 0 : (v > 127 ? 127 : v));
+    }
+    curve[128] = (uint8_t)(curve[127] + 1);
+}
+
+static void build_axis(uint8_t out[256], const AxisConfig* config, const uint8_t curve[129],
+                       int invert) {
+    int deadzone = config->deadzone;
+
+    for (int v = 0; v < 256; v++) {
+        int u = invert ? 255 - v : v;
+
+        if (config->mode != AXIS_DEADZONE_AXIAL) {
+            out[v] = (uint8_t)u;
+            continue;
+        }
+
+        // Same integer rescale as translator_apply_deadzone
+        int centered = u - 128;
+        int magnitude = centered < 0 ? -centered : centered;
+        int scaled;
+        if (deadzone == 0) {
+            scaled = magnitude;
+        } else if (magnitude <= deadzone) {
+            scaled = 0;
+        } else {
+            scaled = ((magnitude - deadzone) * 127) / (127 - deadzone);
+        }
+        if (scaled > 128) {
+            scaled = 128;
+        }
+
+        int result = centered < 0 ? 128 - curve[scaled] : 128 + curve[scaled];
+        out[v] = (uint8_t)AXIS_CLAMP(result);
+    }
+}
+
+static void build_radial(uint16_t* gain, const AxisConfig* config) {
+    float deadzone = config->deadzone;
+
+    for (int i = 0; i < AXIS_RADIAL_ENTRIES; i++) {
+        // Middle of the squared-magnitude bucket
+        float magnitude = sqrtf((float)((i << AXIS_RADIAL_SHIFT) + (1 << AXIS_RADIAL_SHIFT) / 2));
+        float output;
+
+        if (magnitude <= deadzone) {
+            output = 0.0f;
+        } else if (config->mode == AXIS_DEADZONE_SCALED_RADIAL) {
+            float t = (magnitude - deadzone) / (127.0f - deadzone);
+            output = 127.0f * curve_eval(config, t > 1.0f ? 1.0f : t);
+        } else if (magnitude < 127.0f) {
+            output = 127.0f * curve_eval(config, magnitude / 127.0f);
+        } else {
+            // Past full throw (diagonals): unchanged
+            output = magnitude;
+        }
+
+        float value = output / magnitude * (float)(1 << AXIS_GAIN_BITS);
+        gain[i] = (uint16_t)(value > 65535.0f ? 65535 : lroundf(value));
+    }
+}
+
+void axis_build(AxisTable* table, uint16_t* radial_gain, const AxisConfig* config,
+                int invert_left_y, int invert_right_y) {
+    uint8_t curve[129];
+
+    build_curve(curve, config);
+
+    table->mode = config->mode;
+    build_axis(table->left.x, config, curve, 0);
+    build_axis(table->left.y, config, curve, invert_left_y);
+    build_axis(table->right.x, config, curve, 0);
+    build_axis(table->right.y, config, curve, invert_right_y);
+
+    if (config->mode != AXIS_DEADZONE_AXIAL && radial_gain != NULL) {
+        build_radial(radial_gain, config);
+    }
+}
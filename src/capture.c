@@ -0,0 +1,164 @@
+/*
+ * Raw Report Capture Implementation
+ *
+ * Single-producer ring of variable-size records: the poll thread copies
+ * a record in (wrapping at most once) and publishes it by advancing
+ * head; the writer thread wakes every CAPTURE_FLUSH_INTERVAL_US and
+ * writes everything between tail and head with at most two fwrite
+ * calls, so the file sees few large writes.
+ */
+
+#include "capture.h"
+#include <stdio.h>
+#include <string.h>
+
+#include <orbis/libkernel.h>
+
+#include <pthread.h>
+
+#define CAPTURE_RING_MASK   (CAPTURE_RING_BYTES - 1)
+
+volatile int g_capture_active = 0;
+
+static CaptureRing  g_ring;
+static FILE*        g_file = NULL;
+static pthread_t    g_writer_thread;
+static volatile int g_writer_running = 0;
+
+// Copy into the ring at an absolute byte position, wrapping once
+static void ring_copy_in(uint64_t position, const void* source, uint32_t length) {
+    uint32_t start = (uint32_t)(position & CAPTURE_RING_MASK);
+    uint32_t tail = CAPTURE_RING_BYTES - start;
+
+    if (length <= tail) {
+        memcpy(&g_ring.data[start], source, length);
+    } else {
+        memcpy(&g_ring.data[start], source, tail);
+        memcpy(&g_ring.data[0], (const uint8_t*)source + tail, length - tail);
+    }
+}
+
+void capture_write(int controller, int type, const uint8_t* data, int32_t length) {
+    if (length < 0) {
+        return;
+    }
+    if (length > 255) {
+        length = 255;
+    }
+
+    uint64_t head = g_ring.head;
+    uint64_t tail = __atomic_load_n(&g_ring.tail, __ATOMIC_ACQUIRE);
+    uint32_t size = (uint32_t)(sizeof(CaptureRecord) + (uint32_t)length);
+
+    if (CAPTURE_RING_BYTES - (head - tail) < size) {
+        __atomic_fetch_add(&g_ring.dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    uint64_t now = sceKernelGetProcessTime();
+    uint64_t delta = now - g_ring.last_us;
+    g_ring.last_us = now;
+
+    CaptureRecord record;
+    record.delta_us = delta > UINT32_MAX ? UINT32_MAX : (uint32_t)delta;
+    record.controller = (uint8_t)controller;
+    record.type = (uint8_t)type;
+    record.length = (uint8_t)length;
+    record.reserved = 0;
+
+    ring_copy_in(head, &record, sizeof(record));
+    ring_copy_in(head + sizeof(record), data, (uint32_t)length);
+    __atomic_store_n(&g_ring.head, head + size, __ATOMIC_RELEASE);
+}
+
+// Write everything published so far (writer thread, or after it stopped)
+static void drain(void) {
+    uint64_t head = __atomic_load_n(&g_ring.head, __ATOMIC_ACQUIRE);
+    uint64_t tail = g_ring.tail;
+
+    if (head == tail) {
+        return;
+    }
+
+    uint32_t start = (uint32_t)(tail & CAPTURE_RING_MASK);
+    uint64_t count = head - tail;
+    uint32_t first = CAPTURE_RING_BYTES - start;
+
+    if (count <= first) {
+        fwrite(&g_ring.data[start], 1, (size_t)count, g_file);
+    } else {
+        fwrite(&g_ring.data[start], 1, first, g_file);
+        fwrite(&g_ring.data[0], 1, (size_t)(count - first), g_file);
+    }
+    fflush(g_file);
+
+    __atomic_store_n(&g_ring.tail, head, __ATOMIC_RELEASE);
+}
+
+static void* writer_thread_func(void* arg) {
+    (void)arg;
+
+    while (g_writer_running) {
+        sceKernelUsleep(CAPTURE_FLUSH_INTERVAL_US);
+        drain();
+    }
+    return NULL;
+}
+
+int capture_start(const char* path) {
+    if (g_capture_active || g_writer_running) {
+        return -1;
+    }
+
+    g_file = fopen(path, "wb");
+    if (g_file == NULL) {
+        return -2;
+    }
+
+    uint64_t now = sceKernelGetProcessTime();
+    CaptureFileHeader header;
+    memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_VERSION;
+    header.header_size = sizeof(CaptureFileHeader);
+    header.start_us = now;
+    if (fwrite(&header, sizeof(header), 1, g_file) != 1) {
+        fclose(g_file);
+        g_file = NULL;
+        return -3;
+    }
+
+    g_ring.head = 0;
+    g_ring.tail = 0;
+    g_ring.last_us = now;
+    g_ring.dropped = 0;
+
+    g_writer_running = 1;
+    if (pthread_create(&g_writer_thread, NULL, writer_thread_func, NULL) != 0) {
+        g_writer_running = 0;
+        fclose(g_file);
+        g_file = NULL;
+        return -4;
+    }
+
+    g_capture_active = 1;
+    return 0;
+}
+
+void capture_stop(void) {
+    if (!g_writer_running) {
+        return;
+    }
+
+    // Records written after this point are lost; the poller may still be running
+    g_capture_active = 0;
+    g_writer_running = 0;
+    pthread_join(g_writer_thread, NULL);
+
+    drain();
+    fclose(g_file);
+    g_file = NULL;
+}
+
+uint64_t capture_dropped(void) {
+    return __atomic_load_n(&g_ring.dropped, __ATOMIC_RELAXED);
+}
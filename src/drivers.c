@@ -0,0 +1,181 @@
+/*
+ * Controller Driver Registry Implementation
+ *
+ * One ControllerDriver per pad family, and the VID/PID hash table that
+ * maps devices to them. To support a new pad, add its driver (or reuse
+ * one that speaks the same protocol) and one DRIVER_ID line per VID/PID.
+ */
+
+#include "drivers.h"
+#include <string.h>
+
+// ============================================
+// Xbox 360 (wired)
+// ============================================
+
+static DriverDecodeResult xbox360_decode(DriverState* state, const uint8_t* data, int32_t length,
+                                         uint64_t now) {
+    (void)state; (void)now;
+    // msg_type=0x00, msg_length=0x14; other messages are LED/status
+    return (length >= XBOX360_REPORT_SIZE && data[0] == 0x00) ? DRIVER_DECODE_REPORT : DRIVER_DECODE_NONE;
+}
+
+static void xbox360_translate(const DriverState* state, const TranslatorTables* tables,
+                              const XboxRawReport* report, PadState* out) {
+    (void)state;
+    translator_decode(&report->xbox360, out, tables);
+}
+
+static int xbox360_rumble(DriverState* state, uint8_t left, uint8_t right, uint8_t* packet) {
+    (void)state;
+    xbox360_init_rumble((Xbox360OutputReport*)packet, left, right);
+    return (int)sizeof(Xbox360OutputReport);
+}
+
+static const ControllerDriver g_driver_xbox360 = {
+    .name = "Xbox 360",
+    .type = CONTROLLER_XBOX360,
+    .endpoint_in = XBOX360_ENDPOINT_IN,
+    .endpoint_out = XBOX360_ENDPOINT_OUT,
+    .compare_offset = 0,
+    .start = NULL,
+    .decode = xbox360_decode,
+    .translate = xbox360_translate,
+    .rumble = xbox360_rumble,
+    .keepalive = NULL,
+};
+
+// ============================================
+// Xbox One / Series (GIP)
+// ============================================
+
+// Input reports only start after the power on command
+static void xboxone_start(DriverState* state, uint64_t now, GipPacket* init) {
+    gip_reset(&state->gip);
+    gip_power_on(&state->gip, now, init);
+}
+
+static DriverDecodeResult xboxone_decode(DriverState* state, const uint8_t* data, int32_t length,
+                                         uint64_t now) {
+    GipPacket reply;
+    reply.length = 0;
+
+    GipResult result = gip_receive(&state->gip, data, length, now, &reply);
+    if (reply.length) {
+        driver_queue_control(state, &reply);
+    }
+
+    switch (result) {
+        case GIP_RESULT_INPUT:
+            return DRIVER_DECODE_REPORT;
+        case GIP_RESULT_GUIDE:
+            return DRIVER_DECODE_REPEAT;
+        default:
+            return DRIVER_DECODE_NONE;
+    }
+}
+
+// The Guide button arrives in its own packet and acts as PS
+static void xboxone_translate(const DriverState* state, const TranslatorTables* tables,
+                              const XboxRawReport* report, PadState* out) {
+    translator_decode_xboxone(&report->xboxone, out, tables);
+    if (state->gip.guide) {
+        out->buttons |= DS4_BUTTON_PS;
+    }
+}
+
+static int xboxone_rumble(DriverState* state, uint8_t left, uint8_t right, uint8_t* packet) {
+    xboxone_init_rumble((XboxOneRumblePacket*)packet, gip_next_sequence(&state->gip), left, right);
+    return (int)sizeof(XboxOneRumblePacket);
+}
+
+// Re-send power on to a pad that never answered
+static void xboxone_keepalive(DriverState* state, uint64_t now) {
+    GipPacket power_on;
+
+    if (state->control_count == 0 && gip_keepalive(&state->gip, now, &power_on)) {
+        driver_queue_control(state, &power_on);
+    }
+}
+
+static const ControllerDriver g_driver_xboxone = {
+    .name = "Xbox One",
+    .type = CONTROLLER_XBOXONE,
+    .endpoint_in = 0x82,
+    .endpoint_out = 0x02,
+    .compare_offset = GIP_HEADER_SIZE,     // Sequence counter
+    .start = xboxone_start,
+    .decode = xboxone_decode,
+    .translate = xboxone_translate,
+    .rumble = xboxone_rumble,
+    .keepalive = xboxone_keepalive,
+};
+
+// ============================================
+// Switch input-only (PDP)
+// ============================================
+
+static DriverDecodeResult switch_decode(DriverState* state, const uint8_t* data, int32_t length,
+                                        uint64_t now) {
+    (void)state; (void)data; (void)now;
+    // 7 bytes, no report ID filtering needed
+    return length >= SWITCH_INPUT_ONLY_REPORT_SIZE ? DRIVER_DECODE_REPORT : DRIVER_DECODE_NONE;
+}
+
+static void switch_translate(const DriverState* state, const TranslatorTables* tables,
+                             const XboxRawReport* report, PadState* out) {
+    (void)state;
+    translator_decode_switch(&report->switch_report, out, tables);
+}
+
+static const ControllerDriver g_driver_switch = {
+    .name = "Switch controller",
+    .type = CONTROLLER_SWITCH,
+    .endpoint_in = XBOX360_ENDPOINT_IN,
+    .endpoint_out = XBOX360_ENDPOINT_OUT,
+    .compare_offset = 0,
+    .start = NULL,
+    .decode = switch_decode,
+    .translate = switch_translate,
+    .rumble = NULL,
+    .keepalive = NULL,
+};
+
+// ============================================
+// VID/PID table
+// ============================================
+
+#define DRIVER_ID(vid, pid, driver) [DRIVER_HASH(vid, pid)] = { (vid), (pid), (driver) }
+
+const DriverId g_driver_ids[DRIVER_HASH_SIZE] = {
+    // The 360 wireless receiver speaks a different protocol and is not supported
+    DRIVER_ID(XBOX360_VID, XBOX360_PID_WIRED, &g_driver_xbox360),
+
+    DRIVER_ID(0x045E, 0x02D1, &g_driver_xboxone),   // Original Xbox One controller
+    DRIVER_ID(0x045E, 0x02DD, &g_driver_xboxone),   // Xbox One controller (newer)
+    DRIVER_ID(0x045E, 0x02E3, &g_driver_xboxone),   // Xbox Elite controller
+    DRIVER_ID(0x045E, 0x02EA, &g_driver_xboxone),   // Xbox One S controller
+    DRIVER_ID(0x045E, 0x0B00, &g_driver_xboxone),   // Xbox Elite 2 controller
+    DRIVER_ID(0x045E, 0x0B12, &g_driver_xboxone),   // Xbox Series X|S controller (USB)
+    DRIVER_ID(0x045E, 0x0B20, &g_driver_xboxone),   // 2021 Xbox controller
+
+    DRIVER_ID(SWITCH_ROCKCAND_VID, SWITCH_ROCKCANDY_PID, &g_driver_switch),    // PDP Rock Candy
+    DRIVER_ID(0x0E6F, 0x0180, &g_driver_switch),    // PDP Faceoff Wired Pro
+    DRIVER_ID(0x0E6F, 0x0181, &g_driver_switch),    // PDP Faceoff Deluxe Wired Pro
+    DRIVER_ID(0x0E6F, 0x0185, &g_driver_switch),    // PDP Wired Fight Pad Pro
+};
+
+static const ControllerDriver* const g_drivers[] = {
+    &g_driver_xbox360,
+    &g_driver_xboxone,
+    &g_driver_switch,
+};
+
+const ControllerDriver* driver_for_type(ControllerType type) {
+    for (size_t i = 0; i < sizeof(g_drivers) / sizeof(g_drivers[0]); i++) {
+        if (g_drivers[i]->type == type) {
+            return g_drivers[i];
+        }
+    }
+    return NULL;
+}
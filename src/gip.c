@@ -0,0 +1,168 @@
+/*
+ * Xbox One Gaming Input Protocol (GIP) Engine Implementation
+ *
+ * Handlers are looked up by command byte in a constant table, so an
+ * unknown command costs one load and a NULL check. Sequence numbers are
+ * tracked per command: a packet whose number equals the last one seen
+ * is a retransmission, one slightly behind it arrived out of order.
+ * Anything further behind is taken as the counter restarting.
+ */
+
+#include "gip.h"
+#include "xboxone.h"
+#include <string.h>
+
+typedef GipResult (*GipHandler)(GipState* gip, const uint8_t* data, int32_t length,
+                                uint64_t now, GipPacket* reply);
+
+// ============================================
+// Command handlers
+// ============================================
+
+// 0x20: controller state, translated by the caller
+static GipResult handle_input(GipState* gip, const uint8_t* data, int32_t length,
+                              uint64_t now, GipPacket* reply) {
+    (void)gip; (void)data; (void)now; (void)reply;
+    return length >= (int32_t)sizeof(XboxOneReport) ? GIP_RESULT_INPUT : GIP_RESULT_NONE;
+}
+
+// 0x07: Guide button, payload bit 0 = pressed
+static GipResult handle_guide(GipState* gip, const uint8_t* data, int32_t length,
+                              uint64_t now, GipPacket* reply) {
+    (void)now; (void)reply;
+    if (length < GIP_HEADER_SIZE + 1) {
+        return GIP_RESULT_NONE;
+    }
+
+    uint8_t pressed = data[GIP_HEADER_SIZE] & 0x01;
+    if (pressed == gip->guide) {
+        return GIP_RESULT_NONE;
+    }
+    gip->guide = pressed;
+    return GIP_RESULT_GUIDE;
+}
+
+// 0x02: the controller (re)started and waits for power on again
+static GipResult handle_announce(GipState* gip, const uint8_t* data, int32_t length,
+                                 uint64_t now, GipPacket* reply) {
+    (void)data; (void)length;
+
+    // Its counters restart too
+    memset(gip->seen, 0, sizeof(gip->seen));
+    gip->guide = 0;
+    gip_power_on(gip, now, reply);
+    return GIP_RESULT_ANNOUNCE;
+}
+
+// 0x03: battery and heartbeat; receiving it is all that matters
+static GipResult handle_status(GipState* gip, const uint8_t* data, int32_t length,
+                               uint64_t now, GipPacket* reply) {
+    (void)gip; (void)data; (void)length; (void)now; (void)reply;
+    return GIP_RESULT_NONE;
+}
+
+static const GipHandler g_gip_handlers[256] = {
+    [GIP_CMD_ANNOUNCE] = handle_announce,
+    [GIP_CMD_STATUS]   = handle_status,
+    [GIP_CMD_GUIDE]    = handle_guide,
+    [GIP_CMD_INPUT]    = handle_input,
+};
+
+// ============================================
+// Sequence tracking and replies
+// ============================================
+
+/*
+ * Accept a sequence number for a command
+ * @return 1 if the packet is new, 0 if it is a duplicate or stale
+ */
+static int sequence_fresh(GipState* gip, uint8_t command, uint8_t sequence) {
+    uint8_t bit = (uint8_t)(1u << (command & 7));
+    uint8_t* seen = &gip->seen[command >> 3];
+
+    if (*seen & bit) {
+        uint8_t behind = (uint8_t)(gip->last_sequence[command] - sequence);
+        if (behind == 0) {
+            gip->duplicates++;
+            return 0;
+        }
+        if (behind < GIP_STALE_WINDOW) {
+            gip->stale++;
+            return 0;
+        }
+    }
+
+    *seen |= bit;
+    gip->last_sequence[command] = sequence;
+    return 1;
+}
+
+/*
+ * ACK a packet: echoes its command, sequence number and payload length
+ */
+static void build_ack(GipState* gip, const uint8_t* data, GipPacket* out) {
+    static const uint8_t template[13] = {
+        GIP_CMD_ACK, GIP_FLAG_INTERNAL, 0x00, 0x09,
+        0x00, 0x00, GIP_FLAG_INTERNAL, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+
+    memcpy(out->data, template, sizeof(template));
+    out->data[2] = data[2];
+    out->data[5] = data[0];
+    out->data[7] = data[3];
+    out->length = (int)sizeof(template);
+    gip->acks++;
+}
+
+// ============================================
+// Public API
+// ============================================
+
+void gip_reset(GipState* gip) {
+    memset(gip, 0, sizeof(*gip));
+    gip->out_sequence = 1;
+}
+
+void gip_power_on(GipState* gip, uint64_t now, GipPacket* out) {
+    out->data[0] = GIP_CMD_POWER;
+    out->data[1] = GIP_FLAG_INTERNAL;
+    out->data[2] = gip_next_sequence(gip);
+    out->data[3] = 0x01;
+    out->data[4] = 0x00;    // Power on
+    out->length = 5;
+
+    gip->answered = 0;
+    gip->power_on_us = now;
+    gip->power_ons++;
+}
+
+GipResult gip_receive(GipState* gip, const uint8_t* data, int32_t length, uint64_t now,
+                      GipPacket* reply) {
+    if (length < GIP_HEADER_SIZE) {
+        return GIP_RESULT_NONE;
+    }
+
+    uint8_t command = data[0];
+    gip->answered = 1;
+
+    // ACK even retransmissions: the pad resends until it gets one
+    if (data[1] & GIP_FLAG_ACK) {
+        build_ack(gip, data, reply);
+    }
+
+    if (command != GIP_CMD_ANNOUNCE && !sequence_fresh(gip, command, data[2])) {
+        return GIP_RESULT_NONE;
+    }
+
+    GipHandler handler = g_gip_handlers[command];
+    return handler ? handler(gip, data, length, now, reply) : GIP_RESULT_NONE;
+}
+
+int gip_keepalive(GipState* gip, uint64_t now, GipPacket* out) {
+    if (gip->answered || gip->power_on_us == 0 || now - gip->power_on_us < GIP_POWER_ON_RETRY_US) {
+        return 0;
+    }
+
+    gip_power_on(gip, now, out);
+    return 1;
+}
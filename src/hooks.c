@@ -1,9 +1,10 @@
 /*
  * Hybrid approach: Hook scePad like gamepad_helper does
- * Read Xbox controller via USB, inject into scePadReadState
+ * Xbox controller state comes from the USB polling engine (usb_xbox.c),
+ * hooks inject it into scePadRead/scePadReadState
  *
  * STABILITY: All initialization done upfront in plugin_load,
- * hooks only do lightweight data injection
+ * hooks only copy published snapshots and never touch USB
  */
 
 #include "hooks.h"
@@ -13,16 +14,18 @@
 #include "xboxone.h"
 #include "switch_controller.h"
 #include "usb_xbox.h"
+#include "notify.h"
+#include "user_router.h"
 
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <pthread.h>
 
 #include <orbis/libkernel.h>
 #include <orbis/Pad.h>
-#include <orbis/Usbd.h>
 #include <orbis/UserService.h>
 
 #include <GoldHEN.h>
@@ -36,17 +39,12 @@ extern int32_t scePadReadStateExt(int32_t handle, OrbisPadData* pData);
 extern int sys_dynlib_load_prx(const char* path, int* handle);
 extern const char* sceKernelGetFsSandboxRandomWord(void);
 
-// Virtual controller constants
-#define XBOX_VIRTUAL_PAD_HANDLE 1001        // Our fake pad handle
-
-// Auto-detected user ID for Player 2 (set during init)
-static int32_t g_xbox_user_id = 0;
-
 // Function pointer types for HOOK_CONTINUE
 typedef int32_t (*scePadOpen_t)(int32_t, int32_t, int32_t, void*);
 typedef int32_t (*scePadClose_t)(int32_t);
 typedef int32_t (*scePadGetControllerInformation_t)(int32_t, OrbisPadInformation*);
-typedef int32_t (*sceUserServiceGetLoginUserIdList_t)(OrbisUserServiceLoginUserIdList*);
+typedef int32_t (*scePadSetVibration_t)(int32_t, const OrbisPadVibeParam*);
+typedef int32_t (*sceUserServiceGetEvent_t)(OrbisUserServiceEvent*);
 
 // Hooks for pad and user service functions
 HOOK_INIT(scePadRead);
@@ -54,7 +52,8 @@ HOOK_INIT(scePadReadState);
 HOOK_INIT(scePadOpen);
 HOOK_INIT(scePadClose);
 HOOK_INIT(scePadGetControllerInformation);
-HOOK_INIT(sceUserServiceGetLoginUserIdList);
+HOOK_INIT(scePadSetVibration);
+HOOK_INIT(sceUserServiceGetEvent);
 
 // Patchers
 static Patcher* g_padReadExtPatcher = NULL;
@@ -67,85 +66,20 @@ static int g_pad_prx_loaded = 0;
 static int g_usb_prx_loaded = 0;
 static int g_user_prx_loaded = 0;
 
-// Virtual controller state
-static int g_virtual_pad_open = 0;      // Is our virtual pad currently open?
-static int g_xbox_connected = 0;        // Is Xbox controller physically connected?
-static ControllerType g_controller_type = CONTROLLER_NONE;  // Which controller type
-
-// USB device handle for Xbox controller
-static libusb_device_handle* g_xbox_handle = NULL;
-
-// Xbox controller VID (Microsoft)
-#define XBOX_VID 0x045E
-
-// PDP controller VID (Performance Designed Products)
-#define PDP_VID 0x0E6F
-
-// Xbox 360 PIDs
-#define XBOX360_PID 0x028E
-
-// Xbox One PIDs (multiple variants)
-static const uint16_t XBOXONE_PIDS[] = {
-    0x02D1,  // Original Xbox One controller
-    0x02DD,  // Xbox One controller (newer)
-    0x02E3,  // Xbox Elite controller
-    0x02EA,  // Xbox One S controller
-    0x0B00,  // Xbox Elite 2 controller
-    0x0B12,  // Xbox Series X|S controller (USB)
-    0x0B20,  // 2021 Xbox controller
-};
-#define XBOXONE_PID_COUNT (sizeof(XBOXONE_PIDS) / sizeof(XBOXONE_PIDS[0]))
-
-// Check if PID is an Xbox One controller
-static int is_xboxone_pid(uint16_t pid) {
-    for (size_t i = 0; i < XBOXONE_PID_COUNT; i++) {
-        if (XBOXONE_PIDS[i] == pid) return 1;
-    }
-    return 0;
-}
-
-// PDP Switch Input-Only controller PIDs
-static const uint16_t PDP_SWITCH_PIDS[] = {
-    0x0187,  // PDP Rock Candy Wired Controller
-    0x0180,  // PDP Faceoff Wired Pro Controller
-    0x0181,  // PDP Faceoff Deluxe Wired Pro Controller
-    0x0185,  // PDP Wired Fight Pad Pro
-};
-#define PDP_SWITCH_PID_COUNT (sizeof(PDP_SWITCH_PIDS) / sizeof(PDP_SWITCH_PIDS[0]))
-
-// Check if PID is a PDP Switch controller
-static int is_pdp_switch_pid(uint16_t pid) {
-    for (size_t i = 0; i < PDP_SWITCH_PID_COUNT; i++) {
-        if (PDP_SWITCH_PIDS[i] == pid) return 1;
-    }
-    return 0;
-}
-
-// Xbox One initialization command - must be sent to start input reports
-static const uint8_t XBOXONE_INIT_CMD[] = { 0x05, 0x20, 0x00, 0x01, 0x00 };
-
-// Send initialization command to Xbox One controller
-static int xboxone_send_init(libusb_device_handle* handle) {
-    int32_t transferred = 0;
-    // Send to OUT endpoint (0x02 for Xbox One/Series)
-    return sceUsbdInterruptTransfer(
-        handle,
-        0x02,  // EP2 OUT
-        (unsigned char*)XBOXONE_INIT_CMD,
-        sizeof(XBOXONE_INIT_CMD),
-        &transferred,
-        100  // 100ms timeout
-    );
-}
+/*
+ * Virtual pad table, indexed by HANDLE_TO_INDEX(handle)
+ * Entry i belongs to the user the router gives player slot i and binds
+ * that user to one USB controller slot. Written only under g_pad_table_lock (open/close),
+ * read lock-free by the read hooks.
+ */
+typedef struct {
+    volatile int     open;          // Handle handed out by scePadOpen
+    volatile int32_t user_id;       // Owning user (0 = unassigned)
+    volatile int     controller;    // usb_xbox controller index
+} VirtualPad;
 
-static void hook_notify(const char* message) {
-    OrbisNotificationRequest req;
-    memset(&req, 0, sizeof(req));
-    req.type = NotificationRequest;
-    req.targetId = -1;
-    strncpy(req.message, message, sizeof(req.message) - 1);
-    sceKernelSendNotificationRequest(0, &req, sizeof(req), 0);
-}
+static VirtualPad      g_virtual_pads[MAX_XBOX_CONTROLLERS];
+static pthread_mutex_t g_pad_table_lock = PTHREAD_MUTEX_INITIALIZER;
 
 // Initialize USB subsystem - call ONCE from plugin_load, NOT from hooks
 int hooks_init_usb(void) {
@@ -162,222 +96,103 @@ int hooks_init_usb(void) {
     }
     g_usb_prx_loaded = 1;
 
-    // Init USB subsystem
-    ret = sceUsbdInit();
-    if (ret != 0) {
+    // Init USB subsystem and scan for controllers (360, One, Switch)
+    if (xbox_usb_init() != 0) {
         return -1;
     }
     g_usb_initialized = 1;
 
-    // Scan for Xbox controllers (360 and One)
-    libusb_device** dev_list = NULL;
-    int32_t dev_count = sceUsbdGetDeviceList(&dev_list);
-    if (dev_count <= 0 || dev_list == NULL) {
-        // No USB devices - that's okay
-        return 0;
-    }
-
-    // Look for supported controllers
-    for (int i = 0; i < dev_count; i++) {
-        struct libusb_device_descriptor desc;
-        if (sceUsbdGetDeviceDescriptor(dev_list[i], &desc) == 0) {
-            ControllerType detected_type = CONTROLLER_NONE;
-            const char* controller_name = NULL;
-
-            // Check Xbox controllers (VID 0x045E)
-            if (desc.idVendor == XBOX_VID) {
-                // Check Xbox 360
-                if (desc.idProduct == XBOX360_PID) {
-                    detected_type = CONTROLLER_XBOX360;
-                    controller_name = "Xbox 360 connected!";
-                }
-                // Check Xbox One variants
-                else if (is_xboxone_pid(desc.idProduct)) {
-                    detected_type = CONTROLLER_XBOXONE;
-                    controller_name = "Xbox One connected!";
-                }
-            }
-            // Check PDP Switch controllers (VID 0x0E6F)
-            else if (desc.idVendor == PDP_VID) {
-                if (is_pdp_switch_pid(desc.idProduct)) {
-                    detected_type = CONTROLLER_SWITCH;
-                    controller_name = "Switch controller connected!";
-                }
-            }
-
-            if (detected_type != CONTROLLER_NONE) {
-                ret = sceUsbdOpen(dev_list[i], &g_xbox_handle);
-                if (ret == 0 && g_xbox_handle != NULL) {
-                    // Try to detach kernel driver if attached
-                    sceUsbdDetachKernelDriver(g_xbox_handle, 0);
-
-                    ret = sceUsbdClaimInterface(g_xbox_handle, 0);
-                    if (ret == 0) {
-                        g_xbox_connected = 1;
-                        g_controller_type = detected_type;
-
-                        // Xbox One needs init command to start sending input
-                        if (detected_type == CONTROLLER_XBOXONE) {
-                            // Set alternate interface setting 0
-                            sceUsbdSetInterfaceAltSetting(g_xbox_handle, 0, 0);
-                            xboxone_send_init(g_xbox_handle);
-                        }
-
-                        hook_notify(controller_name);
-                        sceUsbdFreeDeviceList(dev_list);
-                        return 0;
-                    }
-                    sceUsbdClose(g_xbox_handle);
-                    g_xbox_handle = NULL;
-                }
-            }
-        }
+    // All transfers from here on run on the polling thread
+    if (xbox_usb_start_polling() != 0) {
+        return -1;
     }
 
-    sceUsbdFreeDeviceList(dev_list);
     return 0;  // USB init succeeded even if no Xbox found
 }
 
-// Cached foreground user ID (Player 1)
-static int32_t g_foreground_user_id = 0;
-
-// Get the foreground user (lazy, cached)
-static int32_t get_foreground_user(void) {
-    if (g_foreground_user_id == 0) {
-        sceUserServiceGetForegroundUser(&g_foreground_user_id);
-    }
-    return g_foreground_user_id;
-}
-
-// Auto-detect second user for Player 2
-// Called lazily when scePadOpen is called for a non-foreground user
-int hooks_detect_second_user(void) {
-    // Just cache the foreground user at init time
-    int32_t fg = 0;
-    int32_t ret = sceUserServiceGetForegroundUser(&fg);
-    if (ret == 0 && fg != 0) {
-        g_foreground_user_id = fg;
-        return 0;
+// Look up the open virtual pad for a handle - O(1), NULL for real handles
+static inline VirtualPad* lookup_virtual_pad(int32_t handle) {
+    if (!IS_VIRTUAL_HANDLE(handle)) {
+        return NULL;
     }
-    return -1;
+    VirtualPad* pad = &g_virtual_pads[HANDLE_TO_INDEX(handle)];
+    return pad->open ? pad : NULL;
 }
 
-// Cached controller reports - updated by polling, read by hooks
-static union {
-    Xbox360Report xbox360;
-    XboxOneReport xboxone;
-    SwitchInputOnlyReport switch_report;
-    uint8_t raw[64];  // Large enough for any report
-} g_cached_xbox_report;
-static volatile int g_has_xbox_data = 0;
-static uint64_t g_last_read_time = 0;
-static int g_xbox_active = 0;
-
-// Helper to inject Xbox data into pad data
-// STABILITY: No initialization here - just read if connected
-static void inject_xbox_input(OrbisPadData* pData) {
-    // Only try to read if Xbox handle is valid (set during plugin_load)
-    if (g_xbox_handle == NULL || g_controller_type == CONTROLLER_NONE) {
-        return;  // No Xbox connected, pass through DS4 data unchanged
+// Fill pad data from the latest snapshot published by the polling thread
+// STABILITY: Never touches USB - only copies already translated state
+static void fill_xbox_pad_data(int controller, OrbisPadData* pData) {
+    if (xbox_usb_read_state(controller, pData) == 0) {
+        return;
     }
 
-    uint64_t now = sceKernelGetProcessTime();
-
-    // Read every 1ms (1000Hz)
-    if (now - g_last_read_time > 1000) {
-        g_last_read_time = now;
-
-        int32_t transferred = 0;
-
-        // Read from interrupt endpoint
-        // Xbox 360 & Switch: EP1 IN (0x81), Xbox One/Series: EP2 IN (0x82)
-        uint8_t in_endpoint = (g_controller_type == CONTROLLER_XBOXONE) ? 0x82 : 0x81;
-
-        int ret = sceUsbdInterruptTransfer(
-            g_xbox_handle,
-            in_endpoint,
-            g_cached_xbox_report.raw,
-            sizeof(g_cached_xbox_report.raw),
-            &transferred,
-            2  // 2ms timeout
-        );
-
-        if (ret == 0) {
-            int valid_report = 0;
-
-            if (g_controller_type == CONTROLLER_XBOX360 && transferred >= 20) {
-                // Xbox 360: msg_type=0x00, msg_length=0x14
-                if (g_cached_xbox_report.xbox360.msg_type == 0x00) {
-                    valid_report = 1;
-                }
-            } else if (g_controller_type == CONTROLLER_XBOXONE && transferred >= 18) {
-                // Xbox One: report_type=0x20 for input
-                if (g_cached_xbox_report.xboxone.report_type == XBOXONE_REPORT_INPUT) {
-                    valid_report = 1;
-                }
-            } else if (g_controller_type == CONTROLLER_SWITCH && transferred >= SWITCH_INPUT_ONLY_REPORT_SIZE) {
-                // Switch Input-Only: 7 bytes, no report ID filtering needed
-                valid_report = 1;
-            }
+    // No report yet - neutral state
+    memset(pData, 0, sizeof(OrbisPadData));
+    pData->connected = xbox_usb_is_connected(controller) ? 1 : 0;
+    pData->timestamp = sceKernelGetProcessTime();
+    pData->leftStick.x = 128;
+    pData->leftStick.y = 128;
+    pData->rightStick.x = 128;
+    pData->rightStick.y = 128;
+}
 
-            if (valid_report) {
-                if (!g_xbox_active) {
-                    g_xbox_active = 1;
-                    hook_notify("Controller input active!");
-                }
-                g_has_xbox_data = 1;
-            }
-        }
-    }
+// ============================================
+// Pad Open/Close Hooks - Handle virtual controller
+// ============================================
 
-    // Use cached data for translation based on controller type
-    if (g_has_xbox_data) {
-        if (g_controller_type == CONTROLLER_XBOX360) {
-            xbox360_to_ds4(&g_cached_xbox_report.xbox360, pData);
-        } else if (g_controller_type == CONTROLLER_XBOXONE) {
-            xboxone_to_ds4(&g_cached_xbox_report.xboxone, pData);
-        } else if (g_controller_type == CONTROLLER_SWITCH) {
-            switch_to_ds4(&g_cached_xbox_report.switch_report, pData);
+// Check if a USB controller is already routed to an open virtual pad
+static int controller_is_assigned(int controller) {
+    for (int i = 0; i < MAX_XBOX_CONTROLLERS; i++) {
+        if (g_virtual_pads[i].open && g_virtual_pads[i].controller == controller) {
+            return 1;
         }
     }
+    return 0;
 }
 
-// ============================================
-// User Service Hook - Inject virtual user
-// ============================================
-
-int32_t sceUserServiceGetLoginUserIdList_hook(OrbisUserServiceLoginUserIdList* userIdList) {
-    // Call original first via HOOK_CONTINUE
-    int32_t ret = HOOK_CONTINUE(sceUserServiceGetLoginUserIdList, sceUserServiceGetLoginUserIdList_t, userIdList);
-    if (ret != 0 || userIdList == NULL) {
-        return ret;
+// Open the virtual pad the router gave a user
+// @return Virtual handle, or -1 if no free connected controller
+static int32_t open_virtual_pad(int slot, int32_t userId) {
+    int32_t handle = -1;
+    VirtualPad* pad = &g_virtual_pads[slot];
+
+    pthread_mutex_lock(&g_pad_table_lock);
+
+    if (pad->open) {
+        // Same user opening again, or the slot changed hands after a
+        // logout the game never closed: keep the controller either way
+        pad->user_id = userId;
+        handle = INDEX_TO_HANDLE(slot);
+    } else {
+        // First connected controller nobody else is using
+        for (int c = 0; c < MAX_XBOX_CONTROLLERS; c++) {
+            if (xbox_usb_is_connected(c) && !controller_is_assigned(c)) {
+                pad->user_id = userId;
+                pad->controller = c;
+                pad->open = 1;
+                handle = INDEX_TO_HANDLE(slot);
+
+                char message[64];
+                snprintf(message, sizeof(message), "Xbox Player %d ready!", slot + 2);
+                notify_post(message);
+                break;
+            }
+        }
     }
 
-    // With auto-detect, we use an already logged-in user
-    // No injection needed - just pass through
-    return ret;
+    pthread_mutex_unlock(&g_pad_table_lock);
+    return handle;
 }
 
-// ============================================
-// Pad Open/Close Hooks - Handle virtual controller
-// ============================================
-
 int32_t scePadOpen_hook(int32_t userId, int32_t type, int32_t index, void* param) {
-    // Dynamic detection: if Xbox is connected and this is NOT the foreground user,
-    // this must be Player 2 - give them the Xbox controller
-    int32_t fg_user = get_foreground_user();
-
-    if (g_xbox_connected && fg_user != 0 && userId != fg_user) {
-        // This is a non-foreground user requesting a controller
-        // Assign Xbox controller to them
-        if (g_xbox_user_id == 0) {
-            g_xbox_user_id = userId;  // Remember this user for future calls
-        }
-
-        if (userId == g_xbox_user_id) {
-            g_virtual_pad_open = 1;
-            hook_notify("Xbox Player 2 ready!");
-            return XBOX_VIRTUAL_PAD_HANDLE;
+    // Every logged-in user but the foreground one has a player slot
+    // (Player 2, 3, 4, ...); the router keeps the table current
+    int slot = user_router_lookup(userId);
+
+    if (slot >= 0) {
+        int32_t handle = open_virtual_pad(slot, userId);
+        if (handle >= 0) {
+            return handle;
         }
     }
 
@@ -386,10 +201,13 @@ int32_t scePadOpen_hook(int32_t userId, int32_t type, int32_t index, void* param
 }
 
 int32_t scePadClose_hook(int32_t handle) {
-    // Check if closing our virtual pad
-    if (handle == XBOX_VIRTUAL_PAD_HANDLE) {
-        g_virtual_pad_open = 0;
-        g_xbox_user_id = 0;  // Reset so it can be reassigned
+    // Check if closing one of our virtual pads
+    if (IS_VIRTUAL_HANDLE(handle)) {
+        pthread_mutex_lock(&g_pad_table_lock);
+        VirtualPad* pad = &g_virtual_pads[HANDLE_TO_INDEX(handle)];
+        pad->open = 0;
+        pad->user_id = 0;  // Reset so it can be reassigned
+        pthread_mutex_unlock(&g_pad_table_lock);
         return 0;
     }
 
@@ -402,11 +220,12 @@ int32_t scePadClose_hook(int32_t handle) {
 // ============================================
 
 int32_t scePadGetControllerInformation_hook(int32_t handle, OrbisPadInformation* info) {
-    // Check if querying our virtual pad
-    if (handle == XBOX_VIRTUAL_PAD_HANDLE) {
+    // Check if querying one of our virtual pads
+    if (IS_VIRTUAL_HANDLE(handle)) {
+        VirtualPad* pad = lookup_virtual_pad(handle);
         if (info != NULL) {
             memset(info, 0, sizeof(OrbisPadInformation));
-            info->connected = g_xbox_connected ? 1 : 0;
+            info->connected = (pad && xbox_usb_is_connected(pad->controller)) ? 1 : 0;
             info->connectionType = ORBIS_PAD_CONNECTION_TYPE_STANDARD;
             info->deviceClass = ORBIS_PAD_DEVICE_CLASS_PAD;
             // Fake touchpad info (Xbox has none)
@@ -426,28 +245,23 @@ int32_t scePadGetControllerInformation_hook(int32_t handle, OrbisPadInformation*
 // ============================================
 
 int32_t scePadRead_hook(int32_t handle, OrbisPadData* pData, int32_t num) {
-    // Check if this is our virtual pad
-    if (handle == XBOX_VIRTUAL_PAD_HANDLE) {
-        if (!g_virtual_pad_open || pData == NULL || num <= 0) {
+    // Virtual handles occupy one small range: a single compare keeps the
+    // real DS4 path cheap, the table lookup routes to the controller
+    if (IS_VIRTUAL_HANDLE(handle)) {
+        VirtualPad* pad = lookup_virtual_pad(handle);
+        if (pad == NULL || pData == NULL || num <= 0) {
             return 0;
         }
 
-        // Fill with Xbox data
-        for (int i = 0; i < num; i++) {
-            memset(&pData[i], 0, sizeof(OrbisPadData));
-            pData[i].connected = g_xbox_connected ? 1 : 0;
-            pData[i].timestamp = sceKernelGetProcessTime();
-            // Neutral stick positions
-            pData[i].leftStick.x = 128;
-            pData[i].leftStick.y = 128;
-            pData[i].rightStick.x = 128;
-            pData[i].rightStick.y = 128;
-
-            if (g_xbox_connected) {
-                inject_xbox_input(&pData[i]);
-            }
+        // Every sample since the previous read, oldest first, in one copy
+        int32_t count = xbox_usb_read_history(pad->controller, pData, num);
+        if (count > 0) {
+            return count;
         }
-        return num;
+
+        // No report yet - one neutral sample
+        fill_xbox_pad_data(pad->controller, &pData[0]);
+        return 1;
     }
 
     // For real DS4 handle - pass through unchanged
@@ -456,25 +270,15 @@ int32_t scePadRead_hook(int32_t handle, OrbisPadData* pData, int32_t num) {
 }
 
 int32_t scePadReadState_hook(int32_t handle, OrbisPadData* pData) {
-    // Check if this is our virtual pad
-    if (handle == XBOX_VIRTUAL_PAD_HANDLE) {
-        if (!g_virtual_pad_open || pData == NULL) {
+    // Check if this is one of our virtual pads
+    if (IS_VIRTUAL_HANDLE(handle)) {
+        VirtualPad* pad = lookup_virtual_pad(handle);
+        if (pad == NULL || pData == NULL) {
             return -1;
         }
 
-        // Fill with Xbox data
-        memset(pData, 0, sizeof(OrbisPadData));
-        pData->connected = g_xbox_connected ? 1 : 0;
-        pData->timestamp = sceKernelGetProcessTime();
-        // Neutral stick positions
-        pData->leftStick.x = 128;
-        pData->leftStick.y = 128;
-        pData->rightStick.x = 128;
-        pData->rightStick.y = 128;
-
-        if (g_xbox_connected) {
-            inject_xbox_input(pData);
-        }
+        // Fill with the latest Xbox snapshot
+        fill_xbox_pad_data(pad->controller, pData);
         return 0;
     }
 
@@ -483,6 +287,40 @@ int32_t scePadReadState_hook(int32_t handle, OrbisPadData* pData) {
     return ret;
 }
 
+// ============================================
+// Vibration Hook - Route to controller rumble
+// ============================================
+
+int32_t scePadSetVibration_hook(int32_t handle, const OrbisPadVibeParam* param) {
+    if (IS_VIRTUAL_HANDLE(handle)) {
+        VirtualPad* pad = lookup_virtual_pad(handle);
+        if (pad == NULL || param == NULL) {
+            return -1;
+        }
+
+        // Games call this every frame: only record the value, the poll
+        // thread sends it. Pads without motors ignore it like a DS4 would.
+        xbox_usb_set_rumble(pad->controller, param->lgMotor, param->smMotor);
+        return 0;
+    }
+
+    return HOOK_CONTINUE(scePadSetVibration, scePadSetVibration_t, handle, param);
+}
+
+// ============================================
+// User Service Hook - Route logins as the game sees them
+// ============================================
+
+int32_t sceUserServiceGetEvent_hook(OrbisUserServiceEvent* event) {
+    // The queue is the game's: pass every event on, routing it first
+    // so a scePadOpen for a user who just logged in finds their slot
+    int32_t ret = HOOK_CONTINUE(sceUserServiceGetEvent, sceUserServiceGetEvent_t, event);
+    if (ret == 0 && event != NULL) {
+        user_router_event(event);
+    }
+    return ret;
+}
+
 int hooks_install(void) {
     if (g_hooks_installed) {
         return 0;
@@ -496,7 +334,7 @@ int hooks_install(void) {
     snprintf(module, 256, "/%s/common/lib/%s", sceKernelGetFsSandboxRandomWord(), "libScePad.sprx");
     ret = sys_dynlib_load_prx(module, &h);
     if (ret < 0 || h == 0) {
-        hook_notify("Xbox: Pad lib failed");
+        notify_post("Xbox: Pad lib failed");
         return -1;
     }
     g_pad_prx_loaded = 1;
@@ -507,14 +345,11 @@ int hooks_install(void) {
     ret = sys_dynlib_load_prx(module, &h);
     if (ret >= 0 && h != 0) {
         g_user_prx_loaded = 1;
-
-        // Cache the foreground user (Player 1) for later comparison
-        hooks_detect_second_user();
     }
 
     // Verify scePadReadExt exists before patching
     if ((uint64_t)scePadReadExt == 0) {
-        hook_notify("Xbox: No PadReadExt");
+        notify_post("Xbox: No PadReadExt");
         return -1;
     }
 
@@ -540,10 +375,14 @@ int hooks_install(void) {
     HOOK32(scePadOpen);
     HOOK32(scePadClose);
     HOOK32(scePadGetControllerInformation);
+    HOOK32(scePadSetVibration);
 
-    // Install user service hook if library loaded
+    // Follow logins so scePadOpen knows who is Player 2, 3, 4
     if (g_user_prx_loaded) {
-        HOOK32(sceUserServiceGetLoginUserIdList);
+        if (user_router_start() != 0) {
+            notify_post("Xbox: User routing failed");
+        }
+        HOOK32(sceUserServiceGetEvent);
     }
 
     g_hooks_installed = 1;
@@ -558,9 +397,10 @@ void hooks_remove(void) {
         UNHOOK(scePadOpen);
         UNHOOK(scePadClose);
         UNHOOK(scePadGetControllerInformation);
+        UNHOOK(scePadSetVibration);
 
         if (g_user_prx_loaded) {
-            UNHOOK(sceUserServiceGetLoginUserIdList);
+            UNHOOK(sceUserServiceGetEvent);
         }
 
         if (g_padReadExtPatcher) {
@@ -578,30 +418,23 @@ void hooks_remove(void) {
         g_hooks_installed = 0;
     }
 
-    // Clean up USB resources
-    if (g_xbox_handle != NULL) {
-        sceUsbdReleaseInterface(g_xbox_handle, 0);
-        sceUsbdClose(g_xbox_handle);
-        g_xbox_handle = NULL;
-    }
+    user_router_stop();
 
+    // Stop the polling thread and release USB resources
     if (g_usb_initialized) {
-        sceUsbdExit();
+        xbox_usb_cleanup();
         g_usb_initialized = 0;
     }
 
     // Reset state
-    g_has_xbox_data = 0;
-    g_xbox_active = 0;
-    g_xbox_connected = 0;
-    g_virtual_pad_open = 0;
-    g_controller_type = CONTROLLER_NONE;
+    memset(g_virtual_pads, 0, sizeof(g_virtual_pads));
 }
 
 int hooks_is_virtual_handle(int handle) {
-    return (handle == XBOX_VIRTUAL_PAD_HANDLE) ? 1 : 0;
+    return IS_VIRTUAL_HANDLE(handle) ? 1 : 0;
 }
 
 int hooks_handle_to_index(int handle) {
-    return (handle == XBOX_VIRTUAL_PAD_HANDLE) ? 0 : -1;
+    VirtualPad* pad = lookup_virtual_pad(handle);
+    return pad ? pad->controller : -1;
 }
@@ -0,0 +1,228 @@
+/*
+ * USB Hot-plug Detection Implementation
+ *
+ * The device list is only walked on this thread, never on the poll
+ * thread. Each scan first hashes the bus/address of every device - no
+ * descriptor reads - and stops there when nothing was plugged or
+ * unplugged. Only new locations get their descriptor read, once.
+ *
+ * Events go to the poll thread through a single-producer /
+ * single-consumer ring, so checking for changes costs the poller two
+ * atomic loads per cycle.
+ */
+
+#include "hotplug.h"
+#include "config.h"
+#include <string.h>
+
+#include <orbis/libkernel.h>
+
+#include <pthread.h>
+
+#define HOTPLUG_MAX_DEVICES 32      // Devices tracked per scan
+#define HOTPLUG_QUEUE_SIZE  16      // Event ring size (power of two)
+
+/*
+ * Device seen by a previous scan
+ */
+typedef struct {
+    uint16_t location;
+    uint8_t  reported;      // Passed the filter, ARRIVED was queued
+} KnownDevice;
+
+// Detection thread state
+static KnownDevice       g_known[HOTPLUG_MAX_DEVICES];
+static int               g_known_count = 0;
+static uint32_t          g_last_signature = 0;
+static HotplugFilter     g_filter = NULL;
+static pthread_t         g_hotplug_thread;
+static volatile int      g_hotplug_active = 0;
+static volatile int      g_forget_requested = 0;
+
+// Event ring: head written by the detection thread, tail by the consumer
+static HotplugEvent      g_queue[HOTPLUG_QUEUE_SIZE];
+static volatile uint32_t g_queue_head = 0;
+static volatile uint32_t g_queue_tail = 0;
+
+static int queue_push(const HotplugEvent* event) {
+    uint32_t head = __atomic_load_n(&g_queue_head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&g_queue_tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= HOTPLUG_QUEUE_SIZE) {
+        return -1;  // Full - retried on the next scan
+    }
+
+    g_queue[head & (HOTPLUG_QUEUE_SIZE - 1)] = *event;
+    __atomic_store_n(&g_queue_head, head + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int hotplug_poll(HotplugEvent* event) {
+    uint32_t tail = __atomic_load_n(&g_queue_tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&g_queue_head, __ATOMIC_ACQUIRE);
+
+    if (tail == head) {
+        return 0;
+    }
+
+    *event = g_queue[tail & (HOTPLUG_QUEUE_SIZE - 1)];
+    __atomic_store_n(&g_queue_tail, tail + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static int find_location(const uint16_t* locations, int count, uint16_t location) {
+    for (int i = 0; i < count; i++) {
+        if (locations[i] == location) return i;
+    }
+    return -1;
+}
+
+static int is_known(uint16_t location) {
+    for (int i = 0; i < g_known_count; i++) {
+        if (g_known[i].location == location) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Diff the current device list against the known set
+ */
+static void scan_devices(void) {
+    libusb_device** device_list = NULL;
+    uint16_t locations[HOTPLUG_MAX_DEVICES];
+    int count = 0;
+
+    int32_t device_count = sceUsbdGetDeviceList(&device_list);
+    if (device_count < 0 || device_list == NULL) {
+        return;
+    }
+
+    // Cheap pass: FNV-1a over bus/address only
+    uint32_t signature = 2166136261u;
+    for (int32_t i = 0; i < device_count && count < HOTPLUG_MAX_DEVICES; i++) {
+        uint16_t location = HOTPLUG_LOCATION(sceUsbdGetBusNumber(device_list[i]),
+                                             sceUsbdGetDeviceAddress(device_list[i]));
+        locations[count++] = location;
+        signature = (signature ^ location) * 16777619u;
+    }
+    signature = (signature ^ (uint32_t)count) * 16777619u;
+
+    if (g_forget_requested) {
+        g_forget_requested = 0;
+        g_known_count = 0;
+    } else if (signature == g_last_signature) {
+        // Nothing plugged or unplugged
+        sceUsbdFreeDeviceList(device_list);
+        return;
+    }
+
+    int complete = 1;
+
+    // Removals
+    for (int k = 0; k < g_known_count; ) {
+        if (find_location(locations, count, g_known[k].location) < 0) {
+            if (g_known[k].reported) {
+                HotplugEvent event;
+                memset(&event, 0, sizeof(event));
+                event.type = HOTPLUG_LEFT;
+                event.location = g_known[k].location;
+                if (queue_push(&event) != 0) {
+                    complete = 0;
+                    k++;
+                    continue;
+                }
+            }
+            g_known[k] = g_known[--g_known_count];
+            continue;
+        }
+        k++;
+    }
+
+    // Arrivals - descriptors are read once per new location
+    for (int i = 0; i < count && g_known_count < HOTPLUG_MAX_DEVICES; i++) {
+        if (is_known(locations[i])) {
+            continue;
+        }
+
+        struct libusb_device_descriptor desc;
+        if (sceUsbdGetDeviceDescriptor(device_list[i], &desc) != 0) {
+            complete = 0;
+            continue;
+        }
+
+        int wanted = (g_filter == NULL) || g_filter(desc.idVendor, desc.idProduct);
+        if (wanted) {
+            HotplugEvent event;
+            event.type = HOTPLUG_ARRIVED;
+            event.location = locations[i];
+            event.vendor_id = desc.idVendor;
+            event.product_id = desc.idProduct;
+            event.device = sceUsbdRefDevice(device_list[i]);
+            if (queue_push(&event) != 0) {
+                sceUsbdUnrefDevice(event.device);
+                complete = 0;
+                continue;
+            }
+        }
+
+        g_known[g_known_count].location = locations[i];
+        g_known[g_known_count].reported = (uint8_t)wanted;
+        g_known_count++;
+    }
+
+    sceUsbdFreeDeviceList(device_list);
+
+    // Force a full diff next time if anything could not be delivered
+    g_last_signature = complete ? signature : 0;
+}
+
+static void* hotplug_thread_func(void* arg) {
+    (void)arg;
+
+    while (g_hotplug_active) {
+        scan_devices();
+        sceKernelUsleep(HOTPLUG_SCAN_INTERVAL_US);
+    }
+
+    return NULL;
+}
+
+int hotplug_start(HotplugFilter filter) {
+    if (g_hotplug_active) {
+        return -1;
+    }
+
+    g_filter = filter;
+    g_known_count = 0;
+    g_last_signature = 0;
+    g_forget_requested = 0;
+    g_hotplug_active = 1;
+
+    if (pthread_create(&g_hotplug_thread, NULL, hotplug_thread_func, NULL) != 0) {
+        g_hotplug_active = 0;
+        return -2;
+    }
+
+    return 0;
+}
+
+void hotplug_stop(void) {
+    if (!g_hotplug_active) {
+        return;
+    }
+
+    g_hotplug_active = 0;
+    pthread_join(g_hotplug_thread, NULL);
+
+    // Release devices nobody consumed
+    HotplugEvent event;
+    while (hotplug_poll(&event)) {
+        if (event.device != NULL) {
+            sceUsbdUnrefDevice(event.device);
+        }
+    }
+}
+
+void hotplug_request_scan(void) {
+    g_forget_requested = 1;
+}
@@ -0,0 +1,265 @@
+/*
+ * Input Latency Instrumentation Implementation
+ *
+ * Histograms are log-linear: eight buckets per power of two, so any
+ * recorded value is within 12.5% of its bucket bounds. Every counter is
+ * updated with a relaxed atomic add; the poll thread and any number of
+ * game threads record concurrently without locks.
+ */
+
+#include "latency.h"
+#include <stdio.h>
+#include <string.h>
+
+#include <orbis/libkernel.h>
+
+#define LATENCY_SUB_BITS    3
+#define LATENCY_SUB_COUNT   (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS     320     // Covers up to ~2^41 ns
+
+/*
+ * One interval histogram (own cache lines: poll thread and hooks
+ * record different intervals)
+ */
+typedef struct __attribute__((aligned(64))) {
+    volatile uint32_t buckets[LATENCY_BUCKETS];
+    volatile uint64_t count;
+    volatile uint64_t sum_ns;
+    volatile uint64_t max_ns;
+} LatencyHistogram;
+
+/*
+ * Per-controller counters
+ */
+typedef struct {
+    LatencyHistogram  histogram[LATENCY_INTERVAL_COUNT];
+    volatile uint64_t published __attribute__((aligned(64)));     // Poll thread
+    volatile uint64_t consumed __attribute__((aligned(64)));      // Hooks
+    volatile uint64_t last_consumed;    // Publish stamp of the newest report read
+} ControllerLatency;
+
+static ControllerLatency g_latency[MAX_XBOX_CONTROLLERS];
+
+static const char* const g_interval_names[LATENCY_INTERVAL_COUNT] = {
+    "decode",
+    "translate",
+    "publish",
+    "wait",
+    "end-to-end",
+};
+
+// Largest value that lands in a bucket
+static uint64_t bucket_upper(int index) {
+    if (index < LATENCY_SUB_COUNT) {
+        return (uint64_t)index;
+    }
+
+    int shift = index / LATENCY_SUB_COUNT - 1;
+    uint64_t sub = (uint64_t)(index % LATENCY_SUB_COUNT);
+    return ((LATENCY_SUB_COUNT + sub + 1) << shift) - 1;
+}
+
+static void histogram_summary(const LatencyHistogram* histogram, LatencyIntervalStats* stats) {
+    uint32_t buckets[LATENCY_BUCKETS];
+    uint64_t total = 0;
+
+    // Percentiles come from the bucket copy so they agree with each other
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        buckets[i] = __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+        total += buckets[i];
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->count = total;
+    stats->max_ns = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+    if (total == 0) {
+        return;
+    }
+
+    uint64_t count = __atomic_load_n(&histogram->count, __ATOMIC_RELAXED);
+    stats->mean_ns = __atomic_load_n(&histogram->sum_ns, __ATOMIC_RELAXED) / (count ? count : 1);
+
+    uint64_t p50_rank = (total + 1) / 2;
+    uint64_t p99_rank = total - total / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += buckets[i];
+        if (stats->p50_ns == 0 && seen >= p50_rank) {
+            stats->p50_ns = bucket_upper(i);
+        }
+        if (seen >= p99_rank) {
+            stats->p99_ns = bucket_upper(i);
+            break;
+        }
+    }
+
+    // Bucket bounds can overshoot the largest value actually seen
+    if (stats->p50_ns > stats->max_ns) stats->p50_ns = stats->max_ns;
+    if (stats->p99_ns > stats->max_ns) stats->p99_ns = stats->max_ns;
+}
+
+#if LATENCY_TRACKING
+
+static uint64_t g_tsc_mhz = 0;
+
+static uint64_t ticks_to_ns(uint64_t ticks) {
+    uint64_t mhz = __atomic_load_n(&g_tsc_mhz, __ATOMIC_RELAXED);
+    if (mhz == 0) {
+        mhz = sceKernelGetTscFrequency() / 1000000ull;
+        if (mhz == 0) {
+            mhz = 1;
+        }
+        __atomic_store_n(&g_tsc_mhz, mhz, __ATOMIC_RELAXED);
+    }
+    return ticks * 1000ull / mhz;
+}
+
+static int bucket_index(uint64_t ns) {
+    if (ns < LATENCY_SUB_COUNT) {
+        return (int)ns;
+    }
+
+    int msb = 63 - __builtin_clzll(ns);
+    int sub = (int)((ns >> (msb - LATENCY_SUB_BITS)) & (LATENCY_SUB_COUNT - 1));
+    int index = (msb - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT + sub;
+    return index < LATENCY_BUCKETS ? index : LATENCY_BUCKETS - 1;
+}
+
+static void histogram_record(LatencyHistogram* histogram, uint64_t start, uint64_t end) {
+    uint64_t ns = (end > start) ? ticks_to_ns(end - start) : 0;
+
+    __atomic_fetch_add(&histogram->buckets[bucket_index(ns)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum_ns, ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+    while (ns > max &&
+           !__atomic_compare_exchange_n(&histogram->max_ns, &max, ns, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void latency_stamp(LatencyStamps* stamps, LatencyStage stage) {
+    stamps->stamp[stage] = sceKernelReadTsc();
+}
+
+void latency_record_publish(int controller, const LatencyStamps* stamps) {
+    ControllerLatency* latency = &g_latency[controller];
+    uint64_t visible = sceKernelReadTsc();
+
+    if (stamps->stamp[LATENCY_STAGE_USB] == 0) {
+        return;     // Republished without a transfer (turbo/macro edge)
+    }
+
+    histogram_record(&latency->histogram[LATENCY_DECODE],
+                     stamps->stamp[LATENCY_STAGE_USB], stamps->stamp[LATENCY_STAGE_DECODE]);
+    histogram_record(&latency->histogram[LATENCY_TRANSLATE],
+                     stamps->stamp[LATENCY_STAGE_DECODE], stamps->stamp[LATENCY_STAGE_TRANSLATE]);
+    histogram_record(&latency->histogram[LATENCY_PUBLISH],
+                     stamps->stamp[LATENCY_STAGE_TRANSLATE], visible);
+    __atomic_fetch_add(&latency->published, 1, __ATOMIC_RELAXED);
+}
+
+void latency_record_consume(int controller, const LatencyStamps* stamps) {
+    ControllerLatency* latency = &g_latency[controller];
+    uint64_t published = stamps->stamp[LATENCY_STAGE_PUBLISH];
+
+    if (stamps->stamp[LATENCY_STAGE_USB] == 0) {
+        return;
+    }
+
+    // Cheap exit for re-reads of a report that was already counted
+    uint64_t last = __atomic_load_n(&latency->last_consumed, __ATOMIC_RELAXED);
+    if (published == 0 || published <= last) {
+        return;
+    }
+
+    // First reader of this report wins the claim and records it
+    uint64_t now = sceKernelReadTsc();
+    do {
+        if (published <= last) {
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&latency->last_consumed, &last, published, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    histogram_record(&latency->histogram[LATENCY_WAIT], published, now);
+    histogram_record(&latency->histogram[LATENCY_END_TO_END], stamps->stamp[LATENCY_STAGE_USB], now);
+    __atomic_fetch_add(&latency->consumed, 1, __ATOMIC_RELAXED);
+}
+
+#endif // LATENCY_TRACKING
+
+const char* latency_interval_name(LatencyInterval interval) {
+    if ((unsigned)interval >= LATENCY_INTERVAL_COUNT) {
+        return "unknown";
+    }
+    return g_interval_names[interval];
+}
+
+int latency_get_stats(int controller, LatencyStats* stats) {
+    if (controller < 0 || controller >= MAX_XBOX_CONTROLLERS || stats == NULL) {
+        return -1;
+    }
+
+    ControllerLatency* latency = &g_latency[controller];
+    stats->published = __atomic_load_n(&latency->published, __ATOMIC_RELAXED);
+    stats->consumed = __atomic_load_n(&latency->consumed, __ATOMIC_RELAXED);
+    for (int i = 0; i < LATENCY_INTERVAL_COUNT; i++) {
+        histogram_summary(&latency->histogram[i], &stats->interval[i]);
+    }
+    return 0;
+}
+
+void latency_reset(int controller) {
+    // Not atomic as a whole: a report recorded during the reset may be
+    // split between the old and new counts
+    for (int i = 0; i < MAX_XBOX_CONTROLLERS; i++) {
+        if (controller >= 0 && controller != i) {
+            continue;
+        }
+
+        ControllerLatency* latency = &g_latency[i];
+        for (int h = 0; h < LATENCY_INTERVAL_COUNT; h++) {
+            LatencyHistogram* histogram = &latency->histogram[h];
+            for (int b = 0; b < LATENCY_BUCKETS; b++) {
+                __atomic_store_n(&histogram->buckets[b], 0, __ATOMIC_RELAXED);
+            }
+            __atomic_store_n(&histogram->count, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&histogram->sum_ns, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&histogram->max_ns, 0, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&latency->published, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&latency->consumed, 0, __ATOMIC_RELAXED);
+    }
+}
+
+int latency_dump(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return -1;
+    }
+
+    fprintf(file, "# Xbox controller input latency (ns)\n");
+    for (int c = 0; c < MAX_XBOX_CONTROLLERS; c++) {
+        LatencyStats stats;
+        latency_get_stats(c, &stats);
+        if (stats.published == 0) {
+            continue;
+        }
+
+        fprintf(file, "controller %d: %llu published, %llu read by the game\n", c,
+                (unsigned long long)stats.published, (unsigned long long)stats.consumed);
+        for (int i = 0; i < LATENCY_INTERVAL_COUNT; i++) {
+            const LatencyIntervalStats* interval = &stats.interval[i];
+            fprintf(file, "  %-10s count %-10llu mean %-9llu p50 %-9llu p99 %-9llu max %llu\n",
+                    latency_interval_name((LatencyInterval)i),
+                    (unsigned long long)interval->count, (unsigned long long)interval->mean_ns,
+                    (unsigned long long)interval->p50_ns, (unsigned long long)interval->p99_ns,
+                    (unsigned long long)interval->max_ns);
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
@@ -1,6 +1,10 @@
 /*
  * Xbox Controller Plugin for PS4 (GoldHEN)
- * TEST: Hooks only, no USB
+ *
+ * Load starts the notification drain thread, the capture writer and the
+ * profile watcher, then the USB polling engine (poll and hot-plug threads)
+ * and the scePad hooks, which bring up the user router thread. Unload stops
+ * them in reverse so nothing is left touching an unhooked pad.
  */
 
 #include <stdint.h>
@@ -10,6 +14,10 @@
 
 #include "config.h"
 #include "hooks.h"
+#include "latency.h"
+#include "capture.h"
+#include "profile.h"
+#include "notify.h"
 
 // OpenOrbis headers
 #include <orbis/libkernel.h>
@@ -24,25 +32,38 @@ attr_public const char *g_pluginDesc = "Xbox 360 Controller Support";
 attr_public const char *g_pluginAuth = "xbox_controller_plugin";
 attr_public uint32_t g_pluginVersion = 0x00000100;
 
-static void notify(const char* message) {
-    OrbisNotificationRequest req;
-    memset(&req, 0, sizeof(req));
-    req.type = NotificationRequest;
-    req.targetId = -1;
-    strncpy(req.message, message, sizeof(req.message) - 1);
-    sceKernelSendNotificationRequest(0, &req, sizeof(req), 0);
-}
-
 int32_t attr_public plugin_load(int32_t argc, const char* argv[]) {
     (void)argc;
     (void)argv;
 
+    // Toasts from every thread go through the queue from here on
+    notify_start();
+
+#if REPORT_CAPTURE
+    // Before USB so the first reports of every controller are recorded
+    capture_start(CAPTURE_PATH);
+#endif
+
+    // Before USB so the first report already uses the title's settings
+    profile_load(PROFILE_PATH);
+#if PROFILE_WATCH
+    profile_watch_start();
+#endif
+
     // Initialize USB first (non-fatal if fails - just no Xbox support)
     hooks_init_usb();
 
     // Install hooks - if this fails, plugin won't work but shouldn't crash
     if (hooks_install() < 0) {
-        notify("Xbox: Hook install failed");
+        notify_post("Xbox: Hook install failed");
+        hooks_remove();     // Stops the polling, hot-plug and router threads
+#if PROFILE_WATCH
+        profile_watch_stop();
+#endif
+#if REPORT_CAPTURE
+        capture_stop();
+#endif
+        notify_stop();
         return -1;  // Tell GoldHEN to unload us
     }
 
@@ -53,7 +74,17 @@ int32_t attr_public plugin_unload(int32_t argc, const char* argv[]) {
     (void)argc;
     (void)argv;
     hooks_remove();
-    notify("Xbox: Unloaded");
+#if PROFILE_WATCH
+    profile_watch_stop();
+#endif
+#if REPORT_CAPTURE
+    capture_stop();
+#endif
+#if LATENCY_TRACKING
+    latency_dump(LATENCY_DUMP_PATH);
+#endif
+    notify_post("Xbox: Unloaded");
+    notify_stop();     // Shows what is still queued
     return 0;
 }
 
@@ -0,0 +1,178 @@
+/*
+ * Notification Queue Implementation
+ *
+ * Bounded MPSC queue with a sequence number per cell: a producer claims
+ * a position with one CAS on the tail, fills the cell and releases it
+ * by storing the next sequence; the consumer reads cells in order and
+ * hands them back one lap ahead. No locks, so a hook preempted while
+ * posting never stalls another thread.
+ *
+ * Sequences are kept relative to the lap (position with the index bits
+ * cleared), so the zero-initialized queue is already valid: every cell
+ * free for lap 0.
+ */
+
+#include "notify.h"
+#include <string.h>
+
+#include <orbis/libkernel.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#define NOTIFY_QUEUE_MASK   (NOTIFY_QUEUE_SIZE - 1)
+#define NOTIFY_LAP(p)       ((p) & ~(uint32_t)NOTIFY_QUEUE_MASK)
+
+typedef struct {
+    volatile uint32_t sequence;     // Lap: free, lap + 1: holds a message
+    char              message[NOTIFY_MESSAGE_SIZE];
+} NotifyCell;
+
+typedef struct {
+    volatile uint32_t tail __attribute__((aligned(64)));    // Producers
+    uint32_t          head __attribute__((aligned(64)));    // Consumer
+    NotifyCell        cells[NOTIFY_QUEUE_SIZE];
+} NotifyQueue;
+
+static NotifyQueue  g_queue;
+static NotifyStats  g_stats;
+
+// Drain thread state
+static pthread_t    g_drain_thread;
+static volatile int g_drain_running = 0;
+static char         g_last_message[NOTIFY_MESSAGE_SIZE];
+static uint64_t     g_last_sent_us = 0;
+
+int notify_post(const char* message) {
+    uint32_t position = __atomic_load_n(&g_queue.tail, __ATOMIC_RELAXED);
+    NotifyCell* cell;
+
+    for (;;) {
+        cell = &g_queue.cells[position & NOTIFY_QUEUE_MASK];
+        uint32_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int32_t lag = (int32_t)(sequence - NOTIFY_LAP(position));
+
+        if (lag == 0) {
+            if (__atomic_compare_exchange_n(&g_queue.tail, &position, position + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+            // position was reloaded by the failed CAS
+        } else if (lag < 0) {
+            // The consumer has not freed this cell yet: full
+            __atomic_fetch_add(&g_stats.dropped, 1, __ATOMIC_RELAXED);
+            return -1;
+        } else {
+            position = __atomic_load_n(&g_queue.tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    strncpy(cell->message, message, NOTIFY_MESSAGE_SIZE - 1);
+    cell->message[NOTIFY_MESSAGE_SIZE - 1] = '\0';
+    __atomic_store_n(&cell->sequence, NOTIFY_LAP(position) + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&g_stats.posted, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+// Oldest complete message (consumer only); 0 if none
+static int queue_peek(char* message) {
+    NotifyCell* cell = &g_queue.cells[g_queue.head & NOTIFY_QUEUE_MASK];
+
+    if (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) != NOTIFY_LAP(g_queue.head) + 1) {
+        return 0;
+    }
+    memcpy(message, cell->message, NOTIFY_MESSAGE_SIZE);
+    return 1;
+}
+
+static void queue_pop(void) {
+    NotifyCell* cell = &g_queue.cells[g_queue.head & NOTIFY_QUEUE_MASK];
+
+    __atomic_store_n(&cell->sequence, NOTIFY_LAP(g_queue.head) + NOTIFY_QUEUE_SIZE, __ATOMIC_RELEASE);
+    g_queue.head++;
+}
+
+static void send_notification(const char* message) {
+    OrbisNotificationRequest req;
+    memset(&req, 0, sizeof(req));
+    req.type = NotificationRequest;
+    req.targetId = -1;
+    strncpy(req.message, message, sizeof(req.message) - 1);
+    sceKernelSendNotificationRequest(0, &req, sizeof(req), 0);
+}
+
+/*
+ * Show queued messages
+ * @param rate_limit    Keep NOTIFY_MIN_INTERVAL_US between toasts
+ */
+static void drain(int rate_limit) {
+    char message[NOTIFY_MESSAGE_SIZE];
+
+    while (queue_peek(message)) {
+        uint64_t now = sceKernelGetProcessTime();
+        int repeat = g_last_sent_us && strcmp(message, g_last_message) == 0 &&
+                     now - g_last_sent_us < NOTIFY_DEDUP_US;
+
+        if (repeat) {
+            queue_pop();
+            __atomic_fetch_add(&g_stats.duplicates, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (rate_limit && g_last_sent_us && now - g_last_sent_us < NOTIFY_MIN_INTERVAL_US) {
+            return;     // Stays queued for a later pass
+        }
+
+        queue_pop();
+        send_notification(message);
+        memcpy(g_last_message, message, sizeof(g_last_message));
+        g_last_sent_us = now;
+        __atomic_fetch_add(&g_stats.sent, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void* drain_thread_func(void* arg) {
+    (void)arg;
+
+    // Below the game's threads; failure just leaves the default priority
+    struct sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_OTHER);
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+
+    while (g_drain_running) {
+        drain(1);
+        sceKernelUsleep(NOTIFY_DRAIN_INTERVAL_US);
+    }
+    return NULL;
+}
+
+int notify_start(void) {
+    if (g_drain_running) {
+        return -1;
+    }
+
+    g_last_sent_us = 0;
+
+    g_drain_running = 1;
+    if (pthread_create(&g_drain_thread, NULL, drain_thread_func, NULL) != 0) {
+        g_drain_running = 0;
+        return -2;
+    }
+    return 0;
+}
+
+void notify_stop(void) {
+    if (!g_drain_running) {
+        return;
+    }
+
+    g_drain_running = 0;
+    pthread_join(g_drain_thread, NULL);
+    drain(0);
+}
+
+void notify_get_stats(NotifyStats* stats) {
+    stats->posted = __atomic_load_n(&g_stats.posted, __ATOMIC_RELAXED);
+    stats->sent = __atomic_load_n(&g_stats.sent, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&g_stats.dropped, __ATOMIC_RELAXED);
+    stats->duplicates = __atomic_load_n(&g_stats.duplicates, __ATOMIC_RELAXED);
+}
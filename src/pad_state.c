@@ -0,0 +1,105 @@
+/*
+ * Normalized Controller State Implementation
+ *
+ * The emitter starts from a prebuilt neutral OrbisPadData (motion at
+ * rest, connected) and patches the input fields in, instead of clearing
+ * the whole structure and storing each float on every report.
+ *
+ * The SSE2 emitter relies on the input fields sitting together at the
+ * front of both structures: PadState bytes 4-15 hold the sticks and
+ * triggers, OrbisPadData bytes 4-9 take them and bytes 10-15 (padding,
+ * quat.x) are zero in the neutral pad. The whole 16-byte head is built
+ * in one register and the other 104 bytes are template stores.
+ */
+
+#include "pad_state.h"
+#include <stddef.h>
+#include <string.h>
+
+#if PAD_STATE_SIMD && defined(__SSE2__)
+#include <emmintrin.h>
+#define PAD_STATE_SSE2 1
+#endif
+
+// Neutral pad: zero everywhere (padding included) but these fields
+static const OrbisPadData s_neutral_pad __attribute__((aligned(16))) = {
+    .quat = { 0.0f, 0.0f, 0.0f, 1.0f },
+    .acell = { 0.0f, 0.0f, 1.0f },     // 1g downward
+    .connected = 1,
+};
+
+void pad_state_emit_scalar(const PadState* state, OrbisPadData* ds4) {
+    memcpy(ds4, &s_neutral_pad, sizeof(OrbisPadData));
+
+    ds4->buttons = state->buttons;
+    ds4->leftStick.x = pad_stick_to_u8(state->left_x);
+    ds4->leftStick.y = pad_stick_to_u8(state->left_y);
+    ds4->rightStick.x = pad_stick_to_u8(state->right_x);
+    ds4->rightStick.y = pad_stick_to_u8(state->right_y);
+    ds4->analogButtons.l2 = pad_trigger_to_u8(state->l2);
+    ds4->analogButtons.r2 = pad_trigger_to_u8(state->r2);
+    ds4->timestamp = state->timestamp;
+}
+
+#ifdef PAD_STATE_SSE2
+
+_Static_assert(offsetof(PadState, left_x) == 4 && offsetof(PadState, l2) == 12 &&
+               offsetof(PadState, timestamp) == 16, "PadState layout");
+_Static_assert(offsetof(OrbisPadData, leftStick) == 4 && offsetof(OrbisPadData, analogButtons) == 8 &&
+               offsetof(OrbisPadData, quat) == 12 && offsetof(OrbisPadData, timestamp) == 80 &&
+               sizeof(OrbisPadData) == 120, "OrbisPadData layout");
+
+/*
+ * OrbisPadData bytes 0-15: buttons, sticks, triggers, zero padding and quat.x
+ */
+static inline __m128i emit_head(const PadState* state) {
+    __m128i v = _mm_loadu_si128((const __m128i*)state);
+
+    // Words 2-5: sticks, (v >> 8) + 128; words 6-7: triggers, (v >> 2) & 0xFF
+    __m128i sticks = _mm_add_epi16(_mm_srai_epi16(v, 8), _mm_set1_epi16(128));
+    __m128i triggers = _mm_and_si128(_mm_srli_epi16(v, PAD_TRIGGER_BITS - 8), _mm_set1_epi16(0xFF));
+    __m128i words = _mm_or_si128(_mm_and_si128(sticks, _mm_set_epi16(0, 0, -1, -1, -1, -1, 0, 0)),
+                                 _mm_and_si128(triggers, _mm_set_epi16(-1, -1, 0, 0, 0, 0, 0, 0)));
+
+    // Every word is 0-255, so packing is exact: bytes 2-7, moved to 4-9
+    __m128i bytes = _mm_slli_si128(_mm_packus_epi16(words, _mm_setzero_si128()), 2);
+    return _mm_or_si128(bytes, _mm_cvtsi32_si128((int)state->buttons));
+}
+
+void pad_state_emit_batch(const PadState* states, OrbisPadData* ds4, int count) {
+    const __m128i* neutral = (const __m128i*)&s_neutral_pad;
+    __m128i n1 = _mm_load_si128(neutral + 1);
+    __m128i n2 = _mm_load_si128(neutral + 2);
+    __m128i n3 = _mm_load_si128(neutral + 3);
+    __m128i n4 = _mm_load_si128(neutral + 4);
+    __m128i n6 = _mm_load_si128(neutral + 6);
+    __m128i n7 = _mm_loadl_epi64(neutral + 7);
+
+    for (int i = 0; i < count; i++) {
+        __m128i* out = (__m128i*)&ds4[i];
+
+        _mm_storeu_si128(out, emit_head(&states[i]));
+        _mm_storeu_si128(out + 1, n1);
+        _mm_storeu_si128(out + 2, n2);
+        _mm_storeu_si128(out + 3, n3);
+        _mm_storeu_si128(out + 4, n4);
+        // Timestamp, then ext[0-7] (zero)
+        _mm_storeu_si128(out + 5, _mm_loadl_epi64((const __m128i*)&states[i].timestamp));
+        _mm_storeu_si128(out + 6, n6);
+        _mm_storel_epi64(out + 7, n7);
+    }
+}
+
+#else
+
+void pad_state_emit_batch(const PadState* states, OrbisPadData* ds4, int count) {
+    for (int i = 0; i < count; i++) {
+        pad_state_emit_scalar(&states[i], &ds4[i]);
+    }
+}
+
+#endif // PAD_STATE_SSE2
+
+void pad_state_emit(const PadState* state, OrbisPadData* ds4) {
+    pad_state_emit_batch(state, ds4, 1);
+}
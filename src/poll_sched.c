@@ -0,0 +1,116 @@
+/*
+ * Adaptive USB Poll Scheduler Implementation
+ *
+ * The game read period is estimated from the read count and newest
+ * read time the hooks leave behind, averaged over the reads between two
+ * polls and smoothed with a 1/8 moving average. Polls are laid on a
+ * grid ending POLL_LEAD_US before the next predicted read: the device
+ * holds its newest state until polled, so the later the last poll, the
+ * fresher the report the game gets.
+ */
+
+#include "poll_sched.h"
+#include "config.h"
+
+void poll_sched_init(PollSchedule* sched, uint32_t interval_us, uint64_t now) {
+    // Read tracking is left alone: the game keeps reading the same slot
+    sched->device_interval_us = interval_us ? interval_us : 1000;
+    sched->seen_count = __atomic_load_n(&sched->read_count, __ATOMIC_ACQUIRE);
+    sched->seen_read_us = __atomic_load_n(&sched->last_read_us, __ATOMIC_RELAXED);
+    sched->read_period_us = 0;
+    sched->poll_period_us = POLL_IDLE_INTERVAL_US;
+    sched->next_poll_us = now;
+    sched->polls = 0;
+    sched->idle = 1;
+}
+
+// Fold the reads made since the last update into the period estimate
+static void track_reads(PollSchedule* sched) {
+    uint32_t count = __atomic_load_n(&sched->read_count, __ATOMIC_ACQUIRE);
+    uint64_t last = __atomic_load_n(&sched->last_read_us, __ATOMIC_RELAXED);
+
+    if (count == sched->seen_count) {
+        return;
+    }
+
+    uint32_t reads = count - sched->seen_count;
+    if (sched->seen_read_us != 0 && last > sched->seen_read_us) {
+        uint64_t sample = (last - sched->seen_read_us) / reads;
+
+        // A gap this long is a pause, not a frame rate
+        if (sample < POLL_IDLE_AFTER_US) {
+            if (sched->read_period_us == 0) {
+                sched->read_period_us = (uint32_t)sample;
+            } else {
+                int64_t error = (int64_t)sample - (int64_t)sched->read_period_us;
+                sched->read_period_us = (uint32_t)((int64_t)sched->read_period_us + error / 8);
+            }
+        }
+    }
+
+    sched->seen_count = count;
+    sched->seen_read_us = last;
+}
+
+uint64_t poll_sched_update(PollSchedule* sched, uint64_t now) {
+    uint32_t interval = sched->device_interval_us;
+
+    sched->polls++;
+    track_reads(sched);
+
+    // Idle: no game read yet, or none for a while
+    uint64_t last = sched->seen_read_us;
+    if (last == 0 || (int64_t)(now - last) > POLL_IDLE_AFTER_US) {
+        sched->read_period_us = 0;
+        sched->idle = 1;
+        sched->poll_period_us = interval > POLL_IDLE_INTERVAL_US ? interval : POLL_IDLE_INTERVAL_US;
+        sched->next_poll_us = now + sched->poll_period_us;
+        return sched->next_poll_us;
+    }
+
+    sched->idle = 0;
+
+    // Reads started but no period yet: follow the device until there is one
+    uint32_t period = sched->read_period_us;
+    if (period == 0) {
+        sched->poll_period_us = interval;
+        sched->next_poll_us = now + interval;
+        return sched->next_poll_us;
+    }
+
+    uint32_t poll_period = period / POLL_SAMPLES_PER_READ;
+    if (poll_period < interval) poll_period = interval;
+    if (poll_period > period) poll_period = period;
+    sched->poll_period_us = poll_period;
+
+    // Start of the last poll before the next predicted read
+    uint64_t lead = POLL_LEAD_US;
+    uint64_t predicted = last + period;
+    if (predicted <= now + lead) {
+        predicted += ((now + lead - predicted) / period + 1) * period;
+    }
+    uint64_t target = predicted - lead;
+
+    // Walk the poll grid back from the target to the first slot after now
+    uint64_t gap = (target - now) % poll_period;
+    if (gap < interval / 2) {
+        gap += poll_period;
+    }
+
+    sched->next_poll_us = now + gap;
+    return sched->next_poll_us;
+}
+
+void poll_sched_get_stats(const PollSchedule* sched, PollScheduleStats* stats) {
+    stats->device_interval_us = sched->device_interval_us;
+    stats->read_period_us = sched->read_period_us;
+    stats->poll_period_us = sched->poll_period_us;
+    stats->polls = sched->polls;
+    stats->transfers_queued = 0;
+    stats->unchanged = 0;
+}
+
+uint32_t poll_sched_interval_us(uint8_t b_interval) {
+    // Full-speed interrupt endpoints: bInterval counts 1ms frames
+    return (b_interval ? b_interval : 1) * 1000u;
+}
@@ -0,0 +1,580 @@
+/*
+ * Per-Title Configuration Profiles Implementation
+ *
+ * The file is read twice: once for [default], once for the title's
+ * section, so the title wins regardless of section order. A remap,
+ * turbo or macro key in the title section replaces the lines of that
+ * kind inherited from [default].
+ *
+ * Reloads happen on the watcher thread only. Two Profile buffers are
+ * enough: a reload waits for the reader's quiescent point before it
+ * returns, so the buffer it leaves behind is free by the next one.
+ *
+ * The watcher also answers latency dump requests, since it already wakes
+ * up to stat a file next to them.
+ */
+
+#include "profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <orbis/libkernel.h>
+#include <GoldHEN.h>
+
+#include <pthread.h>
+
+#if LATENCY_TRACKING
+#include "latency.h"
+#endif
+
+#define PROFILE_LINE_SIZE   512     // Room for a 16-step macro
+#define PROFILE_PATH_SIZE   128
+#define PROFILE_DEFAULT     "default"
+
+// Lists a title section replaces at its first line of each kind
+#define LIST_REMAPS         0x1
+#define LIST_TURBOS         0x2
+#define LIST_MACROS         0x4
+#define LIST_ALL            (LIST_REMAPS | LIST_TURBOS | LIST_MACROS)
+
+/*
+ * File identity used to notice edits
+ */
+typedef struct {
+    int64_t  mtime;
+    int64_t  mtime_ns;      // Two saves within a second
+    int64_t  size;
+    int      exists;
+} ProfileStamp;
+
+ProfileEpochs g_profile_epochs = { .epoch = 1, .reader = 0 };
+
+// Active profile and the buffer the next reload compiles into
+static Profile                 g_profiles[2];
+static const Profile* volatile g_active_profile = NULL;
+static uint32_t                g_generation = 0;
+
+// Watcher thread (the only writer after profile_load)
+static char         g_path[PROFILE_PATH_SIZE];
+static char         g_title_id[PROFILE_TITLE_ID_SIZE];
+static ProfileStamp g_stamp;
+static pthread_t    g_watch_thread;
+static volatile int g_watch_running = 0;
+
+// ============================================
+// Value parsing
+// ============================================
+
+// ASCII case-insensitive compare
+static int name_equals(const char* a, const char* b) {
+    while (*a && *b) {
+        char ca = (*a >= 'A' && *a <= 'Z') ? (char)(*a + 32) : *a;
+        char cb = (*b >= 'A' && *b <= 'Z') ? (char)(*b + 32) : *b;
+        if (ca != cb) {
+            return 0;
+        }
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+static char* trim(char* text) {
+    while (*text == ' ' || *text == '\t') {
+        text++;
+    }
+    char* end = text + strlen(text);
+    while (end > text && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')) {
+        *--end = '\0';
+    }
+    return text;
+}
+
+static int parse_int(const char* text, int min, int max, int* value) {
+    char* end;
+    long parsed = strtol(text, &end, 0);
+    if (end == text || *end != '\0' || parsed < min || parsed > max) {
+        return -1;
+    }
+    *value = (int)parsed;
+    return 0;
+}
+
+/*
+ * Split off the next separator-delimited item
+ * @return Item, NULL when the text is used up
+ */
+static char* next_item(char** cursor, char separator) {
+    char* item = *cursor;
+    if (item == NULL) {
+        return NULL;
+    }
+
+    char* end = strchr(item, separator);
+    if (end) {
+        *end = '\0';
+        *cursor = end + 1;
+    } else {
+        *cursor = NULL;
+    }
+    return item;
+}
+
+static int parse_bool(const char* text, int* value) {
+    if (name_equals(text, "1") || name_equals(text, "true") || name_equals(text, "yes") ||
+        name_equals(text, "on")) {
+        *value = 1;
+    } else if (name_equals(text, "0") || name_equals(text, "false") || name_equals(text, "no") ||
+               name_equals(text, "off")) {
+        *value = 0;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static const struct {
+    const char* name;
+    uint32_t    button;
+} g_button_names[] = {
+    { "cross",    DS4_BUTTON_CROSS },
+    { "circle",   DS4_BUTTON_CIRCLE },
+    { "square",   DS4_BUTTON_SQUARE },
+    { "triangle", DS4_BUTTON_TRIANGLE },
+    { "l1",       DS4_BUTTON_L1 },
+    { "r1",       DS4_BUTTON_R1 },
+    { "l2",       DS4_BUTTON_L2 },
+    { "r2",       DS4_BUTTON_R2 },
+    { "l3",       DS4_BUTTON_L3 },
+    { "r3",       DS4_BUTTON_R3 },
+    { "options",  DS4_BUTTON_OPTIONS },
+    { "share",    DS4_BUTTON_SHARE },
+    { "touchpad", DS4_BUTTON_TOUCHPAD },
+    { "ps",       DS4_BUTTON_PS },
+    { "up",       DS4_BUTTON_DPAD_UP },
+    { "down",     DS4_BUTTON_DPAD_DOWN },
+    { "left",     DS4_BUTTON_DPAD_LEFT },
+    { "right",    DS4_BUTTON_DPAD_RIGHT },
+};
+
+static uint32_t button_by_name(const char* name) {
+    for (size_t i = 0; i < sizeof(g_button_names) / sizeof(g_button_names[0]); i++) {
+        if (name_equals(name, g_button_names[i].name)) {
+            return g_button_names[i].button;
+        }
+    }
+    return 0;
+}
+
+/*
+ * "L1+R1" or "none" (0)
+ */
+static int parse_buttons(char* text, uint32_t* buttons) {
+    *buttons = 0;
+    if (name_equals(text, "none")) {
+        return 0;
+    }
+
+    char* cursor = text;
+    for (char* name = next_item(&cursor, '+'); name; name = next_item(&cursor, '+')) {
+        uint32_t button = button_by_name(trim(name));
+        if (button == 0) {
+            return -1;
+        }
+        *buttons |= button;
+    }
+    return *buttons ? 0 : -1;
+}
+
+/*
+ * "L1 > L1+R1" or "SHARE > none"
+ */
+static int parse_remap(char* text, RemapRule* rule) {
+    char* arrow = strchr(text, '>');
+    if (arrow == NULL) {
+        return -1;
+    }
+    *arrow = '\0';
+
+    rule->from = button_by_name(trim(text));
+    if (rule->from == 0) {
+        return -1;
+    }
+    return parse_buttons(trim(arrow + 1), &rule->to);
+}
+
+/*
+ * "SQUARE : 15" (Hz)
+ */
+static int parse_turbo(char* text, TurboRule* rule) {
+    char* colon = strchr(text, ':');
+    int rate;
+    if (colon == NULL) {
+        return -1;
+    }
+    *colon = '\0';
+
+    rule->button = button_by_name(trim(text));
+    if (rule->button == 0 || parse_int(trim(colon + 1), 1, TURBO_MAX_HZ, &rate) != 0) {
+        return -1;
+    }
+    rule->rate_hz = (uint32_t)rate;
+    return 0;
+}
+
+/*
+ * "L3 > DOWN:1, DOWN+RIGHT:1, RIGHT+SQUARE:2" (buttons:frames, none for a gap)
+ */
+static int parse_macro(char* text, MacroRule* macro) {
+    char* arrow = strchr(text, '>');
+    if (arrow == NULL) {
+        return -1;
+    }
+    *arrow = '\0';
+
+    macro->trigger = button_by_name(trim(text));
+    if (macro->trigger == 0) {
+        return -1;
+    }
+
+    char* cursor = arrow + 1;
+    macro->step_count = 0;
+    for (char* item = next_item(&cursor, ','); item; item = next_item(&cursor, ',')) {
+        char* colon = strchr(item, ':');
+        int frames;
+        if (colon == NULL || macro->step_count == TURBO_MAX_STEPS) {
+            return -1;
+        }
+        *colon = '\0';
+
+        MacroStep* step = &macro->steps[macro->step_count];
+        if (parse_buttons(trim(item), &step->buttons) != 0 ||
+            parse_int(trim(colon + 1), 1, TURBO_MAX_STEP_FRAMES, &frames) != 0) {
+            return -1;
+        }
+        step->frames = (uint32_t)frames;
+        macro->step_count++;
+    }
+    return macro->step_count ? 0 : -1;
+}
+
+static int parse_curve_points(char* text, uint8_t* points) {
+    char* cursor = text;
+    int count = 0;
+
+    for (char* item = next_item(&cursor, ','); item; item = next_item(&cursor, ',')) {
+        int value;
+        if (count == AXIS_CURVE_POINTS || parse_int(trim(item), 0, 127, &value) != 0) {
+            return -1;
+        }
+        points[count++] = (uint8_t)value;
+    }
+    return count == AXIS_CURVE_POINTS ? 0 : -1;
+}
+
+// ============================================
+// Keys
+// ============================================
+
+/*
+ * Apply one key of the section being read
+ * @param replace   LIST_* lists whose inherited lines the next key of
+ *                  that kind drops (its bit is then cleared)
+ * @return 0 if the key and value were understood
+ */
+static int apply_key(ProfileSettings* settings, const char* key, char* value, unsigned* replace) {
+    TranslatorConfig* config = &settings->config;
+    int number;
+
+    if (name_equals(key, "stick_deadzone")) {
+        if (parse_int(value, 0, 127, &number) != 0) return -1;
+        config->stick_deadzone = (uint8_t)number;
+    } else if (name_equals(key, "trigger_threshold")) {
+        if (parse_int(value, 0, 255, &number) != 0) return -1;
+        config->trigger_threshold = (uint8_t)number;
+    } else if (name_equals(key, "invert_left_y")) {
+        return parse_bool(value, &config->invert_left_y);
+    } else if (name_equals(key, "invert_right_y")) {
+        return parse_bool(value, &config->invert_right_y);
+    } else if (name_equals(key, "swap_ab")) {
+        return parse_bool(value, &config->swap_ab);
+    } else if (name_equals(key, "swap_xy")) {
+        return parse_bool(value, &config->swap_xy);
+    } else if (name_equals(key, "deadzone_mode")) {
+        if (name_equals(value, "axial")) config->deadzone_mode = AXIS_DEADZONE_AXIAL;
+        else if (name_equals(value, "radial")) config->deadzone_mode = AXIS_DEADZONE_RADIAL;
+        else if (name_equals(value, "scaled_radial")) config->deadzone_mode = AXIS_DEADZONE_SCALED_RADIAL;
+        else return -1;
+    } else if (name_equals(key, "stick_curve")) {
+        if (name_equals(value, "linear")) config->stick_curve = AXIS_CURVE_LINEAR;
+        else if (name_equals(value, "exponential")) config->stick_curve = AXIS_CURVE_EXPONENTIAL;
+        else if (name_equals(value, "custom")) config->stick_curve = AXIS_CURVE_CUSTOM;
+        else return -1;
+    } else if (name_equals(key, "curve_exponent")) {
+        char* end;
+        float exponent = strtof(value, &end);
+        if (end == value || *end != '\0' || !(exponent > 0.0f && exponent <= 8.0f)) return -1;
+        config->curve_exponent = exponent;
+    } else if (name_equals(key, "curve_points")) {
+        uint8_t points[AXIS_CURVE_POINTS];
+        if (parse_curve_points(value, points) != 0) return -1;
+        memcpy(config->curve_points, points, sizeof(points));
+    } else if (name_equals(key, "poll_rate_hz")) {
+        if (parse_int(value, 0, PROFILE_MAX_POLL_RATE_HZ, &number) != 0) return -1;
+        settings->poll_rate_hz = (uint32_t)number;
+    } else if (name_equals(key, "remap")) {
+        RemapRule rule;
+        if (parse_remap(value, &rule) != 0) return -1;
+        if (*replace & LIST_REMAPS) {
+            settings->remap_count = 0;
+            *replace &= ~LIST_REMAPS;
+        }
+        if (settings->remap_count == PROFILE_MAX_REMAPS) return -1;
+        settings->remaps[settings->remap_count++] = rule;
+    } else if (name_equals(key, "turbo")) {
+        TurboRule rule;
+        if (parse_turbo(value, &rule) != 0) return -1;
+        if (*replace & LIST_TURBOS) {
+            settings->turbo_count = 0;
+            *replace &= ~LIST_TURBOS;
+        }
+        if (settings->turbo_count == TURBO_MAX_RULES) return -1;
+        settings->turbos[settings->turbo_count++] = rule;
+    } else if (name_equals(key, "macro")) {
+        MacroRule macro;
+        if (parse_macro(value, &macro) != 0) return -1;
+        if (*replace & LIST_MACROS) {
+            settings->macro_count = 0;
+            *replace &= ~LIST_MACROS;
+        }
+        if (settings->macro_count == TURBO_MAX_MACROS) return -1;
+        settings->macros[settings->macro_count++] = macro;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Apply every key of one section
+ * @return Lines skipped, or -1 if the section does not exist
+ */
+static int apply_section(FILE* file, const char* section, ProfileSettings* settings, unsigned replace) {
+    char line[PROFILE_LINE_SIZE];
+    int in_section = 0;
+    int found = 0;
+    int skipped = 0;
+
+    rewind(file);
+    while (fgets(line, sizeof(line), file)) {
+        char* comment = strpbrk(line, ";#");
+        if (comment) {
+            *comment = '\0';
+        }
+
+        char* text = trim(line);
+        if (*text == '\0') {
+            continue;
+        }
+
+        if (*text == '[') {
+            char* close = strchr(text, ']');
+            if (close) {
+                *close = '\0';
+            }
+            in_section = name_equals(trim(text + 1), section);
+            found |= in_section;
+            continue;
+        }
+        if (!in_section) {
+            continue;
+        }
+
+        char* equals = strchr(text, '=');
+        if (equals == NULL) {
+            skipped++;
+            continue;
+        }
+        *equals = '\0';
+        if (apply_key(settings, trim(text), trim(equals + 1), &replace) != 0) {
+            skipped++;
+        }
+    }
+
+    return found ? skipped : -1;
+}
+
+// ============================================
+// Parsing and compilation
+// ============================================
+
+int profile_parse(const char* path, const char* title_id, ProfileSettings* settings, int* found) {
+    memset(settings, 0, sizeof(*settings));
+    translator_init(&settings->config);
+    if (found) {
+        *found = 0;
+    }
+
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    int skipped = 0;
+    int lines = apply_section(file, PROFILE_DEFAULT, settings, 0u);
+    if (lines > 0) {
+        skipped += lines;
+    }
+
+    if (title_id && title_id[0] && !name_equals(title_id, PROFILE_DEFAULT)) {
+        lines = apply_section(file, title_id, settings, LIST_ALL);
+        if (lines >= 0) {
+            skipped += lines;
+            if (found) {
+                *found = 1;
+            }
+        }
+    }
+
+    fclose(file);
+    return skipped;
+}
+
+void profile_compile(const ProfileSettings* settings, Profile* profile) {
+    translator_compile(&settings->config, settings->remaps, settings->remap_count, &profile->tables);
+    turbo_compile(&profile->turbo, settings->turbos, settings->turbo_count,
+                  settings->macros, settings->macro_count);
+    profile->poll_interval_us = settings->poll_rate_hz ? 1000000u / settings->poll_rate_hz : 0;
+}
+
+// ============================================
+// Publication
+// ============================================
+
+static void stamp_file(const char* path, ProfileStamp* stamp) {
+    struct stat info;
+
+    memset(stamp, 0, sizeof(*stamp));
+    if (stat(path, &info) == 0) {
+        stamp->mtime = (int64_t)info.st_mtim.tv_sec;
+        stamp->mtime_ns = (int64_t)info.st_mtim.tv_nsec;
+        stamp->size = (int64_t)info.st_size;
+        stamp->exists = 1;
+    }
+}
+
+/*
+ * Wait until the reader has passed a quiescent point after a publish
+ * An offline reader holds nothing and is not waited for.
+ */
+static void synchronize(void) {
+    uint64_t target = __atomic_add_fetch(&g_profile_epochs.epoch, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    for (;;) {
+        uint64_t reader = __atomic_load_n(&g_profile_epochs.reader, __ATOMIC_ACQUIRE);
+        if (reader == 0 || reader >= target) {
+            return;
+        }
+        sceKernelUsleep(PROFILE_GRACE_POLL_US);
+    }
+}
+
+/*
+ * Read the file, compile it into the spare buffer and publish it
+ * The previous profile becomes the spare once no report uses it.
+ * @return Number of lines skipped, -1 if the file cannot be opened
+ */
+static int reload(void) {
+    const Profile* active = g_active_profile;
+    Profile* next = (active == &g_profiles[0]) ? &g_profiles[1] : &g_profiles[0];
+    ProfileSettings settings;
+    int found = 0;
+
+    int skipped = profile_parse(g_path, g_title_id, &settings, &found);
+
+    profile_compile(&settings, next);
+    next->generation = ++g_generation;
+    next->title_section = found;
+    memcpy(next->title_id, g_title_id, sizeof(next->title_id));
+
+    // Publish after the tables are complete
+    __atomic_store_n(&g_active_profile, next, __ATOMIC_RELEASE);
+    synchronize();
+    return skipped;
+}
+
+static void* watch_thread_func(void* arg) {
+    (void)arg;
+    ProfileStamp stamp;
+
+    while (g_watch_running) {
+        sceKernelUsleep(PROFILE_WATCH_INTERVAL_US);
+
+        stamp_file(g_path, &stamp);
+        if (memcmp(&stamp, &g_stamp, sizeof(stamp)) != 0) {
+            g_stamp = stamp;
+            reload();
+        }
+
+#if LATENCY_TRACKING
+        // The request file is consumed so the next one dumps again
+        struct stat request;
+        if (stat(LATENCY_DUMP_REQUEST_PATH, &request) == 0) {
+            latency_dump(LATENCY_DUMP_PATH);
+            unlink(LATENCY_DUMP_REQUEST_PATH);
+        }
+#endif
+    }
+    return NULL;
+}
+
+// ============================================
+// Public API
+// ============================================
+
+int profile_load(const char* path) {
+    struct proc_info info;
+
+    memset(&info, 0, sizeof(info));
+    if (sys_sdk_proc_info(&info) != 0) {
+        info.titleid[0] = '\0';
+    }
+    memcpy(g_title_id, info.titleid, sizeof(g_title_id));
+    g_title_id[sizeof(g_title_id) - 1] = '\0';
+
+    strncpy(g_path, path, sizeof(g_path) - 1);
+    g_path[sizeof(g_path) - 1] = '\0';
+    stamp_file(g_path, &g_stamp);
+
+    return reload();
+}
+
+const Profile* profile_active(void) {
+    return __atomic_load_n(&g_active_profile, __ATOMIC_ACQUIRE);
+}
+
+int profile_watch_start(void) {
+    if (g_watch_running || g_path[0] == '\0') {
+        return -1;
+    }
+
+    g_watch_running = 1;
+    if (pthread_create(&g_watch_thread, NULL, watch_thread_func, NULL) != 0) {
+        g_watch_running = 0;
+        return -2;
+    }
+    return 0;
+}
+
+void profile_watch_stop(void) {
+    if (!g_watch_running) {
+        return;
+    }
+
+    g_watch_running = 0;
+    pthread_join(g_watch_thread, NULL);
+}
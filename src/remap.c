@@ -0,0 +1,163 @@
+/*
+ * Button Remap Engine Implementation
+ *
+ * Each default table entry is the OR of the DS4 buttons of every bit
+ * set in the index. The bit-to-button lists below are the only place
+ * the physical layouts are described; the preprocessor expands them
+ * into the full 256-entry tables.
+ */
+
+#include "remap.h"
+#include "ds4.h"
+#include "xbox360.h"
+#include "xboxone.h"
+#include "switch_controller.h"
+#include "lut.h"
+
+// ============================================
+// Table generation
+// ============================================
+
+#define REMAP_BIT(b, n, target)     ((((b) >> (n)) & 1) ? (uint32_t)(target) : 0u)
+
+#define REMAP_ENTRY(b, t0, t1, t2, t3, t4, t5, t6, t7) \
+    (REMAP_BIT(b, 0, t0) | REMAP_BIT(b, 1, t1) | REMAP_BIT(b, 2, t2) | REMAP_BIT(b, 3, t3) | \
+     REMAP_BIT(b, 4, t4) | REMAP_BIT(b, 5, t5) | REMAP_BIT(b, 6, t6) | REMAP_BIT(b, 7, t7))
+
+// Indirection so the layout lists below expand into eight arguments
+#define REMAP_EXPAND(b, layout)     REMAP_ENTRY_(b, layout)
+#define REMAP_ENTRY_(b, ...)        REMAP_ENTRY(b, __VA_ARGS__)
+
+
+// ============================================
+// Physical layouts (bit 0 first)
+// ============================================
+
+// Xbox 360 buttons_low: d-pad, Start, Back, stick clicks
+#define XBOX360_LO_LAYOUT \
+    DS4_BUTTON_DPAD_UP, DS4_BUTTON_DPAD_DOWN, DS4_BUTTON_DPAD_LEFT, DS4_BUTTON_DPAD_RIGHT, \
+    DS4_BUTTON_OPTIONS, DS4_BUTTON_SHARE, DS4_BUTTON_L3, DS4_BUTTON_R3
+
+// Xbox 360 buttons_high: bumpers, Guide, unused, A/B/X/Y
+#define XBOX360_HI_LAYOUT \
+    DS4_BUTTON_L1, DS4_BUTTON_R1, DS4_BUTTON_PS, 0, \
+    DS4_BUTTON_CROSS, DS4_BUTTON_CIRCLE, DS4_BUTTON_SQUARE, DS4_BUTTON_TRIANGLE
+
+// Xbox One buttons_low: Sync, unused, Menu, View, A/B/X/Y
+// (Guide arrives in its own report)
+#define XBOXONE_LO_LAYOUT \
+    0, 0, DS4_BUTTON_OPTIONS, DS4_BUTTON_SHARE, \
+    DS4_BUTTON_CROSS, DS4_BUTTON_CIRCLE, DS4_BUTTON_SQUARE, DS4_BUTTON_TRIANGLE
+
+// Xbox One buttons_high: d-pad, bumpers, stick clicks
+#define XBOXONE_HI_LAYOUT \
+    DS4_BUTTON_DPAD_UP, DS4_BUTTON_DPAD_DOWN, DS4_BUTTON_DPAD_LEFT, DS4_BUTTON_DPAD_RIGHT, \
+    DS4_BUTTON_L1, DS4_BUTTON_R1, DS4_BUTTON_L3, DS4_BUTTON_R3
+
+// Switch buttons0: Nintendo face layout (A=East, B=South), shoulders, ZL/ZR
+#define SWITCH_LO_LAYOUT \
+    DS4_BUTTON_SQUARE, DS4_BUTTON_CROSS, DS4_BUTTON_CIRCLE, DS4_BUTTON_TRIANGLE, \
+    DS4_BUTTON_L1, DS4_BUTTON_R1, DS4_BUTTON_L2, DS4_BUTTON_R2
+
+// Switch buttons1: Minus, Plus, stick clicks, Home, Capture (unused)
+#define SWITCH_HI_LAYOUT \
+    DS4_BUTTON_SHARE, DS4_BUTTON_OPTIONS, DS4_BUTTON_L3, DS4_BUTTON_R3, \
+    DS4_BUTTON_PS, 0, 0, 0
+
+#define XBOX360_LO(b)   REMAP_EXPAND(b, XBOX360_LO_LAYOUT)
+#define XBOX360_HI(b)   REMAP_EXPAND(b, XBOX360_HI_LAYOUT)
+#define XBOXONE_LO(b)   REMAP_EXPAND(b, XBOXONE_LO_LAYOUT)
+#define XBOXONE_HI(b)   REMAP_EXPAND(b, XBOXONE_HI_LAYOUT)
+#define SWITCH_LO(b)    REMAP_EXPAND(b, SWITCH_LO_LAYOUT)
+#define SWITCH_HI(b)    REMAP_EXPAND(b, SWITCH_HI_LAYOUT)
+
+const RemapTable g_remap_xbox360 = {
+    .lo = LUT_256(XBOX360_LO),
+    .hi = LUT_256(XBOX360_HI),
+    .left_trigger = DS4_BUTTON_L2,
+    .right_trigger = DS4_BUTTON_R2,
+};
+
+const RemapTable g_remap_xboxone = {
+    .lo = LUT_256(XBOXONE_LO),
+    .hi = LUT_256(XBOXONE_HI),
+    .left_trigger = DS4_BUTTON_L2,
+    .right_trigger = DS4_BUTTON_R2,
+};
+
+// ZL/ZR are plain buttons in buttons0, so no trigger thresholds
+const RemapTable g_remap_switch = {
+    .lo = LUT_256(SWITCH_LO),
+    .hi = LUT_256(SWITCH_HI),
+    .hat = {
+        [SWITCH_HAT_UP]         = DS4_BUTTON_DPAD_UP,
+        [SWITCH_HAT_UP_RIGHT]   = DS4_BUTTON_DPAD_UP | DS4_BUTTON_DPAD_RIGHT,
+        [SWITCH_HAT_RIGHT]      = DS4_BUTTON_DPAD_RIGHT,
+        [SWITCH_HAT_DOWN_RIGHT] = DS4_BUTTON_DPAD_DOWN | DS4_BUTTON_DPAD_RIGHT,
+        [SWITCH_HAT_DOWN]       = DS4_BUTTON_DPAD_DOWN,
+        [SWITCH_HAT_DOWN_LEFT]  = DS4_BUTTON_DPAD_DOWN | DS4_BUTTON_DPAD_LEFT,
+        [SWITCH_HAT_LEFT]       = DS4_BUTTON_DPAD_LEFT,
+        [SWITCH_HAT_UP_LEFT]    = DS4_BUTTON_DPAD_UP | DS4_BUTTON_DPAD_LEFT,
+    },
+};
+
+// ============================================
+// Runtime build
+// ============================================
+
+/*
+ * Replacement for each DS4 button bit
+ */
+typedef struct {
+    uint32_t to[32];
+} ButtonMap;
+
+static void map_swap(ButtonMap* map, uint32_t a, uint32_t b) {
+    int ia = __builtin_ctz(a);
+    int ib = __builtin_ctz(b);
+    uint32_t t = map->to[ia];
+    map->to[ia] = map->to[ib];
+    map->to[ib] = t;
+}
+
+static uint32_t map_apply(const ButtonMap* map, uint32_t buttons) {
+    uint32_t out = 0;
+    while (buttons) {
+        int bit = __builtin_ctz(buttons);
+        out |= map->to[bit];
+        buttons &= buttons - 1;
+    }
+    return out;
+}
+
+void remap_build(RemapTable* table, const RemapTable* base, int swap_ab, int swap_xy,
+                 const RemapRule* rules, int count) {
+    ButtonMap swapped;
+    ButtonMap map;
+
+    for (int i = 0; i < 32; i++) {
+        swapped.to[i] = 1u << i;
+    }
+    if (swap_ab) map_swap(&swapped, DS4_BUTTON_CROSS, DS4_BUTTON_CIRCLE);
+    if (swap_xy) map_swap(&swapped, DS4_BUTTON_SQUARE, DS4_BUTTON_TRIANGLE);
+
+    // User rules act on the swapped button, later rules win
+    map = swapped;
+    for (int i = 0; i < 32; i++) {
+        for (int r = 0; r < count; r++) {
+            if (rules[r].from != 0 && swapped.to[i] == rules[r].from) {
+                map.to[i] = rules[r].to;
+            }
+        }
+    }
+
+    for (int i = 0; i < 256; i++) {
+        table->lo[i] = map_apply(&map, base->lo[i]);
+        table->hi[i] = map_apply(&map, base->hi[i]);
+    }
+    for (int i = 0; i < 16; i++) {
+        table->hat[i] = map_apply(&map, base->hat[i]);
+    }
+    table->left_trigger = map_apply(&map, base->left_trigger);
+    table->right_trigger = map_apply(&map, base->right_trigger);
+}
@@ -1,6 +1,7 @@
 /*
  * Xbox 360 to DualShock 4 Input Translator
- * Converts Xbox 360 USB reports to PS4 OrbisPadData format
+ * Decodes Xbox 360, Xbox One and Switch reports into PadState; the DS4
+ * layout is written by pad_state_emit only.
  */
 
 #include "translator.h"
@@ -21,17 +22,51 @@ void translator_init(TranslatorConfig* config) {
     config->invert_right_y = 1;
     config->swap_ab = 0;
     config->swap_xy = 0;
+    config->deadzone_mode = AXIS_DEADZONE_AXIAL;
+    config->stick_curve = AXIS_CURVE_LINEAR;
+    config->curve_exponent = 2.0f;
+    for (int i = 0; i < AXIS_CURVE_POINTS; i++) {
+        config->curve_points[i] = (uint8_t)(i * 127 / (AXIS_CURVE_POINTS - 1));
+    }
 }
 
+// Defaults used when no tables are given (matches translator_init)
+static const TranslatorConfig s_default_config = {
+    .stick_deadzone = DEFAULT_STICK_DEADZONE,
+    .trigger_threshold = DEFAULT_TRIGGER_THRESHOLD,
+    .invert_left_y = 1,
+    .invert_right_y = 1,
+    .swap_ab = 0,
+    .swap_xy = 0,
+    .deadzone_mode = AXIS_DEADZONE_AXIAL,
+    .stick_curve = AXIS_CURVE_LINEAR,
+    .curve_exponent = 2.0f,
+    .curve_points = { 0, 15, 31, 47, 63, 79, 95, 111, 127 },
+};
+
 /*
- * Convert Xbox 360 16-bit signed stick value to DS4 8-bit unsigned
- *
- * Xbox:  -32768 to 32767, center = 0
- * DS4:   0 to 255, center = 128
+ * Compile configuration and remaps into lookup tables
  */
-static inline uint8_t convert_stick_value(int16_t xbox_val) {
-    int32_t temp = (int32_t)xbox_val + 32768;
-    return (uint8_t)(temp >> 8);
+void translator_compile(const TranslatorConfig* config, const RemapRule* rules, int count,
+                        TranslatorTables* tables) {
+    if (!config) {
+        config = &s_default_config;
+    }
+
+    tables->config = *config;
+    remap_build(&tables->xbox360, &g_remap_xbox360, config->swap_ab, config->swap_xy, rules, count);
+    remap_build(&tables->xboxone, &g_remap_xboxone, config->swap_ab, config->swap_xy, rules, count);
+    remap_build(&tables->switch_pad, &g_remap_switch, config->swap_ab, config->swap_xy, rules, count);
+
+    AxisConfig axis = {
+        .mode = config->deadzone_mode,
+        .deadzone = config->stick_deadzone,
+        .curve = config->stick_curve,
+        .exponent = config->curve_exponent,
+    };
+    memcpy(axis.points, config->curve_points, sizeof(axis.points));
+    axis_build(&tables->axes, tables->radial_gain, &axis, config->invert_left_y, config->invert_right_y);
+    axis_build(&tables->switch_axes, tables->radial_gain, &axis, !config->invert_left_y, !config->invert_right_y);
 }
 
 /*
@@ -57,139 +92,131 @@ uint8_t translator_apply_deadzone(uint8_t value, uint8_t deadzone) {
     }
 }
 
+// ============================================
+// Shared stages (on the normalized state)
+// ============================================
+
 /*
- * Main translation function
+ * Deadzone, curve and inversion through the axis tables
+ * Raw sticks in, DS4-oriented sticks out.
  */
-void translator_convert(const Xbox360Report* xbox, OrbisPadData* ds4, const TranslatorConfig* config) {
-    // Use default config if none provided
-    TranslatorConfig default_config;
-    if (!config) {
-        translator_init(&default_config);
-        config = &default_config;
-    }
-
-    // Clear output structure
-    memset(ds4, 0, sizeof(OrbisPadData));
-
-    // Get combined Xbox button state
-    uint16_t xbox_buttons = xbox360_get_buttons(xbox);
-
-    // ========================================
-    // ANALOG STICKS (using OpenOrbis 'stick' struct)
-    // ========================================
-
-    uint8_t lx = convert_stick_value(xbox->left_stick_x);
-    uint8_t ly = convert_stick_value(xbox->left_stick_y);
-    uint8_t rx = convert_stick_value(xbox->right_stick_x);
-    uint8_t ry = convert_stick_value(xbox->right_stick_y);
+static inline void filter_sticks(PadState* pad, const AxisTable* axes, const uint16_t* radial_gain) {
+    uint8_t x, y;
+
+    axis_apply(axes, &axes->left, radial_gain,
+               pad_stick_to_u8(pad->left_x), pad_stick_to_u8(pad->left_y), &x, &y);
+    pad->left_x = pad_stick_from_u8(x);
+    pad->left_y = pad_stick_from_u8(y);
+
+    axis_apply(axes, &axes->right, radial_gain,
+               pad_stick_to_u8(pad->right_x), pad_stick_to_u8(pad->right_y), &x, &y);
+    pad->right_x = pad_stick_from_u8(x);
+    pad->right_y = pad_stick_from_u8(y);
+}
 
-    // Apply Y-axis inversion
-    if (config->invert_left_y) {
-        ly = 255 - ly;
-    }
-    if (config->invert_right_y) {
-        ry = 255 - ry;
+// Digital L2/R2 (or whatever they are remapped to) past the threshold
+static inline void trigger_buttons(PadState* pad, const RemapTable* remap, uint8_t threshold) {
+    if (pad_trigger_to_u8(pad->l2) >= threshold) {
+        pad->buttons |= remap->left_trigger;
     }
-
-    // Apply deadzone
-    if (config->stick_deadzone > 0) {
-        lx = translator_apply_deadzone(lx, config->stick_deadzone);
-        ly = translator_apply_deadzone(ly, config->stick_deadzone);
-        rx = translator_apply_deadzone(rx, config->stick_deadzone);
-        ry = translator_apply_deadzone(ry, config->stick_deadzone);
+    if (pad_trigger_to_u8(pad->r2) >= threshold) {
+        pad->buttons |= remap->right_trigger;
     }
+}
 
-    ds4->leftStick.x = lx;
-    ds4->leftStick.y = ly;
-    ds4->rightStick.x = rx;
-    ds4->rightStick.y = ry;
-
-    // ========================================
-    // ANALOG TRIGGERS (using OpenOrbis 'analog' struct)
-    // ========================================
-
-    ds4->analogButtons.l2 = xbox->left_trigger;
-    ds4->analogButtons.r2 = xbox->right_trigger;
-
-    // ========================================
-    // DIGITAL BUTTONS
-    // ========================================
-
-    uint32_t ds4_buttons = 0;
-
-    // Face buttons with optional swap
-    if (config->swap_ab) {
-        if (xbox_buttons & XBOX360_BTN_A) ds4_buttons |= DS4_BUTTON_CIRCLE;
-        if (xbox_buttons & XBOX360_BTN_B) ds4_buttons |= DS4_BUTTON_CROSS;
-    } else {
-        if (xbox_buttons & XBOX360_BTN_A) ds4_buttons |= DS4_BUTTON_CROSS;
-        if (xbox_buttons & XBOX360_BTN_B) ds4_buttons |= DS4_BUTTON_CIRCLE;
-    }
+// ============================================
+// Decoders
+// ============================================
 
-    if (config->swap_xy) {
-        if (xbox_buttons & XBOX360_BTN_X) ds4_buttons |= DS4_BUTTON_TRIANGLE;
-        if (xbox_buttons & XBOX360_BTN_Y) ds4_buttons |= DS4_BUTTON_SQUARE;
-    } else {
-        if (xbox_buttons & XBOX360_BTN_X) ds4_buttons |= DS4_BUTTON_SQUARE;
-        if (xbox_buttons & XBOX360_BTN_Y) ds4_buttons |= DS4_BUTTON_TRIANGLE;
-    }
+void translator_decode(const Xbox360Report* xbox, PadState* pad, const TranslatorTables* tables) {
+    // Use default tables if none provided
+    const TranslatorConfig* config = tables ? &tables->config : &s_default_config;
+    const RemapTable* remap = tables ? &tables->xbox360 : &g_remap_xbox360;
+    const AxisTable* axes = tables ? &tables->axes : &g_axis_default;
+    const uint16_t* radial_gain = tables ? tables->radial_gain : NULL;
 
-    // Shoulder buttons
-    if (xbox_buttons & XBOX360_BTN_LB) ds4_buttons |= DS4_BUTTON_L1;
-    if (xbox_buttons & XBOX360_BTN_RB) ds4_buttons |= DS4_BUTTON_R1;
+    // Face, shoulder, menu, stick click and d-pad bits in two lookups
+    pad->buttons = remap_buttons(remap, xbox->buttons_low, xbox->buttons_high);
 
-    // Digital trigger buttons
-    if (xbox->left_trigger >= config->trigger_threshold) {
-        ds4_buttons |= DS4_BUTTON_L2;
-    }
-    if (xbox->right_trigger >= config->trigger_threshold) {
-        ds4_buttons |= DS4_BUTTON_R2;
-    }
+    // Sticks are already signed 16-bit
+    pad->left_x = xbox->left_stick_x;
+    pad->left_y = xbox->left_stick_y;
+    pad->right_x = xbox->right_stick_x;
+    pad->right_y = xbox->right_stick_y;
 
-    // Stick click buttons
-    if (xbox_buttons & XBOX360_BTN_L3) ds4_buttons |= DS4_BUTTON_L3;
-    if (xbox_buttons & XBOX360_BTN_R3) ds4_buttons |= DS4_BUTTON_R3;
+    pad->l2 = pad_trigger_from_u8(xbox->left_trigger);
+    pad->r2 = pad_trigger_from_u8(xbox->right_trigger);
+    pad->timestamp = 0;
 
-    // Menu buttons
-    if (xbox_buttons & XBOX360_BTN_START) ds4_buttons |= DS4_BUTTON_OPTIONS;
-    if (xbox_buttons & XBOX360_BTN_BACK)  ds4_buttons |= DS4_BUTTON_SHARE;
+    filter_sticks(pad, axes, radial_gain);
+    trigger_buttons(pad, remap, config->trigger_threshold);
+}
 
-    // Guide button -> PS button
-    if (xbox_buttons & XBOX360_BTN_GUIDE) ds4_buttons |= DS4_BUTTON_PS;
+void translator_decode_xboxone(const XboxOneReport* xbox, PadState* pad, const TranslatorTables* tables) {
+    // Use default tables if none provided
+    const TranslatorConfig* config = tables ? &tables->config : &s_default_config;
+    const RemapTable* remap = tables ? &tables->xboxone : &g_remap_xboxone;
+    const AxisTable* axes = tables ? &tables->axes : &g_axis_default;
+    const uint16_t* radial_gain = tables ? tables->radial_gain : NULL;
+
+    // Face, menu, shoulder, stick click and d-pad bits in two lookups
+    // (Guide comes in a separate GIP packet (0x07), merged by the driver)
+    pad->buttons = remap_buttons(remap, xbox->buttons_low, xbox->buttons_high);
+
+    // Same stick format as the Xbox 360
+    pad->left_x = xbox->left_stick_x;
+    pad->left_y = xbox->left_stick_y;
+    pad->right_x = xbox->right_stick_x;
+    pad->right_y = xbox->right_stick_y;
+
+    // Native 10-bit triggers
+    pad->l2 = xbox->left_trigger;
+    pad->r2 = xbox->right_trigger;
+    pad->timestamp = 0;
+
+    filter_sticks(pad, axes, radial_gain);
+    trigger_buttons(pad, remap, config->trigger_threshold);
+}
 
-    // ========================================
-    // D-PAD
-    // ========================================
+void translator_decode_switch(const SwitchInputOnlyReport* sw, PadState* pad, const TranslatorTables* tables) {
+    // Use default tables if none provided
+    const TranslatorConfig* config = tables ? &tables->config : &s_default_config;
+    const RemapTable* remap = tables ? &tables->switch_pad : &g_remap_switch;
 
-    uint8_t xbox_dpad = xbox360_get_dpad(xbox);
-    ds4_buttons |= dpad_bits_to_buttons(xbox_dpad);
+    // Switch sticks don't need Y-axis inversion by default
+    const AxisTable* axes = tables ? &tables->switch_axes : &g_axis_default_noninverted;
+    const uint16_t* radial_gain = tables ? tables->radial_gain : NULL;
 
-    // Store final button state
-    ds4->buttons = ds4_buttons;
+    // Face, shoulder, ZL/ZR, menu and stick click bits in two lookups,
+    // d-pad from the hat (Nintendo layout: A=East -> Circle, B=South -> Cross)
+    pad->buttons = remap_buttons(remap, sw->buttons0, sw->buttons1) | remap_hat(remap, sw->hat);
 
-    // ========================================
-    // STATUS & METADATA
-    // ========================================
+    // 8-bit sticks
+    pad->left_x = pad_stick_from_u8(sw->left_stick_x);
+    pad->left_y = pad_stick_from_u8(sw->left_stick_y);
+    pad->right_x = pad_stick_from_u8(sw->right_stick_x);
+    pad->right_y = pad_stick_from_u8(sw->right_stick_y);
 
-    ds4->connected = 1;
-    ds4->timestamp = s_timestamp++;
+    // ZL/ZR are digital on Switch, output full press or nothing
+    pad->l2 = (sw->buttons0 & SWITCH_BTN_ZL) ? PAD_TRIGGER_MAX : 0;
+    pad->r2 = (sw->buttons0 & SWITCH_BTN_ZR) ? PAD_TRIGGER_MAX : 0;
+    pad->timestamp = 0;
 
-    // Motion data - set to neutral
-    ds4->quat.x = 0.0f;
-    ds4->quat.y = 0.0f;
-    ds4->quat.z = 0.0f;
-    ds4->quat.w = 1.0f;
+    filter_sticks(pad, axes, radial_gain);
+    // ZL/ZR buttons already come from the remap table (no trigger masks)
+    trigger_buttons(pad, remap, config->trigger_threshold);
+}
 
-    ds4->vel.x = 0.0f;
-    ds4->vel.y = 0.0f;
-    ds4->vel.z = 0.0f;
+// ============================================
+// Decode + emit
+// ============================================
 
-    ds4->acell.x = 0.0f;
-    ds4->acell.y = 0.0f;
-    ds4->acell.z = 1.0f;  // 1g downward
+void translator_convert(const Xbox360Report* xbox, OrbisPadData* ds4, const TranslatorTables* tables) {
+    PadState pad;
 
-    // Touchpad - no touches
-    ds4->touch.fingers = 0;
+    translator_decode(xbox, &pad, tables);
+    pad.timestamp = s_timestamp++;
+    pad_state_emit(&pad, ds4);
 }
 
 /*
@@ -199,137 +226,12 @@ void xbox360_to_ds4(const Xbox360Report* xbox, OrbisPadData* ds4) {
     translator_convert(xbox, ds4, NULL);
 }
 
-/*
- * Xbox One translation function
- */
-void translator_convert_xboxone(const XboxOneReport* xbox, OrbisPadData* ds4, const TranslatorConfig* config) {
-    // Use default config if none provided
-    TranslatorConfig default_config;
-    if (!config) {
-        translator_init(&default_config);
-        config = &default_config;
-    }
-
-    // Clear output structure
-    memset(ds4, 0, sizeof(OrbisPadData));
-
-    // ========================================
-    // ANALOG STICKS (same format as Xbox 360)
-    // ========================================
-
-    uint8_t lx = convert_stick_value(xbox->left_stick_x);
-    uint8_t ly = convert_stick_value(xbox->left_stick_y);
-    uint8_t rx = convert_stick_value(xbox->right_stick_x);
-    uint8_t ry = convert_stick_value(xbox->right_stick_y);
-
-    // Apply Y-axis inversion
-    if (config->invert_left_y) {
-        ly = 255 - ly;
-    }
-    if (config->invert_right_y) {
-        ry = 255 - ry;
-    }
-
-    // Apply deadzone
-    if (config->stick_deadzone > 0) {
-        lx = translator_apply_deadzone(lx, config->stick_deadzone);
-        ly = translator_apply_deadzone(ly, config->stick_deadzone);
-        rx = translator_apply_deadzone(rx, config->stick_deadzone);
-        ry = translator_apply_deadzone(ry, config->stick_deadzone);
-    }
-
-    ds4->leftStick.x = lx;
-    ds4->leftStick.y = ly;
-    ds4->rightStick.x = rx;
-    ds4->rightStick.y = ry;
-
-    // ========================================
-    // ANALOG TRIGGERS (Xbox One uses 10-bit, convert to 8-bit)
-    // ========================================
-
-    ds4->analogButtons.l2 = xboxone_trigger_to_8bit(xbox->left_trigger);
-    ds4->analogButtons.r2 = xboxone_trigger_to_8bit(xbox->right_trigger);
-
-    // ========================================
-    // DIGITAL BUTTONS
-    // ========================================
-
-    uint32_t ds4_buttons = 0;
-
-    // Face buttons (Xbox One layout: A/B/X/Y in buttons_low)
-    if (config->swap_ab) {
-        if (xbox->buttons_low & XBOXONE_A) ds4_buttons |= DS4_BUTTON_CIRCLE;
-        if (xbox->buttons_low & XBOXONE_B) ds4_buttons |= DS4_BUTTON_CROSS;
-    } else {
-        if (xbox->buttons_low & XBOXONE_A) ds4_buttons |= DS4_BUTTON_CROSS;
-        if (xbox->buttons_low & XBOXONE_B) ds4_buttons |= DS4_BUTTON_CIRCLE;
-    }
+void translator_convert_xboxone(const XboxOneReport* xbox, OrbisPadData* ds4, const TranslatorTables* tables) {
+    PadState pad;
 
-    if (config->swap_xy) {
-        if (xbox->buttons_low & XBOXONE_X) ds4_buttons |= DS4_BUTTON_TRIANGLE;
-        if (xbox->buttons_low & XBOXONE_Y) ds4_buttons |= DS4_BUTTON_SQUARE;
-    } else {
-        if (xbox->buttons_low & XBOXONE_X) ds4_buttons |= DS4_BUTTON_SQUARE;
-        if (xbox->buttons_low & XBOXONE_Y) ds4_buttons |= DS4_BUTTON_TRIANGLE;
-    }
-
-    // Shoulder buttons (in buttons_high)
-    if (xbox->buttons_high & XBOXONE_LB) ds4_buttons |= DS4_BUTTON_L1;
-    if (xbox->buttons_high & XBOXONE_RB) ds4_buttons |= DS4_BUTTON_R1;
-
-    // Digital trigger buttons (use 8-bit converted value)
-    uint8_t lt = xboxone_trigger_to_8bit(xbox->left_trigger);
-    uint8_t rt = xboxone_trigger_to_8bit(xbox->right_trigger);
-    if (lt >= config->trigger_threshold) {
-        ds4_buttons |= DS4_BUTTON_L2;
-    }
-    if (rt >= config->trigger_threshold) {
-        ds4_buttons |= DS4_BUTTON_R2;
-    }
-
-    // Stick click buttons (in buttons_high)
-    if (xbox->buttons_high & XBOXONE_LEFT_STICK)  ds4_buttons |= DS4_BUTTON_L3;
-    if (xbox->buttons_high & XBOXONE_RIGHT_STICK) ds4_buttons |= DS4_BUTTON_R3;
-
-    // Menu buttons (in buttons_low)
-    if (xbox->buttons_low & XBOXONE_MENU) ds4_buttons |= DS4_BUTTON_OPTIONS;
-    if (xbox->buttons_low & XBOXONE_VIEW) ds4_buttons |= DS4_BUTTON_SHARE;
-
-    // Note: Xbox/Guide button comes in separate report (0x07), not handled here
-
-    // ========================================
-    // D-PAD (in buttons_high, same bit layout as Xbox 360)
-    // ========================================
-
-    uint8_t xbox_dpad = xboxone_get_dpad(xbox);
-    ds4_buttons |= dpad_bits_to_buttons(xbox_dpad);
-
-    // Store final button state
-    ds4->buttons = ds4_buttons;
-
-    // ========================================
-    // STATUS & METADATA
-    // ========================================
-
-    ds4->connected = 1;
-    ds4->timestamp = s_timestamp++;
-
-    // Motion data - set to neutral
-    ds4->quat.x = 0.0f;
-    ds4->quat.y = 0.0f;
-    ds4->quat.z = 0.0f;
-    ds4->quat.w = 1.0f;
-
-    ds4->vel.x = 0.0f;
-    ds4->vel.y = 0.0f;
-    ds4->vel.z = 0.0f;
-
-    ds4->acell.x = 0.0f;
-    ds4->acell.y = 0.0f;
-    ds4->acell.z = 1.0f;  // 1g downward
-
-    // Touchpad - no touches
-    ds4->touch.fingers = 0;
+    translator_decode_xboxone(xbox, &pad, tables);
+    pad.timestamp = s_timestamp++;
+    pad_state_emit(&pad, ds4);
 }
 
 /*
@@ -339,162 +241,12 @@ void xboxone_to_ds4(const XboxOneReport* xbox, OrbisPadData* ds4) {
     translator_convert_xboxone(xbox, ds4, NULL);
 }
 
-/*
- * Convert Switch hat value to DS4 d-pad buttons
- */
-static uint32_t switch_hat_to_dpad(uint8_t hat) {
-    switch (hat) {
-        case SWITCH_HAT_UP:
-            return DS4_BUTTON_DPAD_UP;
-        case SWITCH_HAT_UP_RIGHT:
-            return DS4_BUTTON_DPAD_UP | DS4_BUTTON_DPAD_RIGHT;
-        case SWITCH_HAT_RIGHT:
-            return DS4_BUTTON_DPAD_RIGHT;
-        case SWITCH_HAT_DOWN_RIGHT:
-            return DS4_BUTTON_DPAD_DOWN | DS4_BUTTON_DPAD_RIGHT;
-        case SWITCH_HAT_DOWN:
-            return DS4_BUTTON_DPAD_DOWN;
-        case SWITCH_HAT_DOWN_LEFT:
-            return DS4_BUTTON_DPAD_DOWN | DS4_BUTTON_DPAD_LEFT;
-        case SWITCH_HAT_LEFT:
-            return DS4_BUTTON_DPAD_LEFT;
-        case SWITCH_HAT_UP_LEFT:
-            return DS4_BUTTON_DPAD_UP | DS4_BUTTON_DPAD_LEFT;
-        default:
-            return 0;  // Centered or invalid
-    }
-}
-
-/*
- * Switch Input-Only controller translation function
- */
-void translator_convert_switch(const SwitchInputOnlyReport* sw, OrbisPadData* ds4, const TranslatorConfig* config) {
-    // Use default config if none provided
-    TranslatorConfig default_config;
-    if (!config) {
-        translator_init(&default_config);
-        // Switch sticks don't need Y-axis inversion
-        default_config.invert_left_y = 0;
-        default_config.invert_right_y = 0;
-        config = &default_config;
-    }
-
-    // Clear output structure
-    memset(ds4, 0, sizeof(OrbisPadData));
-
-    // ========================================
-    // ANALOG STICKS (already 8-bit 0-255 format)
-    // ========================================
-
-    uint8_t lx = sw->left_stick_x;
-    uint8_t ly = sw->left_stick_y;
-    uint8_t rx = sw->right_stick_x;
-    uint8_t ry = sw->right_stick_y;
-
-    // Apply Y-axis inversion if configured
-    if (config->invert_left_y) {
-        ly = 255 - ly;
-    }
-    if (config->invert_right_y) {
-        ry = 255 - ry;
-    }
-
-    // Apply deadzone
-    if (config->stick_deadzone > 0) {
-        lx = translator_apply_deadzone(lx, config->stick_deadzone);
-        ly = translator_apply_deadzone(ly, config->stick_deadzone);
-        rx = translator_apply_deadzone(rx, config->stick_deadzone);
-        ry = translator_apply_deadzone(ry, config->stick_deadzone);
-    }
-
-    ds4->leftStick.x = lx;
-    ds4->leftStick.y = ly;
-    ds4->rightStick.x = rx;
-    ds4->rightStick.y = ry;
-
-    // ========================================
-    // ANALOG TRIGGERS (Switch has digital only, fake analog)
-    // ========================================
-
-    // ZL/ZR are digital on Switch, output full press or nothing
-    ds4->analogButtons.l2 = (sw->buttons0 & SWITCH_BTN_ZL) ? 255 : 0;
-    ds4->analogButtons.r2 = (sw->buttons0 & SWITCH_BTN_ZR) ? 255 : 0;
-
-    // ========================================
-    // DIGITAL BUTTONS
-    // ========================================
-
-    uint32_t ds4_buttons = 0;
-
-    // Face buttons - Switch uses Nintendo layout (A=East, B=South)
-    // Map to PS4 positions: A->Circle, B->Cross, X->Triangle, Y->Square
-    if (config->swap_ab) {
-        if (sw->buttons0 & SWITCH_BTN_A) ds4_buttons |= DS4_BUTTON_CROSS;
-        if (sw->buttons0 & SWITCH_BTN_B) ds4_buttons |= DS4_BUTTON_CIRCLE;
-    } else {
-        if (sw->buttons0 & SWITCH_BTN_A) ds4_buttons |= DS4_BUTTON_CIRCLE;
-        if (sw->buttons0 & SWITCH_BTN_B) ds4_buttons |= DS4_BUTTON_CROSS;
-    }
-
-    if (config->swap_xy) {
-        if (sw->buttons0 & SWITCH_BTN_X) ds4_buttons |= DS4_BUTTON_SQUARE;
-        if (sw->buttons0 & SWITCH_BTN_Y) ds4_buttons |= DS4_BUTTON_TRIANGLE;
-    } else {
-        if (sw->buttons0 & SWITCH_BTN_X) ds4_buttons |= DS4_BUTTON_TRIANGLE;
-        if (sw->buttons0 & SWITCH_BTN_Y) ds4_buttons |= DS4_BUTTON_SQUARE;
-    }
-
-    // Shoulder buttons
-    if (sw->buttons0 & SWITCH_BTN_L) ds4_buttons |= DS4_BUTTON_L1;
-    if (sw->buttons0 & SWITCH_BTN_R) ds4_buttons |= DS4_BUTTON_R1;
-
-    // Digital trigger buttons
-    if (sw->buttons0 & SWITCH_BTN_ZL) ds4_buttons |= DS4_BUTTON_L2;
-    if (sw->buttons0 & SWITCH_BTN_ZR) ds4_buttons |= DS4_BUTTON_R2;
-
-    // Stick click buttons (byte 1)
-    if (sw->buttons1 & SWITCH_BTN_L3) ds4_buttons |= DS4_BUTTON_L3;
-    if (sw->buttons1 & SWITCH_BTN_R3) ds4_buttons |= DS4_BUTTON_R3;
-
-    // Menu buttons (byte 1)
-    if (sw->buttons1 & SWITCH_BTN_PLUS)  ds4_buttons |= DS4_BUTTON_OPTIONS;
-    if (sw->buttons1 & SWITCH_BTN_MINUS) ds4_buttons |= DS4_BUTTON_SHARE;
-
-    // Home button -> PS button
-    if (sw->buttons1 & SWITCH_BTN_HOME) ds4_buttons |= DS4_BUTTON_PS;
-
-    // ========================================
-    // D-PAD
-    // ========================================
-
-    ds4_buttons |= switch_hat_to_dpad(sw->hat);
-
-    // Store final button state
-    ds4->buttons = ds4_buttons;
-
-    // ========================================
-    // STATUS & METADATA
-    // ========================================
-
-    ds4->connected = 1;
-    ds4->timestamp = s_timestamp++;
-
-    // Motion data - set to neutral
-    ds4->quat.x = 0.0f;
-    ds4->quat.y = 0.0f;
-    ds4->quat.z = 0.0f;
-    ds4->quat.w = 1.0f;
-
-    ds4->vel.x = 0.0f;
-    ds4->vel.y = 0.0f;
-    ds4->vel.z = 0.0f;
-
-    ds4->acell.x = 0.0f;
-    ds4->acell.y = 0.0f;
-    ds4->acell.z = 1.0f;  // 1g downward
+void translator_convert_switch(const SwitchInputOnlyReport* sw, OrbisPadData* ds4, const TranslatorTables* tables) {
+    PadState pad;
 
-    // Touchpad - no touches
-    ds4->touch.fingers = 0;
+    translator_decode_switch(sw, &pad, tables);
+    pad.timestamp = s_timestamp++;
+    pad_state_emit(&pad, ds4);
 }
 
 /*
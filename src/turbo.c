@@ -0,0 +1,114 @@
+/*
+ * Turbo and Macro Engine Implementation
+ */
+
+#include "turbo.h"
+#include <string.h>
+
+void turbo_compile(TurboTable* table, const TurboRule* rules, int rule_count,
+                   const MacroRule* macros, int macro_count) {
+    memset(table, 0, sizeof(*table));
+
+    for (int i = 0; i < rule_count && table->rule_count < TURBO_MAX_RULES; i++) {
+        const TurboRule* rule = &rules[i];
+        if (rule->button == 0 || (table->turbo_mask & rule->button) ||
+            rule->rate_hz == 0 || rule->rate_hz > TURBO_MAX_HZ) {
+            continue;
+        }
+        table->button[table->rule_count] = rule->button;
+        table->half_period_us[table->rule_count] = 500000u / rule->rate_hz;
+        table->turbo_mask |= rule->button;
+        table->rule_count++;
+    }
+
+    for (int m = 0; m < macro_count && table->macro_count < TURBO_MAX_MACROS; m++) {
+        const MacroRule* macro = &macros[m];
+        int index = table->macro_count;
+        if (macro->trigger == 0 || (table->trigger_mask & macro->trigger) ||
+            macro->step_count <= 0 || macro->step_count > TURBO_MAX_STEPS) {
+            continue;
+        }
+        for (int s = 0; s < macro->step_count; s++) {
+            uint32_t frames = macro->steps[s].frames;
+            if (frames == 0) frames = 1;
+            if (frames > TURBO_MAX_STEP_FRAMES) frames = TURBO_MAX_STEP_FRAMES;
+            table->step_buttons[index][s] = macro->steps[s].buttons;
+            table->step_us[index][s] = frames * MACRO_FRAME_US;
+        }
+        table->macro_trigger[index] = macro->trigger;
+        table->step_count[index] = macro->step_count;
+        table->trigger_mask |= macro->trigger;
+        table->macro_count++;
+    }
+}
+
+void turbo_reset(TurboState* state) {
+    memset(state, 0, sizeof(*state));
+    state->macro = -1;
+}
+
+uint64_t turbo_apply(const TurboTable* table, TurboState* state, PadState* pad, uint64_t now) {
+    uint32_t input = pad->buttons;
+    uint32_t pressed = input & ~state->held;
+    uint32_t output = input & ~table->trigger_mask;
+    uint64_t next = UINT64_MAX;
+
+    state->held = input;
+
+    // Turbo: on for the first half period after the press, then alternating
+    for (int i = 0; i < table->rule_count; i++) {
+        uint32_t button = table->button[i];
+        if (!(input & button)) {
+            continue;
+        }
+        if (pressed & button) {
+            state->pressed_us[i] = now;
+        }
+
+        uint64_t half = table->half_period_us[i];
+        uint64_t phase = (now - state->pressed_us[i]) / half;
+        if (phase & 1) {
+            output &= ~button;
+        }
+
+        uint64_t edge = state->pressed_us[i] + (phase + 1) * half;
+        if (edge < next) {
+            next = edge;
+        }
+    }
+
+    // Macros: a trigger press starts one unless one is already playing
+    if (state->macro < 0 && (pressed & table->trigger_mask)) {
+        for (int m = 0; m < table->macro_count; m++) {
+            if (pressed & table->macro_trigger[m]) {
+                state->macro = m;
+                state->step = 0;
+                state->step_end_us = now + table->step_us[m][0];
+                break;
+            }
+        }
+    }
+
+    if (state->macro >= 0) {
+        int m = state->macro;
+
+        // Steps end on the macro's own timeline, not when we got here
+        while (now >= state->step_end_us) {
+            if (++state->step == table->step_count[m]) {
+                state->macro = -1;
+                break;
+            }
+            state->step_end_us += table->step_us[m][state->step];
+        }
+
+        if (state->macro >= 0) {
+            output |= table->step_buttons[m][state->step];
+            if (state->step_end_us < next) {
+                next = state->step_end_us;
+            }
+        }
+    }
+
+    pad->buttons = output;
+    return next;
+}
@@ -0,0 +1,232 @@
+/*
+ * Asynchronous USB Interrupt Transfers Implementation
+ *
+ * Every transfer of an endpoint is allocated once, filled once and then
+ * only resubmitted, so the steady state makes no allocation and no
+ * syscall besides the submit itself. The handler decides per completion
+ * whether the transfer goes straight back to the device or is parked.
+ */
+
+#include "usb_async.h"
+#include <stddef.h>
+#include <string.h>
+
+#include <orbis/libkernel.h>
+
+// Index of a transfer within its endpoint, from its fixed buffer
+static int transfer_index(const UsbAsyncEndpoint* endpoint, const struct libusb_transfer* transfer) {
+    return (int)((transfer->buffer - endpoint->buffers[0]) / USB_ASYNC_BUFFER_SIZE);
+}
+
+static UsbAsyncStatus map_status(enum libusb_transfer_status status) {
+    switch (status) {
+        case LIBUSB_TRANSFER_COMPLETED: return USB_ASYNC_COMPLETED;
+        case LIBUSB_TRANSFER_TIMED_OUT: return USB_ASYNC_TIMED_OUT;
+        case LIBUSB_TRANSFER_CANCELLED: return USB_ASYNC_CANCELLED;
+        case LIBUSB_TRANSFER_NO_DEVICE: return USB_ASYNC_GONE;
+        default:                        return USB_ASYNC_ERROR;
+    }
+}
+
+static int submit(UsbAsyncEndpoint* endpoint, int index) {
+    if (sceUsbdSubmitTransfer(endpoint->transfers[index]) < 0) {
+        return -1;
+    }
+    endpoint->pending[index] = 1;
+    endpoint->in_flight++;
+    return 0;
+}
+
+/*
+ * Completion callback (inside sceUsbdHandleEvents*)
+ */
+static void transfer_done(struct libusb_transfer* transfer) {
+    UsbAsyncEndpoint* endpoint = (UsbAsyncEndpoint*)transfer->user_data;
+    int index = transfer_index(endpoint, transfer);
+
+    // Leaked by usb_async_stop: the stack is done with it at last
+    if (endpoint->transfers[index] != transfer) {
+        sceUsbdFreeTransfer(transfer);
+        endpoint->leaked--;
+        return;
+    }
+
+    endpoint->pending[index] = 0;
+    endpoint->in_flight--;
+
+    if (endpoint->stopping) {
+        return;
+    }
+
+    UsbAsyncStatus status = map_status(transfer->status);
+    if (!endpoint->handler(endpoint->context, transfer->buffer, transfer->actual_length, status)) {
+        return;
+    }
+
+    // A refused resubmit means the device is going away; report it once
+    if (submit(endpoint, index) < 0) {
+        endpoint->handler(endpoint->context, NULL, 0, USB_ASYNC_GONE);
+    }
+}
+
+int usb_async_start(UsbAsyncEndpoint* endpoint, libusb_device_handle* handle, uint8_t address,
+                    UsbAsyncHandler handler, void* context) {
+    if (endpoint->leaked) {
+        return -3;
+    }
+
+    endpoint->in_flight = 0;
+    endpoint->stopping = 0;
+    endpoint->handler = handler;
+    endpoint->context = context;
+
+    for (int i = 0; i < USB_ASYNC_TRANSFERS; i++) {
+        endpoint->pending[i] = 0;
+        endpoint->transfers[i] = sceUsbdAllocTransfer(0);
+        if (endpoint->transfers[i] == NULL) {
+            while (i-- > 0) {
+                sceUsbdFreeTransfer(endpoint->transfers[i]);
+                endpoint->transfers[i] = NULL;
+            }
+            return -1;
+        }
+
+        // No timeout: the transfer waits at the host controller for the next report
+        sceUsbdFillInterruptTransfer(endpoint->transfers[i], handle, address,
+                                     endpoint->buffers[i], USB_ASYNC_BUFFER_SIZE,
+                                     transfer_done, endpoint, 0);
+    }
+
+    // The first submit tells whether the async path works at all
+    if (submit(endpoint, 0) < 0) {
+        for (int i = 0; i < USB_ASYNC_TRANSFERS; i++) {
+            sceUsbdFreeTransfer(endpoint->transfers[i]);
+            endpoint->transfers[i] = NULL;
+        }
+        return -2;
+    }
+
+    // Any that fail now stay parked for usb_async_resume
+    usb_async_resume(endpoint, USB_ASYNC_TRANSFERS);
+    return 0;
+}
+
+int usb_async_resume(UsbAsyncEndpoint* endpoint, int max) {
+    int submitted = 0;
+
+    for (int i = 0; i < USB_ASYNC_TRANSFERS && submitted < max; i++) {
+        if (endpoint->pending[i] || endpoint->transfers[i] == NULL) {
+            continue;
+        }
+        if (submit(endpoint, i) < 0) {
+            return -1;
+        }
+        submitted++;
+    }
+    return submitted;
+}
+
+void usb_async_stop(UsbAsyncEndpoint* endpoint) {
+    endpoint->stopping = 1;
+
+    for (int i = 0; i < USB_ASYNC_TRANSFERS; i++) {
+        if (endpoint->pending[i]) {
+            sceUsbdCancelTransfer(endpoint->transfers[i]);
+        }
+    }
+
+    // Cancellation completes through the event loop like any transfer;
+    // each pass ends at the first completion of any endpoint
+    uint64_t deadline = sceKernelGetProcessTime() + USB_ASYNC_STOP_WAIT_MS * 1000ull;
+    while (endpoint->in_flight > 0 && sceKernelGetProcessTime() < deadline) {
+        usb_async_handle_events(1000);
+    }
+
+    for (int i = 0; i < USB_ASYNC_TRANSFERS; i++) {
+        // A transfer the stack still owns must not be freed; leak it instead
+        if (endpoint->pending[i]) {
+            endpoint->leaked++;
+        } else if (endpoint->transfers[i] != NULL) {
+            sceUsbdFreeTransfer(endpoint->transfers[i]);
+        }
+        endpoint->transfers[i] = NULL;
+        endpoint->pending[i] = 0;
+    }
+    endpoint->in_flight = 0;
+}
+
+// OUT completion: the result is not needed, only that the wire is free
+static void output_done(struct libusb_transfer* transfer) {
+    UsbAsyncOutput* output = (UsbAsyncOutput*)transfer->user_data;
+
+    // Leaked by usb_async_output_stop: the stack is done with it at last
+    if (output->transfer != transfer) {
+        sceUsbdFreeTransfer(transfer);
+        output->leaked = 0;
+        return;
+    }
+    output->pending = 0;
+}
+
+int usb_async_output_start(UsbAsyncOutput* output, libusb_device_handle* handle, uint8_t address) {
+    if (output->leaked) {
+        return -2;
+    }
+
+    output->pending = 0;
+    output->transfer = sceUsbdAllocTransfer(0);
+    if (output->transfer == NULL) {
+        return -1;
+    }
+
+    sceUsbdFillInterruptTransfer(output->transfer, handle, address, output->buffer, 0,
+                                 output_done, output, USB_TRANSFER_TIMEOUT_MS);
+    return 0;
+}
+
+int usb_async_output_send(UsbAsyncOutput* output, const void* data, int32_t length) {
+    if (output->transfer == NULL || length > USB_ASYNC_BUFFER_SIZE) {
+        return -1;
+    }
+    if (output->pending) {
+        return 1;
+    }
+
+    memcpy(output->buffer, data, (size_t)length);
+    output->transfer->length = length;
+    if (sceUsbdSubmitTransfer(output->transfer) < 0) {
+        return -2;
+    }
+    output->pending = 1;
+    return 0;
+}
+
+void usb_async_output_stop(UsbAsyncOutput* output) {
+    if (output->transfer == NULL) {
+        return;
+    }
+
+    if (output->pending) {
+        sceUsbdCancelTransfer(output->transfer);
+        uint64_t deadline = sceKernelGetProcessTime() + USB_ASYNC_STOP_WAIT_MS * 1000ull;
+        while (output->pending && sceKernelGetProcessTime() < deadline) {
+            usb_async_handle_events(1000);
+        }
+    }
+
+    // Still owned by the stack after the wait: leak rather than free
+    if (output->pending) {
+        output->leaked = 1;
+    } else {
+        sceUsbdFreeTransfer(output->transfer);
+    }
+    output->transfer = NULL;
+    output->pending = 0;
+}
+
+int usb_async_handle_events(uint32_t timeout_us) {
+    struct timeval tv;
+    tv.tv_sec = timeout_us / 1000000u;
+    tv.tv_usec = timeout_us % 1000000u;
+    return sceUsbdHandleEventsTimeout(&tv) < 0 ? -1 : 0;
+}
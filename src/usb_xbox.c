@@ -1,14 +1,31 @@
 /*
- * Xbox 360 USB Controller Reader Implementation
+ * USB Controller Polling Engine Implementation
  *
  * Uses PS4's sceUsbd library (libusb wrapper) to communicate
- * with Xbox 360 controllers connected via USB.
+ * with Xbox 360, Xbox One and PDP Switch controllers connected via USB.
+ * A single background thread owns every transfer; the scePad hooks only
+ * copy the state it publishes. Input normally arrives through queued
+ * asynchronous transfers completed by that thread's event loop; a
+ * controller whose async submit fails is polled synchronously instead.
  */
 
 #include "usb_xbox.h"
+#include "pad_slot.h"
+#include "pad_history.h"
+#include "hotplug.h"
+#include "poll_sched.h"
+#include "usb_async.h"
+#include "drivers.h"
+#include "capture.h"
+#include "latency.h"
+#include "profile.h"
+#include "turbo.h"
+#include "notify.h"
 #include "config.h"
 #include <string.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 // OpenOrbis headers
 #include <orbis/Usbd.h>
@@ -18,62 +35,131 @@
 #include <pthread.h>
 #include <unistd.h>
 
-// Debug notification helper
-static void usb_notify(const char* message) {
-    OrbisNotificationRequest req;
-    memset(&req, 0, sizeof(req));
-    req.type = NotificationRequest;
-    req.targetId = -1;
-    strncpy(req.message, message, sizeof(req.message) - 1);
-    sceKernelSendNotificationRequest(0, &req, sizeof(req), 0);
-}
-
 /*
  * Internal controller state
+ * Grouped by writer, each group starting on its own cache line, so a
+ * game thread reading or rumbling one pad never invalidates a line the
+ * poll thread writes per report (and the reverse). The struct is line
+ * aligned, so neighbours in g_controllers never share a line either.
  */
 typedef struct {
-    XboxControllerSlot  slot;
+    // Written by the hooks (any game thread)
+    volatile uint32_t   rumble_request __attribute__((aligned(64)));   // Newest motors asked for (left << 8 | right)
+    PollSchedule        schedule;       // Game read tracking (own line), then poll thread fields
+
+    // Written by the poll thread, read by the hooks
+    const ControllerDriver* volatile driver __attribute__((aligned(64)));  // NULL while the slot is closed
+    XboxControllerSlot  slot;           // State on one line, per-report fields on the next
+    PadSlot             published __attribute__((aligned(64)));   // Latest translated report (lock-free)
+    PadHistory          history;        // Recent translated samples for scePadRead
+
+    // Poll thread only
+    uint16_t            location __attribute__((aligned(64)));    // HOTPLUG_LOCATION of the opened device
     libusb_device_handle* handle;
     int                 interface_claimed;
-    pthread_mutex_t     mutex;
+    uint8_t             endpoint_in;
+    uint8_t             endpoint_out;
+    int                 input_active;   // First valid report seen
+    int32_t             last_length;    // Length of slot.last_report
+    PadState            last_pad;       // Translation of slot.last_report
+    OrbisPadData        last_state;     // Last emitted state (turbo and macros applied)
+    uint32_t            last_generation;    // Profile last_pad was translated with
+    TurboState          turbo;          // Turbo phases, macro playing
+    uint64_t            turbo_wake_us;  // Next turbo/macro edge (UINT64_MAX = none)
+    uint64_t            unchanged;      // Reports identical to the previous one
+    UsbAsyncEndpoint    input;          // Queued IN transfers
+    int                 async;          // Input uses queued transfers
+    int                 lost;           // Transfer reported the device gone
+    uint32_t            rumble_sent;    // Motors last sent to the device
+    uint64_t            rumble_sent_us; // When they were sent
+    UsbAsyncOutput      output;         // Rumble and protocol OUT transfer
+    int                 async_output;   // Output uses the OUT transfer
+    DriverState         protocol;       // Driver protocol state
 } InternalController;
 
+_Static_assert(sizeof(InternalController) % 64 == 0, "Controllers must not share cache lines");
+
 // Global state
 static InternalController g_controllers[MAX_XBOX_CONTROLLERS];
 static pthread_t          g_poll_thread;
 static volatile int       g_polling_active = 0;
 static volatile int       g_initialized = 0;
 
+static int input_complete(void* context, const uint8_t* data, int32_t length, UsbAsyncStatus status);
+
+// ============================================
+// Controller detection
+// ============================================
+
+// Hot-plug filter: only controllers with a driver are reported
+static int is_supported_controller(uint16_t vid, uint16_t pid) {
+    return driver_lookup(vid, pid) != NULL;
+}
+
+// Endpoint descriptor fields
+#define USB_ENDPOINT_DIR_IN         0x80
+#define USB_TRANSFER_TYPE_MASK      0x03
+#define USB_TRANSFER_TYPE_INTERRUPT 0x03
+
 /*
- * Check if device is an Xbox 360 controller
+ * Find the interrupt endpoints of interface 0 and the IN polling interval
+ * Endpoints keep their per-type defaults if the descriptor is unreadable.
+ * @return IN endpoint interval in microseconds
  */
-static int is_xbox360_controller(uint16_t vid, uint16_t pid) {
-    if (vid != XBOX360_VID) {
-        return 0;
+static uint32_t find_endpoints(libusb_device* dev, InternalController* ctrl) {
+    struct libusb_config_descriptor* config = NULL;
+    uint8_t b_interval = 0;
+
+    if (sceUsbdGetActiveConfigDescriptor(dev, &config) < 0 || config == NULL) {
+        return poll_sched_interval_us(b_interval);
     }
 
-    switch (pid) {
-        case XBOX360_PID_WIRED:
-        case XBOX360_PID_WIRELESS:
-            return 1;
-        default:
-            return 0;
+    if (config->bNumInterfaces > 0 && config->interface[0].num_altsetting > 0) {
+        const struct libusb_interface_descriptor* altsetting = &config->interface[0].altsetting[0];
+        int found_in = 0;
+        int found_out = 0;
+
+        for (int i = 0; i < altsetting->bNumEndpoints; i++) {
+            const struct libusb_endpoint_descriptor* endpoint = &altsetting->endpoint[i];
+            if ((endpoint->bmAttributes & USB_TRANSFER_TYPE_MASK) != USB_TRANSFER_TYPE_INTERRUPT) {
+                continue;
+            }
+
+            if ((endpoint->bEndpointAddress & USB_ENDPOINT_DIR_IN) && !found_in) {
+                ctrl->endpoint_in = endpoint->bEndpointAddress;
+                b_interval = endpoint->bInterval;
+                found_in = 1;
+            } else if (!(endpoint->bEndpointAddress & USB_ENDPOINT_DIR_IN) && !found_out) {
+                ctrl->endpoint_out = endpoint->bEndpointAddress;
+                found_out = 1;
+            }
+        }
     }
+
+    sceUsbdFreeConfigDescriptor(config);
+    return poll_sched_interval_us(b_interval);
 }
 
 /*
  * Open and configure a controller
+ * Xbox One pads get their init command on every open, so a reconnect
+ * (which always arrives as a new device) is re-initialized.
  */
-static int open_controller(libusb_device* dev, int slot_index) {
+static int open_controller(libusb_device* dev, int slot_index, const ControllerDriver* driver,
+                           uint16_t location) {
     InternalController* ctrl = &g_controllers[slot_index];
     int ret;
 
     // Open device
     ret = sceUsbdOpen(dev, &ctrl->handle);
     if (ret < 0 || ctrl->handle == NULL) {
+        ctrl->handle = NULL;
         return -1;
     }
 
+    // Try to detach kernel driver if attached
+    sceUsbdDetachKernelDriver(ctrl->handle, 0);
+
     // Claim interface 0 (main controller interface)
     ret = sceUsbdClaimInterface(ctrl->handle, 0);
     if (ret < 0) {
@@ -82,19 +168,80 @@ static int open_controller(libusb_device* dev, int slot_index) {
         return -2;
     }
 
+    // Driver defaults if the descriptor is unreadable
+    ctrl->endpoint_in = driver->endpoint_in;
+    ctrl->endpoint_out = driver->endpoint_out;
+    uint32_t interval_us = find_endpoints(dev, ctrl);
+
+    memset(&ctrl->protocol, 0, sizeof(ctrl->protocol));
+    if (driver->start) {
+        // Pads with an init sequence (Xbox One power on) send nothing before it
+        GipPacket init;
+        int32_t transferred = 0;
+
+        init.length = 0;
+        driver->start(&ctrl->protocol, sceKernelGetProcessTime(), &init);
+        sceUsbdSetInterfaceAltSetting(ctrl->handle, 0, 0);
+        if (init.length) {
+            sceUsbdInterruptTransfer(ctrl->handle, ctrl->endpoint_out, init.data, init.length,
+                                     &transferred, 100);  // 100ms timeout
+        }
+    }
+
+    // A profile poll rate replaces the endpoint's bInterval
+    const Profile* profile = profile_active();
+    if (profile && profile->poll_interval_us) {
+        interval_us = profile->poll_interval_us;
+    }
+    poll_sched_init(&ctrl->schedule, interval_us, sceKernelGetProcessTime());
+
+    ctrl->location = location;
     ctrl->interface_claimed = 1;
+    ctrl->input_active = 0;
+    ctrl->last_length = 0;
+    ctrl->unchanged = 0;
+    turbo_reset(&ctrl->turbo);
+    ctrl->turbo_wake_us = UINT64_MAX;
+    ctrl->lost = 0;
+    ctrl->slot.type = driver->type;
+    ctrl->driver = driver;
     ctrl->slot.state = XBOX_STATE_CONNECTED;
 
+    // Queue input transfers; without the async API the poll loop reads synchronously
+    ctrl->async = usb_async_start(&ctrl->input, ctrl->handle, ctrl->endpoint_in,
+                                  input_complete, (void*)(intptr_t)slot_index) == 0;
+    if (!ctrl->async) {
+        notify_debug("USB: async transfers unavailable, polling");
+    }
+
+    // Motors start off; the next game request is sent as a change
+    ctrl->rumble_request = 0;
+    ctrl->rumble_sent = 0;
+    ctrl->rumble_sent_us = 0;
+    ctrl->async_output = driver->rumble != NULL &&
+                         usb_async_output_start(&ctrl->output, ctrl->handle, ctrl->endpoint_out) == 0;
+
     return 0;
 }
 
 /*
  * Close a controller
+ * Only the poll thread (or init/cleanup while it is stopped) opens and
+ * closes devices, so slot bookkeeping needs no lock.
  */
 static void close_controller(int slot_index) {
     InternalController* ctrl = &g_controllers[slot_index];
+    PadSnapshot empty;
 
-    pthread_mutex_lock(&ctrl->mutex);
+    // Transfers must be back from the stack before the handle goes
+    if (ctrl->async) {
+        usb_async_stop(&ctrl->input);
+        ctrl->async = 0;
+    }
+    if (ctrl->async_output) {
+        usb_async_output_stop(&ctrl->output);
+        ctrl->async_output = 0;
+    }
 
     if (ctrl->interface_claimed) {
         sceUsbdReleaseInterface(ctrl->handle, 0);
@@ -106,78 +253,200 @@ static void close_controller(int slot_index) {
         ctrl->handle = NULL;
     }
 
+    ctrl->location = 0;
     ctrl->slot.state = XBOX_STATE_DISCONNECTED;
-    memset(&ctrl->slot.last_report, 0, sizeof(Xbox360Report));
-
-    pthread_mutex_unlock(&ctrl->mutex);
+    ctrl->slot.type = CONTROLLER_NONE;
+    ctrl->driver = NULL;
+    memset(&ctrl->slot.last_report, 0, sizeof(XboxRawReport));
+
+    // Withdraw the published state and the samples nobody read
+    memset(&empty, 0, sizeof(empty));
+    pad_slot_publish(&ctrl->published, &empty);
+    pad_history_reset(&ctrl->history);
 }
 
 /*
- * Scan for Xbox controllers
+ * Apply one hot-plug event (poll thread only)
  */
-static void scan_controllers(void) {
-    libusb_device** device_list = NULL;
-    int32_t device_count;
-    int slot = 0;
-
-    // Get list of USB devices
-    device_count = sceUsbdGetDeviceList(&device_list);
-    if (device_count < 0 || device_list == NULL) {
+static void handle_hotplug_event(const HotplugEvent* event) {
+    int slot = -1;
+
+    if (event->type == HOTPLUG_LEFT) {
+        for (int i = 0; i < MAX_XBOX_CONTROLLERS; i++) {
+            if (g_controllers[i].slot.state == XBOX_STATE_CONNECTED &&
+                g_controllers[i].location == event->location) {
+                close_controller(i);
+                break;
+            }
+        }
         return;
     }
 
-    // Find first available slot
-    for (slot = 0; slot < MAX_XBOX_CONTROLLERS; slot++) {
-        if (g_controllers[slot].slot.state == XBOX_STATE_DISCONNECTED) {
-            break;
+    for (int i = 0; i < MAX_XBOX_CONTROLLERS; i++) {
+        if (g_controllers[i].slot.state == XBOX_STATE_CONNECTED) {
+            if (g_controllers[i].location == event->location) {
+                slot = -1;  // Already open (repeat report after a rescan)
+                break;
+            }
+        } else if (slot < 0) {
+            slot = i;
         }
     }
 
-    // Scan devices
-    for (int32_t i = 0; i < device_count && slot < MAX_XBOX_CONTROLLERS; i++) {
-        struct libusb_device_descriptor desc;
+    const ControllerDriver* driver = driver_lookup(event->vendor_id, event->product_id);
+    if (slot >= 0 && driver != NULL &&
+        open_controller(event->device, slot, driver, event->location) == 0) {
+        char message[64];
 
-        if (sceUsbdGetDeviceDescriptor(device_list[i], &desc) != 0) {
-            continue;
-        }
+        g_controllers[slot].slot.vendor_id = event->vendor_id;
+        g_controllers[slot].slot.product_id = event->product_id;
 
-        if (is_xbox360_controller(desc.idVendor, desc.idProduct)) {
-            // Check if this device is already opened
-            int already_opened = 0;
-            for (int j = 0; j < MAX_XBOX_CONTROLLERS; j++) {
-                if (g_controllers[j].slot.state == XBOX_STATE_CONNECTED &&
-                    g_controllers[j].slot.vendor_id == desc.idVendor &&
-                    g_controllers[j].slot.product_id == desc.idProduct) {
-                    already_opened = 1;
-                    break;
-                }
-            }
+        snprintf(message, sizeof(message), "%s connected!", driver->name);
+        notify_post(message);
+    }
 
-            if (!already_opened) {
-                if (open_controller(device_list[i], slot) == 0) {
-                    g_controllers[slot].slot.vendor_id = desc.idVendor;
-                    g_controllers[slot].slot.product_id = desc.idProduct;
-
-                    // Find next available slot
-                    for (slot++; slot < MAX_XBOX_CONTROLLERS; slot++) {
-                        if (g_controllers[slot].slot.state == XBOX_STATE_DISCONNECTED) {
-                            break;
-                        }
-                    }
-                }
+    // The open handle holds its own reference
+    sceUsbdUnrefDevice(event->device);
+}
+
+// ============================================
+// Input polling
+// ============================================
+
+/*
+ * Check whether a report carries the same input as the last one
+ * Bytes before the driver's compare_offset (Xbox One sequence counter)
+ * change on every report and are ignored.
+ */
+static int report_unchanged(const InternalController* ctrl, const XboxRawReport* report,
+                            int32_t length, uint32_t generation) {
+    int32_t offset = ctrl->driver->compare_offset;
+
+    return ctrl->input_active && generation == ctrl->last_generation &&
+           length == ctrl->last_length && length > offset &&
+           memcmp(report->raw + offset, ctrl->slot.last_report.raw + offset,
+                  (size_t)(length - offset)) == 0;
+}
+
+/*
+ * Emit last_pad, with turbo and macros applied, and publish it
+ * The emitted state is reused while neither the translation nor the
+ * resulting buttons change. Also plans the next turbo/macro edge.
+ * @param translated    last_pad was just (re)translated
+ */
+static void publish_pad(int slot_index, PadSnapshot* snapshot, const Profile* profile, int translated) {
+    InternalController* ctrl = &g_controllers[slot_index];
+    uint64_t now = sceKernelGetProcessTime();
+    PadState pad = ctrl->last_pad;
+
+    ctrl->turbo_wake_us = UINT64_MAX;
+    if (profile && turbo_enabled(&profile->turbo)) {
+        ctrl->turbo_wake_us = turbo_apply(&profile->turbo, &ctrl->turbo, &pad, now);
+    }
+
+    if (translated || pad.buttons != ctrl->last_state.buttons) {
+        pad_state_emit(&pad, &snapshot->state);
+        ctrl->last_state = snapshot->state;
+    } else {
+        snapshot->state = ctrl->last_state;
+    }
+    latency_stamp(&snapshot->latency, LATENCY_STAGE_TRANSLATE);
+
+    // Sample time in microseconds, like the real pad
+    snapshot->update_time = now;
+    snapshot->state.timestamp = now;
+    ctrl->slot.last_update = now;
+
+    latency_stamp(&snapshot->latency, LATENCY_STAGE_PUBLISH);
+    pad_slot_publish(&ctrl->published, snapshot);
+    pad_history_push(&ctrl->history, &snapshot->state, &snapshot->latency);
+    latency_record_publish(slot_index, &snapshot->latency);
+}
+
+/*
+ * Publish the last report again at a turbo or macro edge
+ * Pads only report changes, so a held button would otherwise not pulse.
+ */
+static void publish_turbo_edge(int slot_index) {
+    InternalController* ctrl = &g_controllers[slot_index];
+    PadSnapshot snapshot;
+
+    // No transfer behind it: no USB stamp keeps it out of the histograms
+    memset(&snapshot.latency, 0, sizeof(snapshot.latency));
+    snapshot.report = ctrl->slot.last_report;
+
+    // A reload since the last report: translate it again with the new tables
+    const Profile* profile = profile_active();
+    uint32_t generation = profile ? profile->generation : 0;
+    int translated = generation != ctrl->last_generation;
+    if (translated) {
+        ctrl->driver->translate(&ctrl->protocol, profile ? &profile->tables : NULL, &snapshot.report,
+                                &ctrl->last_pad);
+        turbo_reset(&ctrl->turbo);
+        ctrl->last_generation = generation;
+    }
+    publish_pad(slot_index, &snapshot, profile, translated);
+}
+
+/*
+ * Validate, translate and publish one received report
+ * A report identical to the previous one is published again (new
+ * timestamp, new history sample) without being re-translated, unless
+ * the profile was reloaded since.
+ * @param snapshot  Report and USB stage stamp filled in by the caller
+ */
+static int publish_report(int slot_index, PadSnapshot* snapshot, int32_t length) {
+    InternalController* ctrl = &g_controllers[slot_index];
+    const ControllerDriver* driver = ctrl->driver;
+    const Profile* profile = profile_active();
+    uint32_t generation = profile ? profile->generation : 0;
+    int unchanged = 0;
+
+    switch (driver->decode(&ctrl->protocol, snapshot->report.raw, length, sceKernelGetProcessTime())) {
+        case DRIVER_DECODE_REPORT:
+            unchanged = report_unchanged(ctrl, &snapshot->report, length, generation);
+            break;
+        case DRIVER_DECODE_REPEAT:
+            // Protocol state changed (Guide): always re-translate
+            if (!ctrl->input_active) {
+                return -1;
             }
+            snapshot->report = ctrl->slot.last_report;
+            length = ctrl->last_length;
+            break;
+        default:
+            return -1;
+    }
+    latency_stamp(&snapshot->latency, LATENCY_STAGE_DECODE);
+
+    // Translate here so the hooks only copy a finished snapshot
+    if (unchanged) {
+        ctrl->unchanged++;
+    } else {
+        driver->translate(&ctrl->protocol, profile ? &profile->tables : NULL, &snapshot->report,
+                          &ctrl->last_pad);
+        if (generation != ctrl->last_generation) {
+            turbo_reset(&ctrl->turbo);
         }
+        ctrl->last_generation = generation;
+        ctrl->slot.last_report = snapshot->report;
+        ctrl->last_length = length;
     }
+    publish_pad(slot_index, snapshot, profile, !unchanged);
 
-    sceUsbdFreeDeviceList(device_list);
+    if (!ctrl->input_active) {
+        ctrl->input_active = 1;
+        notify_post("Controller input active!");
+    }
+    return 0;
 }
 
 /*
- * Read input from a single controller
+ * Read input from a single controller (synchronous fallback)
  */
 static int read_controller_input(int slot_index) {
     InternalController* ctrl = &g_controllers[slot_index];
-    Xbox360Report report;
+    PadSnapshot snapshot;
     int32_t transferred = 0;
     int32_t ret;
 
@@ -188,26 +457,23 @@ static int read_controller_input(int slot_index) {
     // Read from interrupt endpoint
     ret = sceUsbdInterruptTransfer(
         ctrl->handle,
-        XBOX360_ENDPOINT_IN,
-        (unsigned char*)&report,
-        sizeof(Xbox360Report),
+        ctrl->endpoint_in,
+        snapshot.report.raw,
+        sizeof(snapshot.report.raw),
         &transferred,
-        USB_TRANSFER_TIMEOUT_MS
+        USB_POLL_TIMEOUT_MS
     );
 
-    if (ret == 0 && transferred == sizeof(Xbox360Report)) {
-        // Validate report
-        if (xbox360_report_valid(&report)) {
-            pthread_mutex_lock(&ctrl->mutex);
-            ctrl->slot.last_report = report;
-            ctrl->slot.last_update = sceKernelGetProcessTime();
-            pthread_mutex_unlock(&ctrl->mutex);
-            return 0;
-        }
+    if (ret == 0) {
+        latency_stamp(&snapshot.latency, LATENCY_STAGE_USB);
+        capture_report(slot_index, ctrl->slot.type, snapshot.report.raw, transferred);
+        return publish_report(slot_index, &snapshot, transferred);
     } else if (ret < 0) {
         // Check if controller disconnected
         if (sceUsbdCheckConnected(ctrl->handle) != 0) {
             close_controller(slot_index);
+            // Let hot-plug report it again if it is still physically present
+            hotplug_request_scan();
             return -2;
         }
     }
@@ -215,31 +481,227 @@ static int read_controller_input(int slot_index) {
     return -1;
 }
 
+/*
+ * Completion of a queued IN transfer (poll thread, inside the event loop)
+ * While the game reads, every transfer goes straight back to the device
+ * so one is always waiting for the next report. An idle controller parks
+ * them and the poll loop hands out one per idle period instead.
+ * @return 1 to resubmit, 0 to park
+ */
+static int input_complete(void* context, const uint8_t* data, int32_t length, UsbAsyncStatus status) {
+    int slot_index = (int)(intptr_t)context;
+    InternalController* ctrl = &g_controllers[slot_index];
+    PadSnapshot snapshot;
+
+    switch (status) {
+        case USB_ASYNC_COMPLETED:
+            latency_stamp(&snapshot.latency, LATENCY_STAGE_USB);
+            if (length > (int32_t)sizeof(snapshot.report.raw)) {
+                length = (int32_t)sizeof(snapshot.report.raw);
+            }
+            memcpy(snapshot.report.raw, data, (size_t)length);
+            capture_report(slot_index, ctrl->slot.type, data, length);
+            publish_report(slot_index, &snapshot, length);
+            poll_sched_update(&ctrl->schedule, sceKernelGetProcessTime());
+            return !ctrl->schedule.idle;
+
+        case USB_ASYNC_TIMED_OUT:
+            return 1;
+
+        case USB_ASYNC_CANCELLED:
+            return 0;
+
+        case USB_ASYNC_ERROR:
+            // Stall or similar: back off unless the device is gone
+            if (sceUsbdCheckConnected(ctrl->handle) == 0) {
+                ctrl->schedule.next_poll_us = sceKernelGetProcessTime() + POLL_IDLE_INTERVAL_US;
+                return 0;
+            }
+            ctrl->lost = 1;
+            return 0;
+
+        case USB_ASYNC_GONE:
+        default:
+            // Closing here would free transfers the event loop still holds
+            ctrl->lost = 1;
+            return 0;
+    }
+}
+
+/*
+ * Service one controller on async transfers: resubmit parked transfers
+ * when the schedule allows (all of them while the game reads, one per
+ * idle period otherwise)
+ * @return Time the controller next needs the poll loop
+ */
+static uint64_t service_async(InternalController* ctrl, uint64_t now) {
+    int parked = usb_async_parked(&ctrl->input);
+
+    if (parked == 0) {
+        return UINT64_MAX;
+    }
+    if (now < ctrl->schedule.next_poll_us) {
+        return ctrl->schedule.next_poll_us;
+    }
+
+    if (!ctrl->schedule.idle) {
+        usb_async_resume(&ctrl->input, parked);
+    } else if (parked == USB_ASYNC_TRANSFERS) {
+        usb_async_resume(&ctrl->input, 1);
+    }
+    return UINT64_MAX;
+}
+
+// ============================================
+// Output (rumble and protocol packets)
+// ============================================
+
+// Send on the OUT endpoint; the async transfer must be idle
+static void send_output(InternalController* ctrl, const uint8_t* packet, int length) {
+    if (ctrl->async_output) {
+        usb_async_output_send(&ctrl->output, packet, length);
+    } else {
+        int32_t transferred = 0;
+        sceUsbdInterruptTransfer(ctrl->handle, ctrl->endpoint_out, (unsigned char*)packet, length,
+                                 &transferred, USB_TRANSFER_TIMEOUT_MS);
+    }
+}
+
+/*
+ * Send pending output: protocol packets (ACKs, power on) first, then the
+ * newest rumble request if it changed
+ * Rumble requests arriving faster than RUMBLE_MIN_INTERVAL_US, or while
+ * the previous packet is still on the wire, collapse into the newest one.
+ * @return Time the controller next needs the poll loop for output
+ */
+static uint64_t service_output(InternalController* ctrl, uint64_t now) {
+    uint32_t request = __atomic_load_n(&ctrl->rumble_request, __ATOMIC_RELAXED);
+    int rumble = request != ctrl->rumble_sent;
+    uint8_t packet[USB_ASYNC_BUFFER_SIZE];
+
+    DriverState* protocol = &ctrl->protocol;
+
+    if (ctrl->driver->keepalive) {
+        ctrl->driver->keepalive(protocol, now);
+    }
+
+    if (protocol->control_count == 0 && !rumble) {
+        return UINT64_MAX;
+    }
+    if (ctrl->async_output && ctrl->output.pending) {
+        // Previous packet still on the wire
+        return now + RUMBLE_MIN_INTERVAL_US;
+    }
+
+    if (protocol->control_count) {
+        send_output(ctrl, protocol->control[0].data, protocol->control[0].length);
+        driver_pop_control(protocol);
+        return (rumble || protocol->control_count) ? now + RUMBLE_MIN_INTERVAL_US : UINT64_MAX;
+    }
+
+    uint64_t allowed = ctrl->rumble_sent_us + RUMBLE_MIN_INTERVAL_US;
+    if (now < allowed) {
+        return allowed;
+    }
+
+    // A failed send is not retried: the next change sends again
+    int length = ctrl->driver->rumble
+        ? ctrl->driver->rumble(&ctrl->protocol, (uint8_t)(request >> 8), (uint8_t)request, packet)
+        : 0;
+    if (length > 0) {
+        send_output(ctrl, packet, length);
+        ctrl->rumble_sent_us = now;
+    }
+    ctrl->rumble_sent = request;
+    return UINT64_MAX;
+}
+
 /*
  * Polling thread function
+ * Async controllers are serviced by the completion handlers inside the
+ * event loop; the loop itself only resubmits parked transfers. Fallback
+ * controllers are polled when their schedule says so. The thread waits
+ * for the earliest of both, and never longer than the idle poll period
+ * so hot-plug events are still picked up promptly.
  */
 static void* poll_thread_func(void* arg) {
     (void)arg;
-    int scan_counter = 0;
+    HotplugEvent event;
 
     while (g_polling_active) {
-        // Periodically scan for new controllers
-        if (++scan_counter >= 250) {  // Every ~1 second at 4ms interval
-            scan_controllers();
-            scan_counter = 0;
+        // Profile pointers from the last pass are dropped (hot reload)
+        profile_quiescent();
+
+        // Apply arrivals/removals found by the hot-plug thread.
+        // Empty queue costs two atomic loads - no device list walk here.
+        while (hotplug_poll(&event)) {
+            handle_hotplug_event(&event);
         }
 
-        // Read from all connected controllers
+        uint64_t now = sceKernelGetProcessTime();
+        uint64_t wake = now + POLL_IDLE_INTERVAL_US;
+        int async = 0;
+
         for (int i = 0; i < MAX_XBOX_CONTROLLERS; i++) {
-            if (g_controllers[i].slot.state == XBOX_STATE_CONNECTED) {
+            InternalController* ctrl = &g_controllers[i];
+            if (ctrl->slot.state != XBOX_STATE_CONNECTED) {
+                continue;
+            }
+
+            if (ctrl->lost) {
+                close_controller(i);
+                hotplug_request_scan();
+                continue;
+            }
+
+            uint64_t output = service_output(ctrl, now);
+            if (output < wake) {
+                wake = output;
+            }
+
+            // Turbo and macros move on the poll thread's clock, not the pad's
+            if (now >= ctrl->turbo_wake_us) {
+                publish_turbo_edge(i);
+                now = sceKernelGetProcessTime();
+            }
+            if (ctrl->turbo_wake_us < wake) {
+                wake = ctrl->turbo_wake_us;
+            }
+
+            if (ctrl->async) {
+                uint64_t next = service_async(ctrl, now);
+                if (next < wake) {
+                    wake = next;
+                }
+                async = 1;
+                continue;
+            }
+
+            if (now >= ctrl->schedule.next_poll_us) {
                 read_controller_input(i);
+                if (ctrl->slot.state != XBOX_STATE_CONNECTED) {
+                    continue;
+                }
+                now = sceKernelGetProcessTime();
+                poll_sched_update(&ctrl->schedule, now);
+            }
+
+            if (ctrl->schedule.next_poll_us < wake) {
+                wake = ctrl->schedule.next_poll_us;
             }
         }
 
-        // Sleep for poll interval
-        sceKernelUsleep(USB_POLL_INTERVAL_US);
+        now = sceKernelGetProcessTime();
+        uint32_t wait = (wake > now) ? (uint32_t)(wake - now) : 0;
+        if (async) {
+            // Returns at the first completion; handlers run right here
+            usb_async_handle_events(wait);
+        } else if (wait) {
+            sceKernelUsleep(wait);
+        }
     }
 
+    profile_offline();
     return NULL;
 }
 
@@ -252,33 +714,27 @@ int xbox_usb_init(void) {
         return 0;
     }
 
-    usb_notify("USB: Calling sceUsbdInit...");
+    notify_debug("USB: Calling sceUsbdInit...");
 
     // Initialize libusb via PS4 wrapper
     int32_t ret = sceUsbdInit();
     if (ret < 0) {
-        usb_notify("USB: sceUsbdInit failed");
+        notify_debug("USB: sceUsbdInit failed");
         return -1;
     }
 
-    usb_notify("USB: Init OK, setting up slots...");
+    notify_debug("USB: Init OK, setting up slots...");
 
     // Initialize controller slots
     for (int i = 0; i < MAX_XBOX_CONTROLLERS; i++) {
         memset(&g_controllers[i], 0, sizeof(InternalController));
         g_controllers[i].slot.state = XBOX_STATE_DISCONNECTED;
-        pthread_mutex_init(&g_controllers[i].mutex, NULL);
     }
 
-    usb_notify("USB: Slots OK, scanning...");
+    notify_debug("USB: Slots OK");
 
     g_initialized = 1;
 
-    // Do initial scan
-    scan_controllers();
-
-    usb_notify("USB: Scan complete");
-
     return 0;
 }
 
@@ -293,7 +749,6 @@ void xbox_usb_cleanup(void) {
     // Close all controllers
     for (int i = 0; i < MAX_XBOX_CONTROLLERS; i++) {
         close_controller(i);
-        pthread_mutex_destroy(&g_controllers[i].mutex);
     }
 
     // Cleanup libusb
@@ -307,11 +762,17 @@ int xbox_usb_start_polling(void) {
         return -1;
     }
 
+    // Detection runs on its own low-rate thread; first scan is immediate
+    if (hotplug_start(is_supported_controller) != 0) {
+        return -2;
+    }
+
     g_polling_active = 1;
 
     int ret = pthread_create(&g_poll_thread, NULL, poll_thread_func, NULL);
     if (ret != 0) {
         g_polling_active = 0;
+        hotplug_stop();
         return -2;
     }
 
@@ -325,6 +786,7 @@ void xbox_usb_stop_polling(void) {
 
     g_polling_active = 0;
     pthread_join(g_poll_thread, NULL);
+    hotplug_stop();
 }
 
 int xbox_usb_get_controller_count(void) {
@@ -344,22 +806,62 @@ int xbox_usb_is_connected(int index) {
     return g_controllers[index].slot.state == XBOX_STATE_CONNECTED;
 }
 
-int xbox_usb_read_report(int index, Xbox360Report* report) {
+int xbox_usb_read_report(int index, XboxRawReport* report) {
     if (index < 0 || index >= MAX_XBOX_CONTROLLERS || report == NULL) {
         return -1;
     }
 
+    PadSnapshot snapshot;
+    pad_slot_read(&g_controllers[index].published, &snapshot);
+    if (snapshot.update_time == 0) {
+        return -2;
+    }
+
+    *report = snapshot.report;
+    return 0;
+}
+
+int xbox_usb_read_state(int index, OrbisPadData* state) {
+    if (index < 0 || index >= MAX_XBOX_CONTROLLERS || state == NULL) {
+        return -1;
+    }
+
+    LatencyStamps stamps;
+
+    // Tell the poll scheduler when the game reads
+    poll_sched_note_read(&g_controllers[index].schedule, sceKernelGetProcessTime());
+
+    // Wait-free: never blocks on the poll thread, never sees a torn report
+    if (pad_slot_read_state(&g_controllers[index].published, state, &stamps) == 0) {
+        return -2;
+    }
+
+    latency_record_consume(index, &stamps);
+    return 0;
+}
+
+int xbox_usb_read_history(int index, OrbisPadData* states, int max) {
+    if (index < 0 || index >= MAX_XBOX_CONTROLLERS || states == NULL || max <= 0) {
+        return -1;
+    }
+
     InternalController* ctrl = &g_controllers[index];
+    LatencyStamps stamps;
 
+    poll_sched_note_read(&ctrl->schedule, sceKernelGetProcessTime());
+
+    // A disconnected pad has no history worth replaying
     if (ctrl->slot.state != XBOX_STATE_CONNECTED) {
         return -2;
     }
 
-    pthread_mutex_lock(&ctrl->mutex);
-    *report = ctrl->slot.last_report;
-    pthread_mutex_unlock(&ctrl->mutex);
+    int count = pad_history_read(&ctrl->history, states, max, &stamps);
+    if (count == 0) {
+        return -2;
+    }
 
-    return 0;
+    latency_record_consume(index, &stamps);
+    return count;
 }
 
 int xbox_usb_set_rumble(int index, uint8_t left_motor, uint8_t right_motor) {
@@ -368,26 +870,36 @@ int xbox_usb_set_rumble(int index, uint8_t left_motor, uint8_t right_motor) {
     }
 
     InternalController* ctrl = &g_controllers[index];
+    const ControllerDriver* driver = ctrl->driver;
 
-    if (ctrl->slot.state != XBOX_STATE_CONNECTED || ctrl->handle == NULL) {
+    if (ctrl->slot.state != XBOX_STATE_CONNECTED || driver == NULL) {
         return -2;
     }
 
-    // Prepare rumble output report
-    Xbox360OutputReport out;
-    xbox360_init_rumble(&out, left_motor, right_motor);
+    // Switch input-only pads have no motors
+    if (driver->rumble == NULL) {
+        return -3;
+    }
 
-    int32_t transferred = 0;
-    int32_t ret = sceUsbdInterruptTransfer(
-        ctrl->handle,
-        XBOX360_ENDPOINT_OUT,
-        (unsigned char*)&out,
-        sizeof(Xbox360OutputReport),
-        &transferred,
-        USB_TRANSFER_TIMEOUT_MS
-    );
+    // Newest value wins; the poll thread sends it
+    __atomic_store_n(&ctrl->rumble_request, ((uint32_t)left_motor << 8) | right_motor,
+                     __ATOMIC_RELAXED);
+    return 0;
+}
 
-    return (ret == 0) ? 0 : -3;
+int xbox_usb_get_poll_stats(int index, PollScheduleStats* stats) {
+    if (index < 0 || index >= MAX_XBOX_CONTROLLERS || stats == NULL) {
+        return -1;
+    }
+
+    InternalController* ctrl = &g_controllers[index];
+
+    poll_sched_get_stats(&ctrl->schedule, stats);
+    if (ctrl->async) {
+        stats->transfers_queued = (uint32_t)ctrl->input.in_flight;
+    }
+    stats->unchanged = ctrl->unchanged;
+    return 0;
 }
 
 const XboxControllerSlot* xbox_usb_get_slot(int index) {
@@ -398,5 +910,6 @@ const XboxControllerSlot* xbox_usb_get_slot(int index) {
 }
 
 void xbox_usb_rescan(void) {
-    scan_controllers();
+    // Re-report every present device; the poll thread skips open ones
+    hotplug_request_scan();
 }
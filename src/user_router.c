@@ -0,0 +1,309 @@
+/*
+ * User Routing Implementation
+ *
+ * The sceUserServiceGetEvent hook never waits: it pushes each login or
+ * logout into a single-producer / single-consumer ring (the game reads
+ * its event queue from one thread) and applies the ring itself only if
+ * g_router_lock is free. Otherwise the router thread is in the middle
+ * of a pass and the event waits for its next one, at most
+ * USER_ROUTER_INTERVAL_US. Readers only see the published table.
+ *
+ * The thread applies the difference between two successive login
+ * lists, not the list itself, so users an event already added or
+ * removed are left alone. A pass that raced an event is skipped and
+ * the next one compares against the older list again.
+ */
+
+#include "user_router.h"
+#include "latched_slot.h"
+#include <string.h>
+
+#include <orbis/libkernel.h>
+#include <orbis/UserService.h>
+
+#include <pthread.h>
+
+#define USER_EVENT_QUEUE_SIZE   16      // Event ring size (power of two)
+
+/*
+ * Latched table: readers use copies[sequence & 1]
+ */
+typedef struct {
+    volatile uint32_t sequence;
+    UserRoutes        copies[2];
+} RouteSlot;
+
+static RouteSlot    g_routes;
+
+// Writer state (g_router_lock)
+static pthread_mutex_t g_router_lock = PTHREAD_MUTEX_INITIALIZER;
+static int32_t      g_logins[ORBIS_USER_SERVICE_MAX_LOGIN_USERS];
+static int          g_login_count = 0;
+static UserRoutes   g_current;
+
+// Event ring: head written by the hook, tail by whoever holds g_router_lock
+static OrbisUserServiceEvent g_events[USER_EVENT_QUEUE_SIZE];
+static volatile uint32_t g_events_head = 0;
+static volatile uint32_t g_events_tail = 0;
+
+// Router thread state
+static OrbisUserServiceLoginUserIdList g_last_list;
+static pthread_t    g_router_thread;
+static volatile int g_router_running = 0;
+
+static void publish(const UserRoutes* routes) {
+    uint32_t seq = latched_write_begin(&g_routes.sequence);
+    g_routes.copies[0] = *routes;
+    latched_write_switch(&g_routes.sequence, seq);
+    g_routes.copies[1] = *routes;
+}
+
+void user_router_get(UserRoutes* routes) {
+    uint32_t seq;
+
+    do {
+        seq = latched_read_begin(&g_routes.sequence);
+        *routes = g_routes.copies[seq & 1];
+    } while (latched_read_retry(&g_routes.sequence, seq));
+}
+
+int user_router_lookup(int32_t user_id) {
+    UserRoutes routes;
+
+    user_router_get(&routes);
+    for (int i = 0; i < MAX_XBOX_CONTROLLERS; i++) {
+        if (routes.players[i] == user_id && user_id != 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// ============================================
+// Login state (g_router_lock held)
+// ============================================
+
+static int is_logged_in(int32_t user_id) {
+    for (int i = 0; i < g_login_count; i++) {
+        if (g_logins[i] == user_id) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void login(int32_t user_id) {
+    if (user_id <= 0 || is_logged_in(user_id) || g_login_count == ORBIS_USER_SERVICE_MAX_LOGIN_USERS) {
+        return;
+    }
+    g_logins[g_login_count++] = user_id;
+}
+
+static void logout(int32_t user_id) {
+    for (int i = 0; i < g_login_count; i++) {
+        if (g_logins[i] == user_id) {
+            // Keep login order: later users keep their relative priority
+            memmove(&g_logins[i], &g_logins[i + 1], sizeof(int32_t) * (size_t)(g_login_count - i - 1));
+            g_login_count--;
+            return;
+        }
+    }
+}
+
+/*
+ * Derive the table from the logins and publish it if it changed
+ * Players keep their slot while logged in and not foreground; new
+ * players take the lowest free slot, in login order.
+ */
+static void update_routes(int32_t foreground) {
+    UserRoutes next;
+
+    memset(&next, 0, sizeof(next));
+    next.foreground = foreground;
+
+    // Without a foreground user anyone could be player 1: route nobody
+    for (int i = 0; i < MAX_XBOX_CONTROLLERS && foreground != 0; i++) {
+        int32_t user = g_current.players[i];
+        if (user != 0 && user != foreground && is_logged_in(user)) {
+            next.players[i] = user;
+        }
+    }
+
+    for (int l = 0; l < g_login_count && foreground != 0; l++) {
+        int32_t user = g_logins[l];
+        int free_slot = -1;
+        int routed = (user == foreground);
+
+        for (int i = 0; i < MAX_XBOX_CONTROLLERS && !routed; i++) {
+            routed = (next.players[i] == user);
+            if (next.players[i] == 0 && free_slot < 0) {
+                free_slot = i;
+            }
+        }
+        if (!routed && free_slot >= 0) {
+            next.players[free_slot] = user;
+        }
+    }
+
+    if (memcmp(&next, &g_current, sizeof(next)) != 0) {
+        g_current = next;
+        publish(&g_current);
+    }
+}
+
+static int list_contains(const OrbisUserServiceLoginUserIdList* list, int32_t user_id) {
+    for (int i = 0; i < ORBIS_USER_SERVICE_MAX_LOGIN_USERS; i++) {
+        if (list->userId[i] == user_id) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Apply what changed from one login list to the next, in list order
+static void apply_list_change(const OrbisUserServiceLoginUserIdList* before,
+                              const OrbisUserServiceLoginUserIdList* after) {
+    for (int i = 0; i < ORBIS_USER_SERVICE_MAX_LOGIN_USERS; i++) {
+        int32_t user = before->userId[i];
+        if (user != ORBIS_USER_SERVICE_USER_ID_INVALID && !list_contains(after, user)) {
+            logout(user);
+        }
+    }
+    for (int i = 0; i < ORBIS_USER_SERVICE_MAX_LOGIN_USERS; i++) {
+        int32_t user = after->userId[i];
+        if (user != ORBIS_USER_SERVICE_USER_ID_INVALID && !list_contains(before, user)) {
+            login(user);
+        }
+    }
+}
+
+// ============================================
+// Event hook and router thread
+// ============================================
+
+static int queue_push(const OrbisUserServiceEvent* event) {
+    uint32_t head = __atomic_load_n(&g_events_head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&g_events_tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= USER_EVENT_QUEUE_SIZE) {
+        return -1;  // Full - the next login list catches up
+    }
+
+    g_events[head & (USER_EVENT_QUEUE_SIZE - 1)] = *event;
+    __atomic_store_n(&g_events_head, head + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+// Apply every queued event (g_router_lock held)
+static void drain_events(void) {
+    uint32_t tail = __atomic_load_n(&g_events_tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&g_events_head, __ATOMIC_ACQUIRE);
+
+    for (; tail != head; tail++) {
+        const OrbisUserServiceEvent* event = &g_events[tail & (USER_EVENT_QUEUE_SIZE - 1)];
+        if (event->eventType == ORBIS_USER_SERVICE_EVENT_TYPE_LOGIN) {
+            login(event->userId);
+        } else {
+            logout(event->userId);
+        }
+    }
+    __atomic_store_n(&g_events_tail, tail, __ATOMIC_RELEASE);
+}
+
+void user_router_event(const OrbisUserServiceEvent* event) {
+    if (!g_router_running ||
+        (event->eventType != ORBIS_USER_SERVICE_EVENT_TYPE_LOGIN &&
+         event->eventType != ORBIS_USER_SERVICE_EVENT_TYPE_LOGOUT)) {
+        return;
+    }
+    if (queue_push(event) != 0) {
+        return;
+    }
+
+    // Busy: the router thread drains the ring on its side
+    if (pthread_mutex_trylock(&g_router_lock) == 0) {
+        if (g_router_running) {
+            drain_events();
+            update_routes(g_current.foreground);
+        }
+        pthread_mutex_unlock(&g_router_lock);
+    }
+}
+
+static void* router_thread_func(void* arg) {
+    (void)arg;
+    OrbisUserServiceLoginUserIdList list;
+    int32_t foreground;
+
+    while (g_router_running) {
+        sceKernelUsleep(USER_ROUTER_INTERVAL_US);
+
+        // User service calls stay outside the lock: the hook never waits on them
+        uint32_t events = __atomic_load_n(&g_events_head, __ATOMIC_ACQUIRE);
+        int have_list = sceUserServiceGetLoginUserIdList(&list) == 0;
+        int have_foreground = sceUserServiceGetForegroundUser(&foreground) == 0;
+
+        pthread_mutex_lock(&g_router_lock);
+        drain_events();
+        if (have_list && events == __atomic_load_n(&g_events_tail, __ATOMIC_RELAXED)) {
+            apply_list_change(&g_last_list, &list);
+            g_last_list = list;
+        }
+        update_routes(have_foreground ? foreground : g_current.foreground);
+        pthread_mutex_unlock(&g_router_lock);
+    }
+    return NULL;
+}
+
+int user_router_start(void) {
+    if (g_router_running) {
+        return -1;
+    }
+
+    // Later lists and events only report changes: start from the current logins
+    OrbisUserServiceLoginUserIdList empty;
+    for (int i = 0; i < ORBIS_USER_SERVICE_MAX_LOGIN_USERS; i++) {
+        empty.userId[i] = ORBIS_USER_SERVICE_USER_ID_INVALID;
+    }
+    g_last_list = empty;
+    if (sceUserServiceGetLoginUserIdList(&g_last_list) != 0) {
+        g_last_list = empty;
+    }
+
+    int32_t foreground = 0;
+    sceUserServiceGetForegroundUser(&foreground);
+
+    pthread_mutex_lock(&g_router_lock);
+    g_login_count = 0;
+    memset(&g_current, 0, sizeof(g_current));
+    __atomic_store_n(&g_events_tail, g_events_head, __ATOMIC_RELEASE);
+    apply_list_change(&empty, &g_last_list);
+    update_routes(foreground);
+    g_router_running = 1;
+    pthread_mutex_unlock(&g_router_lock);
+
+    if (pthread_create(&g_router_thread, NULL, router_thread_func, NULL) != 0) {
+        pthread_mutex_lock(&g_router_lock);
+        g_router_running = 0;
+        pthread_mutex_unlock(&g_router_lock);
+        return -2;
+    }
+    return 0;
+}
+
+void user_router_stop(void) {
+    if (!g_router_running) {
+        return;
+    }
+
+    // Under the lock: an event hook still running sees the router stopped
+    pthread_mutex_lock(&g_router_lock);
+    g_router_running = 0;
+    pthread_mutex_unlock(&g_router_lock);
+    pthread_join(g_router_thread, NULL);
+
+    pthread_mutex_lock(&g_router_lock);
+    memset(&g_current, 0, sizeof(g_current));
+    publish(&g_current);
+    pthread_mutex_unlock(&g_router_lock);
+}